@@ -24,7 +24,7 @@ $compiler_min_version = '4.8.1'
 $object_folder = 'random_walks_emulator_obj'
 $out_folder = "Random Walks Emulator (build, v.$version)"
 $out_file = 'rwe.exe'
-$units = @('metric_graph', 'rw_space', 'ui', 'main')
+$units = @('mapped_file', 'rweg', 'rwegz', 'text_parser', 'metric_graph', 'compiled_graph', 'partition', 'symmetry', 'reduction', 'planner', 'rw_space', 'ui', 'main')
 
 
 
@@ -293,11 +293,16 @@ Write-Host '4. Finalisation... ' -NoNewLine
 (Copy-Item -Force -Path _util\gs3 -Destination "$out_folder\My graphs\Star3.rweg") *> $NULL
 (Copy-Item -Force -Path _util\ss1 -Destination "$out_folder\My scenarios\Basic.rwes") *> $NULL
 (Copy-Item -Force -Path _util\tfrm -Destination "$out_folder\Technical files\ReadMe.txt") *> $NULL
+(Copy-Item -Force -Path _util\cmdetr -Destination "$out_folder\Technical files\cmdetr") *> $NULL
 (Copy-Item -Force -Path _util\cmdgc -Destination "$out_folder\Technical files\cmdgc") *> $NULL
 (Copy-Item -Force -Path _util\cmdgtr -Destination "$out_folder\Technical files\cmdgtr") *> $NULL
 (Copy-Item -Force -Path _util\cmdh -Destination "$out_folder\Technical files\cmdh") *> $NULL
+(Copy-Item -Force -Path _util\cmdmetr -Destination "$out_folder\Technical files\cmdmetr") *> $NULL
+(Copy-Item -Force -Path _util\cmdmtr -Destination "$out_folder\Technical files\cmdmtr") *> $NULL
 (Copy-Item -Force -Path _util\cmdr -Destination "$out_folder\Technical files\cmdr") *> $NULL
 (Copy-Item -Force -Path _util\cmdrtg -Destination "$out_folder\Technical files\cmdrtg") *> $NULL
+(Copy-Item -Force -Path _util\cmdrtrz -Destination "$out_folder\Technical files\cmdrtrz") *> $NULL
+(Copy-Item -Force -Path _util\cmdrztr -Destination "$out_folder\Technical files\cmdrztr") *> $NULL
 (Copy-Item -Force -Path _util\cmdsc -Destination "$out_folder\Technical files\cmdsc") *> $NULL
 Write-Host '(success)'
 
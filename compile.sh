@@ -25,7 +25,7 @@ compiler_min_version='4.8.1'
 object_folder='random_walks_emulator_obj'
 out_folder="Random Walks Emulator (build, v.$version)"
 out_file='rwe'
-units=('metric_graph' 'rw_space' 'ui' 'main')
+units=('mapped_file' 'rweg' 'rwegz' 'text_parser' 'metric_graph' 'compiled_graph' 'partition' 'symmetry' 'reduction' 'planner' 'rw_space' 'ui' 'main')
 
 
 
@@ -277,11 +277,16 @@ cp _util/gs2 "$out_folder/My graphs/Star2.rweg"
 cp _util/gs3 "$out_folder/My graphs/Star3.rweg"
 cp _util/ss1 "$out_folder/My scenarios/Basic.rwes"
 cp _util/tfrm "$out_folder/Technical files/ReadMe.txt"
+cp _util/cmdetr "$out_folder/Technical files/cmdetr"
 cp _util/cmdgc "$out_folder/Technical files/cmdgc"
 cp _util/cmdgtr "$out_folder/Technical files/cmdgtr"
 cp _util/cmdh "$out_folder/Technical files/cmdh"
+cp _util/cmdmetr "$out_folder/Technical files/cmdmetr"
+cp _util/cmdmtr "$out_folder/Technical files/cmdmtr"
 cp _util/cmdr "$out_folder/Technical files/cmdr"
 cp _util/cmdrtg "$out_folder/Technical files/cmdrtg"
+cp _util/cmdrtrz "$out_folder/Technical files/cmdrtrz"
+cp _util/cmdrztr "$out_folder/Technical files/cmdrztr"
 cp _util/cmdsc "$out_folder/Technical files/cmdsc"
 echo '(success)'
 
@@ -0,0 +1,354 @@
+/**
+ * \file
+ *       compiled_graph.cpp
+ *
+ * \author
+ *       Andrei Eliseev (JointPoints), 2021
+ */
+#include "compiled_graph.hpp"
+
+#include <algorithm>    // needed for "lower_bound", "sort", "stable_sort", "reverse", "min"
+#include <utility>      // needed for "pair"
+#include <queue>        // needed for "priority_queue"
+#include <limits>       // needed for "numeric_limits"
+
+
+
+
+
+// Constructors and destructors
+
+
+
+
+
+template <typename Real>
+rwe::CompiledGraph<Real>::CompiledGraph(void) :
+	vertex_order(id_order), vertex_ids(), sorted_ids(), sorted_indices(), edge_indices(), offsets(1, 0), targets(), lengths(), directions(), departure_offsets(1, 0), departures()
+{
+	// Intended to be empty
+}
+
+
+
+template <typename Real>
+rwe::CompiledGraph<Real>::CompiledGraph(MetricGraph<Real> const &graph, VertexOrder const vertex_order, uint32_t const root_vertex) :
+	vertex_order(vertex_order), vertex_ids(), sorted_ids(graph.getVertexList()), sorted_indices(graph.edges.size()), edge_indices(graph.getEdgeCount()), offsets(), targets(), lengths(), directions(), departure_offsets(), departures()
+{
+	std::vector<uint32_t> const                         order               = CompiledGraph<Real>::orderVertices(graph, vertex_order, root_vertex);
+	std::vector<uint32_t> const                         sorted_positions    = graph.getSortedIndices();
+	std::vector<uint32_t>                               compiled_indices(graph.edges.size());
+	std::vector<std::pair<uint32_t, uint64_t>>          row;
+	uint64_t const                                      edge_count          = graph.getEdgeCount();
+
+	// 1. Renumber the vertices (<compiled_indices> is indexed by dense indices of MetricGraph, <sorted_indices> by
+	//    positions in the ascending order of IDs)
+	this->vertex_ids.reserve(order.size());
+	for (uint32_t vertex_1 = 0; vertex_1 < order.size(); ++vertex_1)
+	{
+		this->vertex_ids.push_back(graph.edges[order[vertex_1]].id);
+		compiled_indices[order[vertex_1]] = vertex_1;
+	}
+	for (uint32_t vertex_1 = 0; vertex_1 < sorted_positions.size(); ++vertex_1)
+		this->sorted_indices[vertex_1] = compiled_indices[sorted_positions[vertex_1]];
+
+	// 2. Lay the edges out row by row, each row is sorted by dense indices of targets; remember where each
+	//    edge of MetricGraph goes
+	this->offsets.reserve(this->vertex_ids.size() + 1);
+	this->targets.reserve(edge_count);
+	this->lengths.reserve(edge_count);
+	this->directions.assign((edge_count + 63) / 64, 0);
+	this->offsets.push_back(0);
+	for (uint32_t vertex_1 = 0; vertex_1 < order.size(); ++vertex_1)
+	{
+		typename MetricGraph<Real>::VertexView const &curr_vertex = graph.edges[order[vertex_1]];
+
+		row.clear();
+		for (uint32_t vertex_2 = 0; vertex_2 < curr_vertex.out_edges.size(); ++vertex_2)
+			row.emplace_back(compiled_indices[graph.vertex_index.at(graph.edge_columns.targets[curr_vertex.out_edges[vertex_2]])], curr_vertex.out_edges[vertex_2]);
+		if (vertex_order != id_order)
+			std::sort(row.begin(), row.end());
+		for (uint32_t row_i = 0; row_i < row.size(); ++row_i)
+		{
+			if (graph.isDirected(row[row_i].second))
+				this->directions[this->targets.size() / 64] |= uint64_t(1) << (this->targets.size() % 64);
+			this->edge_indices[row[row_i].second] = this->targets.size();
+			this->targets.push_back(row[row_i].first);
+			this->lengths.push_back(graph.edge_columns.lengths[row[row_i].second]);
+		}
+		this->offsets.push_back(this->targets.size());
+	}
+
+	// 3. Count departures of each vertex: every edge departs from its source, undirected edges
+	//    also depart from their targets
+	std::vector<uint64_t> departure_cursors(this->vertex_ids.size(), 0);
+
+	this->departure_offsets.assign(this->vertex_ids.size() + 1, 0);
+	for (uint32_t vertex_1 = 0; vertex_1 < this->vertex_ids.size(); ++vertex_1)
+		for (uint64_t edge_i = this->offsets[vertex_1]; edge_i < this->offsets[vertex_1 + 1]; ++edge_i)
+		{
+			++this->departure_offsets[vertex_1 + 1];
+			if ((!this->isDirected(edge_i)) && (this->targets[edge_i] != vertex_1))
+				++this->departure_offsets[this->targets[edge_i] + 1];
+		}
+	for (uint32_t vertex_1 = 0; vertex_1 < this->vertex_ids.size(); ++vertex_1)
+	{
+		this->departure_offsets[vertex_1 + 1] += this->departure_offsets[vertex_1];
+		departure_cursors[vertex_1] = this->departure_offsets[vertex_1];
+	}
+
+	// 4. Fill the departure table; departures of each vertex are listed in the ascending order
+	//    of dense indices of the vertices the edges are stored under
+	this->departures.resize(this->departure_offsets.back());
+	for (uint32_t vertex_1 = 0; vertex_1 < this->vertex_ids.size(); ++vertex_1)
+		for (uint64_t edge_i = this->offsets[vertex_1]; edge_i < this->offsets[vertex_1 + 1]; ++edge_i)
+		{
+			this->departures[departure_cursors[vertex_1]++] = Departure{edge_i, Real(0), true};
+			if ((!this->isDirected(edge_i)) && (this->targets[edge_i] != vertex_1))
+				this->departures[departure_cursors[this->targets[edge_i]]++] = Departure{edge_i, this->lengths[edge_i], false};
+		}
+}
+
+
+
+
+
+// Access
+
+
+
+
+
+template <typename Real>
+uint32_t const rwe::CompiledGraph<Real>::getVertexCount(void) const
+{
+	return this->vertex_ids.size();
+}
+
+
+
+template <typename Real>
+uint64_t const rwe::CompiledGraph<Real>::getEdgeCount(void) const
+{
+	return this->targets.size();
+}
+
+
+
+template <typename Real>
+uint32_t const rwe::CompiledGraph<Real>::getVertexIndex(uint32_t const vertex) const
+{
+	auto vertex_lower_bound = std::lower_bound(this->sorted_ids.begin(), this->sorted_ids.end(), vertex);
+
+	if ((vertex_lower_bound != this->sorted_ids.end()) && (*vertex_lower_bound == vertex))
+		return this->sorted_indices[std::distance(this->sorted_ids.begin(), vertex_lower_bound)];
+
+	return this->vertex_ids.size();
+}
+
+
+
+template <typename Real>
+uint32_t const rwe::CompiledGraph<Real>::getVertexID(uint32_t const vertex_index) const
+{
+	return this->vertex_ids[vertex_index];
+}
+
+
+
+template <typename Real>
+rwe::VertexOrder const rwe::CompiledGraph<Real>::getVertexOrder(void) const
+{
+	return this->vertex_order;
+}
+
+
+
+template <typename Real>
+uint32_t const rwe::CompiledGraph<Real>::getRootVertex(void) const
+{
+	return this->vertex_ids[0];
+}
+
+
+
+template <typename Real>
+std::vector<long double> const rwe::CompiledGraph<Real>::getArrivalTimes(uint32_t const vertex_index) const
+{
+	using Arrival = std::pair<long double, uint32_t>;
+
+	std::vector<long double>                                                vertex_arrivals(this->vertex_ids.size(), std::numeric_limits<long double>::infinity());
+	std::vector<long double>                                                edge_arrivals(this->targets.size(), std::numeric_limits<long double>::infinity());
+	std::vector<uint32_t>                                                   sources(this->targets.size());
+	std::priority_queue<Arrival, std::vector<Arrival>, std::greater<Arrival>>   arrivals;
+
+	// 1. Remember the vertex each edge is stored under, agents moving along undirected edges backwards arrive there
+	for (uint32_t vertex_1 = 0; vertex_1 < this->vertex_ids.size(); ++vertex_1)
+		for (uint64_t edge_i = this->offsets[vertex_1]; edge_i < this->offsets[vertex_1 + 1]; ++edge_i)
+			sources[edge_i] = vertex_1;
+
+	// 2. Run Dijkstra's algorithm, each departure of a reached vertex is entered at the moment the vertex is reached
+	vertex_arrivals[vertex_index] = 0.0L;
+	arrivals.emplace(0.0L, vertex_index);
+	while (!arrivals.empty())
+	{
+		Arrival const curr_arrival = arrivals.top();
+
+		arrivals.pop();
+		if (curr_arrival.first > vertex_arrivals[curr_arrival.second])
+			continue;
+		for (uint64_t departure_i = this->departure_offsets[curr_arrival.second]; departure_i < this->departure_offsets[curr_arrival.second + 1]; ++departure_i)
+		{
+			Departure const    &curr_departure  = this->departures[departure_i];
+			uint32_t const      next_vertex     = (curr_departure.direction) ? (this->targets[curr_departure.edge]) : (sources[curr_departure.edge]);
+			long double const   next_arrival    = curr_arrival.first + this->lengths[curr_departure.edge];
+
+			edge_arrivals[curr_departure.edge] = std::min(edge_arrivals[curr_departure.edge], curr_arrival.first);
+			if (next_arrival < vertex_arrivals[next_vertex])
+			{
+				vertex_arrivals[next_vertex] = next_arrival;
+				arrivals.emplace(next_arrival, next_vertex);
+			}
+		}
+	}
+
+	return edge_arrivals;
+}
+
+
+
+template <typename Real>
+rwe::MemoryUsage const rwe::CompiledGraph<Real>::getMemoryUsage(void) const
+{
+	uint64_t const  index_bytes     = (this->vertex_ids.capacity() + this->sorted_ids.capacity() + this->sorted_indices.capacity()) * sizeof(uint32_t) + this->edge_indices.capacity() * sizeof(uint64_t);
+
+	return MemoryUsage
+	{
+		{"vertex indices",      index_bytes,                                                                                                    index_bytes},
+		{"offsets",             this->offsets.capacity() * sizeof(uint64_t),                                                                   this->offsets.capacity() * sizeof(uint64_t)},
+		{"targets",             this->targets.capacity() * sizeof(uint32_t),                                                                   this->targets.capacity() * sizeof(uint32_t)},
+		{"lengths",             this->lengths.capacity() * sizeof(Real),                                                                       this->lengths.capacity() * sizeof(Real)},
+		{"directions",          this->directions.capacity() * sizeof(uint64_t),                                                                this->directions.capacity() * sizeof(uint64_t)},
+		{"departure table",     this->departure_offsets.capacity() * sizeof(uint64_t) + this->departures.capacity() * sizeof(Departure),      this->departure_offsets.capacity() * sizeof(uint64_t) + this->departures.capacity() * sizeof(Departure)}
+	};
+}
+
+
+
+template <typename Real>
+bool const rwe::CompiledGraph<Real>::isDirected(uint64_t const edge) const
+{
+	return (this->directions[edge / 64] >> (edge % 64)) & 1;
+}
+
+
+
+
+
+// Modifiers
+
+
+
+
+
+template <typename Real>
+void rwe::CompiledGraph<Real>::updateLength(uint64_t const graph_edge, Real const length)
+{
+	uint64_t const edge = this->edge_indices[graph_edge];
+
+	// 1. Update the length itself
+	this->lengths[edge] = length;
+
+	// 2. Undirected edges depart from their targets at the far end, so these departures move as well
+	for (uint64_t departure_i = this->departure_offsets[this->targets[edge]]; departure_i < this->departure_offsets[this->targets[edge] + 1]; ++departure_i)
+		if ((this->departures[departure_i].edge == edge) && (!this->departures[departure_i].direction))
+			this->departures[departure_i].position = length;
+
+	return;
+}
+
+
+
+
+
+// Reordering
+
+
+
+
+
+template <typename Real>
+std::vector<uint32_t> rwe::CompiledGraph<Real>::orderVertices(MetricGraph<Real> const &graph, VertexOrder const vertex_order, uint32_t const root_vertex)
+{
+	uint32_t const          vertex_count    = graph.edges.size();
+	auto const              root_i          = graph.vertex_index.find(root_vertex);
+	auto const              degree          = [&graph](uint32_t const vertex){return graph.edges[vertex].out_edges.size() + graph.edges[vertex].in_edges.size();};
+	auto const              degree_less     = [&degree](uint32_t const vertex_1, uint32_t const vertex_2){return degree(vertex_1) < degree(vertex_2);};
+	auto const              id_less         = [&graph](uint32_t const vertex_1, uint32_t const vertex_2){return graph.edges[vertex_1].id < graph.edges[vertex_2].id;};
+	std::vector<uint32_t>   answer;
+	std::vector<uint32_t>   seeds           = graph.getSortedIndices();
+	std::vector<uint32_t>   neighbours;
+	std::vector<bool>       is_visited(vertex_count, false);
+
+	// 1. Seeds follow the ascending order of IDs
+	if (vertex_order == id_order)
+		return seeds;
+
+	// 2. Choose the vertices to start the search in each connected component from
+	if ((vertex_order == bfs_order) && (root_i != graph.vertex_index.end()))
+		seeds.insert(seeds.begin(), root_i->second);
+	if (vertex_order == rcm_order)
+		std::stable_sort(seeds.begin(), seeds.end(), degree_less);
+
+	// 3. Run the breadth-first search, the answer itself serves as a queue
+	answer.reserve(vertex_count);
+	for (uint32_t seed_i = 0; seed_i < seeds.size(); ++seed_i)
+	{
+		if (is_visited[seeds[seed_i]])
+			continue;
+		is_visited[seeds[seed_i]] = true;
+		answer.push_back(seeds[seed_i]);
+		for (uint32_t head = answer.size() - 1; head < answer.size(); ++head)
+		{
+			typename MetricGraph<Real>::VertexView const &curr_vertex = graph.edges[answer[head]];
+
+			// 3.1. Directions are ignored, so both outgoing and incoming edges are followed
+			neighbours.clear();
+			for (uint32_t vertex_2 = 0; vertex_2 < curr_vertex.out_edges.size() + curr_vertex.in_edges.size(); ++vertex_2)
+			{
+				uint32_t const neighbour = graph.vertex_index.at((vertex_2 < curr_vertex.out_edges.size()) ? (graph.edge_columns.targets[curr_vertex.out_edges[vertex_2]]) : (graph.edge_columns.sources[curr_vertex.in_edges[vertex_2 - curr_vertex.out_edges.size()]]));
+				if (!is_visited[neighbour])
+				{
+					is_visited[neighbour] = true;
+					neighbours.push_back(neighbour);
+				}
+			}
+
+			// 3.2. Cuthill-McKee visits neighbours with lower degrees first
+			std::sort(neighbours.begin(), neighbours.end(), id_less);
+			if (vertex_order == rcm_order)
+				std::stable_sort(neighbours.begin(), neighbours.end(), degree_less);
+			answer.insert(answer.end(), neighbours.begin(), neighbours.end());
+		}
+	}
+
+	// 4. Reverse the Cuthill-McKee order
+	if (vertex_order == rcm_order)
+		std::reverse(answer.begin(), answer.end());
+
+	return answer;
+}
+
+
+
+
+
+// Explicit instantiations
+
+
+
+
+
+template class rwe::CompiledGraph<float>;
+template class rwe::CompiledGraph<double>;
+template class rwe::CompiledGraph<long double>;
@@ -0,0 +1,241 @@
+/**
+ * \file
+ *       compiled_graph.hpp
+ *
+ * \author
+ *       Andrei Eliseev (JointPoints), 2021
+ */
+#ifndef RWE__COMPILED_GRAPH_HPP__
+#define RWE__COMPILED_GRAPH_HPP__
+
+
+
+
+
+#include "../metric_graph/metric_graph.hpp"     // needed for "MetricGraph"
+#include <vector>                               // needed for "vector"
+#include <cstdint>                              // needed for "int*_t" and "uint*_t" types
+
+
+
+
+
+namespace rwe
+{
+
+
+
+
+
+	// Forward declaration of GraphPartition class
+	template <typename Real> class GraphPartition;
+
+
+
+
+
+	/**
+	 * \brief Order of dense indices
+	 *
+	 * * \c id_order : dense indices follow the ascending order of vertex IDs;
+	 * * \c bfs_order : dense indices follow the breadth-first search order starting at the
+	 * root vertex, so that vertices close to the root (and edges between them) are placed
+	 * next to each other in memory;
+	 * * \c rcm_order : dense indices follow the reverse Cuthill-McKee order which keeps
+	 * adjacent vertices close to each other regardless of the root vertex.
+	 *
+	 * Directions of edges are ignored when reordering. Vertex IDs are never changed, so
+	 * CompiledGraph::getVertexID and CompiledGraph::getVertexIndex map between both
+	 * numberings for any order.
+	 */
+	using VertexOrder       = enum VertexOrderEnum {id_order, bfs_order, rcm_order};
+
+
+
+
+
+	/**
+	 * \class CompiledGraph
+	 * \brief A read-only snapshot of a metric graph
+	 *
+	 * Compiled graph is a compact representation of a MetricGraph object which is used by
+	 * emulators in their hot loops. All vertices of the original graph are renumbered with
+	 * <b>dense indices</b> \f$0,1,...,|V|-1\f$ in the order chosen at compilation (see
+	 * rwe::VertexOrder), and all edges are stored in the CSR (compressed sparse row) form:
+	 *
+	 * * one array of offsets, such that edges stored under the vertex with dense index
+	 * \f$i\f$ occupy positions from <tt>offsets[i]</tt> to <tt>offsets[i + 1] - 1</tt>;
+	 * * one contiguous array of dense indices of target vertices;
+	 * * one contiguous array of lengths;
+	 * * one bitmap of directions.
+	 *
+	 * Position of an edge in these arrays is called an <b>edge index</b>. Edge indices are 64-bit,
+	 * so the number of edges is only limited by the available memory, while dense indices of
+	 * vertices are 32-bit. Each edge is stored
+	 * under the same vertex as in the original MetricGraph object, i.e., directed edges
+	 * \f$v \rightarrow w\f$ are stored under \f$v\f$ and undirected edges \f$v-w\f$ are stored
+	 * under \f$\min\{v,w\}\f$. Edges of each row are sorted by dense indices of their targets.
+	 *
+	 * Additionally, a <b>departure table</b> is precomputed for each vertex. It lists all edges
+	 * an agent instance may depart along after hitting this vertex, together with the direction
+	 * of movement along each of them and the position at which movement begins. The table is
+	 * stored in the same CSR form, so that emulators iterate over it without any allocations.
+	 *
+	 * \note Compiled graph does not track changes of the original MetricGraph object. It has
+	 * to be compiled again each time edges of the original graph are added or change their
+	 * directions; changes of lengths alone may be patched in place by RWSpace.
+	 * 
+	 * \tparam  Real    Type of lengths and positions, the same as the one of the original graph.
+	 */
+	template <typename Real>
+	class CompiledGraph
+	{
+
+
+
+	public:
+
+
+
+		/// \name Constructors and destructors
+		///@{
+
+		/**
+		 * Default constructor
+		 *
+		 * Constructs an empty compiled graph.
+		 */
+		CompiledGraph               (void);
+
+		/**
+		 * Compiling constructor
+		 *
+		 * Constructs a read-only snapshot of the specified metric graph.
+		 *
+		 * \param   graph           A metric graph to compile.
+		 * \param   vertex_order    Order of dense indices.
+		 * \param   root_vertex     ID of the vertex to start \c bfs_order from; ignored for other
+		 *                          orders. If the vertex is absent, the lowest ID is used.
+		 */
+		explicit CompiledGraph      (MetricGraph<Real> const &graph, VertexOrder const vertex_order = id_order, uint32_t const root_vertex = 0);
+
+		///@}
+
+
+
+		/// \name Accessors
+		///@{
+
+		/**
+		 * Get the number of vertices
+		 *
+		 * \return \f$|V|\f$.
+		 */
+		uint32_t const      getVertexCount      (void)                          const;
+
+		/**
+		 * Get the number of edges
+		 *
+		 * \return \f$|E|\f$ (an undirected edge is counted once).
+		 */
+		uint64_t const      getEdgeCount        (void)                          const;
+
+		/**
+		 * Get dense index of a vertex
+		 *
+		 * \param   vertex  Vertex ID.
+		 *
+		 * \return
+		 * * Dense index of the vertex, if it is present in the graph;
+		 * * Number of vertices in the graph, otherwise.
+		 */
+		uint32_t const      getVertexIndex      (uint32_t const vertex)         const;
+
+		/**
+		 * Get ID of a vertex
+		 *
+		 * \param   vertex_index    Dense index of the vertex.
+		 *
+		 * \return Vertex ID.
+		 */
+		uint32_t const      getVertexID         (uint32_t const vertex_index)   const;
+
+		/**
+		 * Get order of dense indices
+		 *
+		 * \return Order the graph was compiled with.
+		 */
+		VertexOrder const   getVertexOrder      (void)                          const;
+
+		/**
+		 * Get root vertex
+		 *
+		 * \return ID of the vertex \c bfs_order started from, if the graph was compiled with
+		 * \c bfs_order and is not empty; undefined otherwise.
+		 */
+		uint32_t const      getRootVertex       (void)                          const;
+
+		/**
+		 * Get first arrival times
+		 *
+		 * Finds the earliest moment at which an agent instance spawned at the specified vertex
+		 * at the zero moment may enter each edge, i.e., the length of the shortest path (with
+		 * respect to directions of edges) from this vertex to the nearest end point the edge
+		 * departs from. Runs Dijkstra's algorithm over the departure table, which takes
+		 * \f$O(|E| \log |V|)\f$ time.
+		 *
+		 * \param   vertex_index    Dense index of the vertex.
+		 *
+		 * \return \c std::vector of first arrival times indexed by edge indices; positive
+		 * infinity for edges no agent instance can ever enter.
+		 */
+		std::vector<long double> const  getArrivalTimes (uint32_t const vertex_index)   const;
+
+		/**
+		 * Get memory footprint
+		 *
+		 * \return Memory footprint of the compiled graph broken down by its arrays; the compiled
+		 * graph is read-only, so peaks equal current values.
+		 */
+		MemoryUsage const               getMemoryUsage  (void)                          const;
+
+		///@}
+	private:
+		friend class RWSpace<Real>;
+		friend class GraphPartition<Real>;
+
+		using Departure         = struct {uint64_t edge; Real position; bool direction;};
+
+		VertexOrder                 vertex_order;
+		std::vector<uint32_t>       vertex_ids;
+		std::vector<uint32_t>       sorted_ids;
+		std::vector<uint32_t>       sorted_indices;
+		std::vector<uint64_t>       edge_indices;
+		std::vector<uint64_t>       offsets;
+		std::vector<uint32_t>       targets;
+		std::vector<Real>           lengths;
+		std::vector<uint64_t>       directions;
+		std::vector<uint64_t>       departure_offsets;
+		std::vector<Departure>      departures;
+
+		// Access
+		bool const          isDirected          (uint64_t const edge)           const;
+
+		// Modifiers
+		void                updateLength        (uint64_t const graph_edge, Real const length);
+
+		// Reordering
+		static std::vector<uint32_t> orderVertices(MetricGraph<Real> const &graph, VertexOrder const vertex_order, uint32_t const root_vertex);
+	};
+
+
+
+
+
+} // rwe
+
+
+
+
+
+#endif // RWE__COMPILED_GRAPH_HPP__
@@ -0,0 +1,182 @@
+/**
+ * \file
+ *       mapped_file.cpp
+ *
+ * \author
+ *       Andrei Eliseev (JointPoints), 2021
+ */
+#include "mapped_file.hpp"
+
+#ifdef _WIN32
+#include <windows.h>    // needed for "CreateFileA", "CreateFileMappingA", "MapViewOfFile", "UnmapViewOfFile"
+#else
+#include <fcntl.h>      // needed for "open"
+#include <sys/mman.h>   // needed for "mmap", "munmap", "madvise"
+#include <sys/stat.h>   // needed for "fstat"
+#include <unistd.h>     // needed for "close"
+#endif
+
+
+
+
+
+// Constructors and destructors
+
+
+
+
+
+rwe::MappedFile::MappedFile(void) :
+	data(nullptr), size(0)
+{
+	// Intended to be empty
+}
+
+
+
+rwe::MappedFile::MappedFile(std::string const file_name) :
+	data(nullptr), size(0)
+{
+#ifdef _WIN32
+	HANDLE          file_handle     = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	HANDLE          mapping_handle  = NULL;
+	LARGE_INTEGER   file_size;
+
+	// 1. Open the file and find out its size
+	if (file_handle == INVALID_HANDLE_VALUE)
+		return;
+	if ((!GetFileSizeEx(file_handle, &file_size)) || (file_size.QuadPart <= 0))
+	{
+		CloseHandle(file_handle);
+		return;
+	}
+
+	// 2. Map the whole file; the view stays valid after both handles are closed
+	mapping_handle = CreateFileMappingA(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping_handle != NULL)
+	{
+		this->data = static_cast<char const *>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+		this->size = (this->data != nullptr) ? (file_size.QuadPart) : (0);
+		CloseHandle(mapping_handle);
+	}
+	CloseHandle(file_handle);
+#else
+	int             file_descriptor = ::open(file_name.c_str(), O_RDONLY);
+	struct stat     file_status;
+	void           *mapping         = MAP_FAILED;
+
+	// 1. Open the file and find out its size
+	if (file_descriptor < 0)
+		return;
+	if ((fstat(file_descriptor, &file_status) != 0) || (file_status.st_size <= 0))
+	{
+		::close(file_descriptor);
+		return;
+	}
+
+	// 2. Map the whole file; the mapping stays valid after the descriptor is closed
+	mapping = mmap(nullptr, file_status.st_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+	if (mapping != MAP_FAILED)
+	{
+		madvise(mapping, file_status.st_size, MADV_SEQUENTIAL);
+		this->data = static_cast<char const *>(mapping);
+		this->size = file_status.st_size;
+	}
+	::close(file_descriptor);
+#endif
+}
+
+
+
+rwe::MappedFile::MappedFile(MappedFile &&other) :
+	data(other.data), size(other.size)
+{
+	other.data = nullptr;
+	other.size = 0;
+}
+
+
+
+rwe::MappedFile::~MappedFile(void)
+{
+	this->close();
+}
+
+
+
+
+
+// Operators
+
+
+
+
+
+rwe::MappedFile & rwe::MappedFile::operator=(MappedFile &&other)
+{
+	if (this != &other)
+	{
+		this->close();
+		this->data = other.data;
+		this->size = other.size;
+		other.data = nullptr;
+		other.size = 0;
+	}
+
+	return *this;
+}
+
+
+
+
+
+// Access
+
+
+
+
+
+bool const rwe::MappedFile::isOpen(void) const
+{
+	return this->data != nullptr;
+}
+
+
+
+char const * rwe::MappedFile::getData(void) const
+{
+	return this->data;
+}
+
+
+
+uint64_t const rwe::MappedFile::getSize(void) const
+{
+	return this->size;
+}
+
+
+
+
+
+// Modifiers
+
+
+
+
+
+void rwe::MappedFile::close(void)
+{
+	if (this->data != nullptr)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(this->data);
+#else
+		munmap(const_cast<char *>(this->data), this->size);
+#endif
+	}
+	this->data = nullptr;
+	this->size = 0;
+
+	return;
+}
@@ -0,0 +1,169 @@
+/**
+ * \file
+ *       mapped_file.hpp
+ *
+ * \author
+ *       Andrei Eliseev (JointPoints), 2021
+ */
+#ifndef RWE__MAPPED_FILE_HPP__
+#define RWE__MAPPED_FILE_HPP__
+
+
+
+
+
+#include <string>       // needed for "string"
+#include <cstdint>      // needed for "int*_t" and "uint*_t" types
+
+
+
+
+
+namespace rwe
+{
+
+
+
+
+
+	/**
+	 * \class MappedFile
+	 * \brief A read-only memory mapping of a file
+	 *
+	 * Mapped file makes contents of a file directly addressable without reading them into
+	 * buffers: pages are brought into memory by the operating system on first access and are
+	 * shared with its file cache, so that loaders may parse multi-gigabyte files with no
+	 * system calls per record and no copies. The mapping is released once the object is
+	 * destroyed, which invalidates all pointers obtained from it.
+	 *
+	 * The beginning of the mapping is aligned to the page boundary, so any offset within the
+	 * file which is a multiple of 64 is suitably aligned for all fundamental types.
+	 *
+	 * \note Both POSIX (\c mmap) and Windows (\c MapViewOfFile) mappings are supported.
+	 */
+	class MappedFile
+	{
+
+
+
+	public:
+
+
+
+		/// \name Constructors and destructors
+		///@{
+
+		/**
+		 * Default constructor
+		 *
+		 * Constructs an object which is not associated with any file.
+		 */
+		MappedFile                  (void);
+
+		/**
+		 * Mapping constructor
+		 *
+		 * Maps the whole specified file into memory. If the file does not exist or cannot be
+		 * mapped, the object is left closed (see \ref isOpen).
+		 *
+		 * \param   file_name   Name of a file to map.
+		 */
+		explicit MappedFile         (std::string const file_name);
+
+		/**
+		 * Move constructor
+		 *
+		 * Takes over the mapping of another object, which is left closed.
+		 *
+		 * \param   other   An object to take the mapping from.
+		 */
+		MappedFile                  (MappedFile &&other);
+
+		/**
+		 * Default destructor
+		 *
+		 * Releases the mapping.
+		 */
+		~MappedFile                 (void);
+
+		// Prevent implicit creation of copy-constructor and the copy assignment operator
+		MappedFile                  (MappedFile &)      = delete;
+		MappedFile &    operator =  (MappedFile &)      = delete;
+
+		///@}
+
+
+
+		/// \name Operators
+		///@{
+
+		/**
+		 * Move assignment operator
+		 *
+		 * Releases the current mapping and takes over the mapping of another object, which is
+		 * left closed.
+		 *
+		 * \param   other   An object to take the mapping from.
+		 */
+		MappedFile &    operator =  (MappedFile &&other);
+
+		///@}
+
+
+
+		/// \name Accessors
+		///@{
+
+		/**
+		 * Check if a file is mapped
+		 *
+		 * \return \c true, if a file is mapped, \c false otherwise. Empty files are never
+		 * mapped.
+		 */
+		bool const          isOpen      (void)  const;
+
+		/**
+		 * Get contents of the file
+		 *
+		 * \return Pointer to the first byte of the file, or \c nullptr if no file is mapped.
+		 */
+		char const *        getData     (void)  const;
+
+		/**
+		 * Get size of the file
+		 *
+		 * \return Size of the file in bytes, or 0 if no file is mapped.
+		 */
+		uint64_t const      getSize     (void)  const;
+
+		///@}
+
+
+
+		/// \name Modifiers
+		///@{
+
+		/**
+		 * Release the mapping
+		 *
+		 * Unmaps the file, if any. All pointers obtained from the object become invalid.
+		 */
+		void                close       (void);
+
+		///@}
+	private:
+		char const         *data;
+		uint64_t            size;
+	};
+
+
+
+
+
+} // rwe
+
+
+
+
+
+#endif // RWE__MAPPED_FILE_HPP__
@@ -6,11 +6,664 @@
  *       Andrei Eliseev (JointPoints), 2021
  */
 #include "../rw_space/rw_space.hpp"
+#include "../rweg/rweg.hpp"
+#include "../rwegz/rwegz.hpp"
+#include "../text_parser/text_parser.hpp"
 
 #include <stdexcept>    // needed for exceptions
-#include <algorithm>    // needed for "find_if", "find", "min", "max", "lower_bound"
+#include <algorithm>    // needed for "find_if", "find", "min", "max", "lower_bound", "sort", "stable_sort", "unique", "inplace_merge", "is_sorted"
 #include <fstream>      // needed for "fstream"
 #include <set>          // needed for "set"
+#include <limits>       // needed for "numeric_limits"
+#include <cstring>      // needed for "memcpy", "memchr"
+#include <thread>       // needed for "thread"
+#include <exception>    // needed for "exception_ptr", "current_exception", "rethrow_exception", "make_exception_ptr"
+#include <system_error> // needed for "system_error"
+#include <cctype>       // needed for "tolower"
+#include <numeric>      // needed for "accumulate", "iota"
+#include <queue>        // needed for "priority_queue"
+#include <deque>        // needed for "deque"
+#include <cstdio>       // needed for "remove"
+#include <atomic>       // needed for "atomic"
+#include <random>       // needed for "random_device"
+#include <chrono>       // needed for "system_clock"
+
+
+
+
+
+namespace
+{
+	// Copies a string literal without its terminating null character and returns the position after it
+	template <size_t size>
+	char * appendText(char *position, char const (&text)[size])
+	{
+		std::memcpy(position, text, size - 1);
+		return position + size - 1;
+	}
+
+	// Appends the format to the name of a file, unless it is already there; unless the file may be rewritten, " (1)",
+	// " (2)", etc. is inserted before the format until the name of a file which does not exist yet is found
+	std::string const findFileName(std::string const &file_name, std::string const &file_format, bool const rewrite)
+	{
+		std::string const   base_name       = ((file_name.size() >= file_format.size()) && (file_name.substr(file_name.size() - file_format.size()) == file_format)) ? (file_name.substr(0, file_name.size() - file_format.size())) : (file_name);
+		std::string         full_file_name  = base_name + file_format;
+
+		for (uint64_t file_number = 1; (!rewrite) && (std::ifstream(full_file_name).is_open()); ++file_number)
+			full_file_name = base_name + " (" + std::to_string(file_number) + ")" + file_format;
+
+		return full_file_name;
+	}
+
+	enum GEXFLexStates{SPACE, TOKEN};
+	enum GEXFParserStates{PROLOGUE, DEFAULT_TYPE_VALUE, EDGE_BEGIN, ATTR_BEGIN, SOURCE_VALUE, TARGET_VALUE, TYPE_VALUE, WEIGHT_VALUE, SKIP_VALUE, EPILOGUE};
+
+	// A state machine which tokenises a part of a gexf file and passes edges to its own builder
+	template <typename Real>
+	class GEXFParser
+	{
+	public:
+		GEXFParser(GEXFParserStates const initial_state, bool const default_is_directed) :
+			lexer_state(SPACE), ignore_ws_regime(false), token(), parser_state(initial_state), builder(), out_vertex(0), in_vertex(0), length(0.0),
+			is_directed(false), default_is_directed(default_is_directed), default_type_found(false), source_specified(false), target_specified(false), weight_specified(false)
+		{
+			// Intended to be empty
+		}
+
+		GEXFParserStates const              getState                (void)  const   {return this->parser_state;}
+		bool const                          getDefaultIsDirected    (void)  const   {return this->default_is_directed;}
+		rwe::MetricGraphBuilder<Real> &     getBuilder              (void)          {return this->builder;}
+
+		// Parses the text until its end, the end of the "edges" section or, if it has not begun yet, its beginning
+		char const *                        parse                   (char const *begin, char const *end)
+		{
+			for (char const *symbol = begin; symbol != end; ++symbol)
+			{
+				switch (this->lexer_state)
+				{
+				// expect space
+				case SPACE:
+					if ((*symbol == ' ') || (*symbol == '\t') || (*symbol == '\n') || (*symbol == '\r'))
+						break;
+					this->lexer_state = TOKEN;
+				// expect token
+				case TOKEN:
+					if (!this->ignore_ws_regime)
+					{
+						if ((*symbol == '>') || (*symbol == '=') || (*symbol == ' ') || (*symbol == '\t') || (*symbol == '\n') || (*symbol == '\r'))
+						{
+							GEXFParserStates const previous_state = this->parser_state;
+
+							this->lexer_state = SPACE;
+							if (this->token.empty())
+								break;
+							this->parseToken();
+							this->token.clear();
+							if ((this->parser_state == EPILOGUE) || ((previous_state == PROLOGUE) && (this->parser_state == EDGE_BEGIN)))
+								return symbol + 1;
+							break;
+						}
+					}
+					if (*symbol == '"')
+						this->ignore_ws_regime = !this->ignore_ws_regime;
+					else
+						this->token += *symbol;
+					break;
+				}
+			}
+
+			return end;
+		}
+
+		// Emulates the "<edge" token the next chunk begins with; fails if the result depends on the state left by this chunk
+		bool const                          finishChunk             (void)
+		{
+			if ((!this->token.empty()) || (this->ignore_ws_regime))
+				return false;
+			if (this->parser_state == EDGE_BEGIN)
+				return true;
+			if ((this->parser_state == ATTR_BEGIN) && (this->source_specified) && (this->target_specified) && (this->weight_specified))
+			{
+				this->builder.addEdge(this->out_vertex, this->in_vertex, this->length, this->is_directed);
+				this->parser_state = EDGE_BEGIN;
+				return true;
+			}
+			return false;
+		}
+	private:
+		GEXFLexStates                       lexer_state;
+		bool                                ignore_ws_regime;
+		std::string                         token;
+		GEXFParserStates                    parser_state;
+		rwe::MetricGraphBuilder<Real>       builder;
+		uint32_t                            out_vertex, in_vertex;
+		long double                         length;
+		bool                                is_directed;
+		bool                                default_is_directed;
+		bool                                default_type_found;
+		bool                                source_specified;
+		bool                                target_specified;
+		bool                                weight_specified;
+
+		void                                parseToken              (void)
+		{
+			int                                 vertex              = 0;
+			char const                         *token_begin         = this->token.data();
+			char const                         *token_end           = this->token.data() + this->token.size();
+
+			// We don't really care about anything but the default edge type and the "edges" section
+			if ((this->parser_state != PROLOGUE) && (this->parser_state != DEFAULT_TYPE_VALUE) && (this->token == "</edges"))
+			{
+				this->parser_state = EPILOGUE;
+				return;
+			}
+			switch (this->parser_state)
+			{
+			// expect the default edge type or the beginning of the "edges" section
+			case PROLOGUE:
+				if ((this->token == "defaultedgetype") && (!this->default_type_found))
+					this->parser_state = DEFAULT_TYPE_VALUE;
+				if (this->token == "<edges")
+					this->parser_state = EDGE_BEGIN;
+				break;
+			// expect the default edge type value
+			case DEFAULT_TYPE_VALUE:
+				if ((this->token == "undirected") || (this->token == "mutual"))
+					this->default_is_directed = false;
+				else
+					if (this->token == "directed")
+						this->default_is_directed = true;
+					else
+						throw std::runtime_error("Unknown default type of the edge '" + this->token + "'.");
+				this->default_type_found = true;
+				this->parser_state = PROLOGUE;
+				break;
+			// expect beginning of a new edge
+			case EDGE_BEGIN:
+				if (this->token != "<edge")
+					throw std::runtime_error("Unexpected token '" + this->token + "' in the 'edges' section of the gexf file.");
+				this->source_specified = this->target_specified = this->weight_specified = false;
+				this->out_vertex = this->in_vertex = 0;
+				this->length = 0.0;
+				this->is_directed = this->default_is_directed;
+				this->parser_state = ATTR_BEGIN;
+				break;
+			// expect beginning of an attribute
+			case ATTR_BEGIN:
+				if (this->token == "source")
+				{
+					this->parser_state = SOURCE_VALUE;
+					break;
+				}
+				if (this->token == "target")
+				{
+					this->parser_state = TARGET_VALUE;
+					break;
+				}
+				if (this->token == "type")
+				{
+					this->parser_state = TYPE_VALUE;
+					break;
+				}
+				if (this->token == "weight")
+				{
+					this->parser_state = WEIGHT_VALUE;
+					break;
+				}
+				if ((this->token == "<edge") || (this->token == "/"))
+				{
+					if (this->source_specified && this->target_specified && this->weight_specified)
+					{
+						this->builder.addEdge(this->out_vertex, this->in_vertex, this->length, this->is_directed);
+						if (this->token == "<edge")
+						{
+							this->source_specified = this->target_specified = this->weight_specified = false;
+							this->out_vertex = this->in_vertex = 0;
+							this->length = 0.0;
+							this->is_directed = this->default_is_directed;
+							break;
+						}
+						this->parser_state = EDGE_BEGIN;
+						break;
+					}
+					throw std::runtime_error("Each edge must contain 'source', 'target' and 'weight' attributes.");
+				}
+				if (this->token[0] == '<')
+					throw std::runtime_error("Unexpected token '" + this->token + "' in the 'edges' section of the gexf file.");
+				this->parser_state = SKIP_VALUE;
+				break;
+			// expect the source value
+			case SOURCE_VALUE:
+				if (!rwe::parseInteger(token_begin, token_end, vertex))
+					throw std::runtime_error("Vertex ID '" + this->token + "' do not comply with the requirements of emulator.");
+				this->out_vertex = vertex;
+				this->source_specified = true;
+				this->parser_state = ATTR_BEGIN;
+				break;
+			// expect the target value
+			case TARGET_VALUE:
+				if (!rwe::parseInteger(token_begin, token_end, vertex))
+					throw std::runtime_error("Vertex ID '" + this->token + "' do not comply with the requirements of emulator.");
+				this->in_vertex = vertex;
+				this->target_specified = true;
+				this->parser_state = ATTR_BEGIN;
+				break;
+			// expect the type value
+			case TYPE_VALUE:
+				if ((this->token == "undirected") || (this->token == "mutual"))
+				{
+					this->is_directed = false;
+					this->parser_state = ATTR_BEGIN;
+					break;
+				}
+				if (this->token == "directed")
+				{
+					this->is_directed = true;
+					this->parser_state = ATTR_BEGIN;
+					break;
+				}
+				throw std::runtime_error("Unknown type of the edge '" + this->token + "'.");
+			// expect the weight value
+			case WEIGHT_VALUE:
+				if (!rwe::parseReal(token_begin, token_end, this->length))
+					throw std::runtime_error("Unable to interpret weight value '" + this->token + "'.");
+				this->weight_specified = true;
+				this->parser_state = ATTR_BEGIN;
+				break;
+			// skip the value
+			case SKIP_VALUE:
+				this->parser_state = ATTR_BEGIN;
+				break;
+			// ignore everything after the "edges" section
+			case EPILOGUE:
+				break;
+			}
+
+			return;
+		}
+	};
+
+	// Tells whether a line begins right at the symbol
+	bool const isLineBegin(char const *symbol)
+	{
+		return symbol[-1] == '\n';
+	}
+
+	// Tells whether an edge of a gexf file begins right at the symbol; the symbol must be followed by 5 more ones
+	bool const isEdgeBegin(char const *symbol)
+	{
+		return ((symbol[-1] == ' ') || (symbol[-1] == '\t') || (symbol[-1] == '\n') || (symbol[-1] == '\r') || (symbol[-1] == '>')) &&
+		       (symbol[0] == '<') && (symbol[1] == 'e') && (symbol[2] == 'd') && (symbol[3] == 'g') && (symbol[4] == 'e') &&
+		       ((symbol[5] == ' ') || (symbol[5] == '\t') || (symbol[5] == '\n') || (symbol[5] == '\r') || (symbol[5] == '/') || (symbol[5] == '>'));
+	}
+
+	// Finds the end of the line that begins at the position, excluding the line break; "next_line" receives the beginning of the next line
+	char const * findLineEnd(char const *position, char const *end, char const *&next_line)
+	{
+		char const *line_end = static_cast<char const *>(std::memchr(position, '\n', end - position));
+
+		next_line = (line_end == nullptr) ? (end) : (line_end + 1);
+		line_end = (line_end == nullptr) ? (end) : (line_end);
+		if ((line_end != position) && (line_end[-1] == '\r'))
+			--line_end;
+		return line_end;
+	}
+
+	// Finds the next token of a line separated by spaces or tabs and moves the position past it
+	bool const nextToken(char const *&position, char const *end, char const *&token_begin, char const *&token_end)
+	{
+		while ((position != end) && ((*position == ' ') || (*position == '\t')))
+			++position;
+		if (position == end)
+			return false;
+		token_begin = position;
+		while ((position != end) && (*position != ' ') && (*position != '\t'))
+			++position;
+		token_end = position;
+		return true;
+	}
+
+	// Compares a token with a lowercase word ignoring the case of the token
+	bool const isToken(char const *token_begin, char const *token_end, char const *word)
+	{
+		for (; (token_begin != token_end) && (*word != '\0'); ++token_begin, ++word)
+			if (std::tolower(static_cast<unsigned char>(*token_begin)) != *word)
+				return false;
+		return (token_begin == token_end) && (*word == '\0');
+	}
+
+	// Calls <task> for chunks 0, 1, ..., <chunk_count> - 1 in parallel, chunk 0 in the calling thread, and waits for all of
+	// them to finish; if the platform fails to start a thread or chunk 0 throws, the threads already started are joined
+	// before the exception is rethrown
+	template <typename Task>
+	void runChunks(uint32_t const chunk_count, Task const &task)
+	{
+		std::vector<std::thread>    threads;
+		std::exception_ptr          error;
+
+		// 1. Start a thread for each chunk but the first one, which is processed right here
+		try
+		{
+			threads.reserve(chunk_count);
+			for (uint32_t chunk_i = 1; chunk_i < chunk_count; ++chunk_i)
+				threads.emplace_back(task, chunk_i);
+		}
+		catch (std::system_error const &system_error)
+		{
+			error = std::make_exception_ptr(std::runtime_error(std::string("Unable to start threads: ") + system_error.what()));
+		}
+		catch (...)
+		{
+			error = std::current_exception();
+		}
+		if (!error)
+		{
+			try
+			{
+				task(0);
+			}
+			catch (...)
+			{
+				error = std::current_exception();
+			}
+		}
+
+		// 2. Wait for every thread that has been started
+		for (uint32_t thread_i = 0; thread_i < threads.size(); ++thread_i)
+			threads[thread_i].join();
+		if (error)
+			std::rethrow_exception(error);
+
+		return;
+	}
+
+	// Parses each chunk of text into its own builder in its own thread and joins the builders in the order of the text;
+	// the first error in this order is rethrown
+	template <typename Real, typename ChunkParser>
+	void parseChunks(std::vector<char const *> const &chunk_begins, ChunkParser const &parse_chunk, rwe::MetricGraphBuilder<Real> &builder)
+	{
+		std::vector<rwe::MetricGraphBuilder<Real>>  builders(chunk_begins.size() - 1);
+		std::vector<std::exception_ptr>             errors(chunk_begins.size() - 1);
+		auto const                                  run_chunk   = [&chunk_begins, &parse_chunk, &builders, &errors](uint32_t const chunk_i)
+		                                                          {
+		                                                              try
+		                                                              {
+		                                                                  parse_chunk(chunk_i, chunk_begins[chunk_i], chunk_begins[chunk_i + 1], builders[chunk_i]);
+		                                                              }
+		                                                              catch (...)
+		                                                              {
+		                                                                  errors[chunk_i] = std::current_exception();
+		                                                              }
+		                                                          };
+
+		runChunks(builders.size(), run_chunk);
+		for (uint32_t chunk_i = 0; chunk_i < builders.size(); ++chunk_i)
+		{
+			if (errors[chunk_i])
+				std::rethrow_exception(errors[chunk_i]);
+			builder.append(std::move(builders[chunk_i]));
+		}
+
+		return;
+	}
+
+	// Splits a part of the "edges" section of a gexf file which ends at the beginning of an edge (or at the end of file) into
+	// chunks and parses each of them in its own thread; on return, <parsers> hold the chunks up to the end of the section,
+	// if it is there, and the first error in this order is rethrown; returns false, if a chunk does not end the same way
+	// the next one begins, i.e., the file is malformed at a split point and the part has to be parsed in a single pass
+	template <typename Real>
+	bool const parseGEXFChunks(char const *begin, char const *end, char const *file_end, uint64_t const min_chunk_size, bool const default_is_directed, std::vector<GEXFParser<Real>> &parsers)
+	{
+		std::vector<char const *>           chunk_begins;
+		std::vector<uint8_t>                is_consistent;
+		std::vector<std::exception_ptr>     errors;
+		auto const                          parse_chunk     = [&chunk_begins, &parsers, &is_consistent, &errors, file_end](uint32_t const chunk_i)
+		                                                      {
+		                                                          try
+		                                                          {
+		                                                              parsers[chunk_i].parse(chunk_begins[chunk_i], chunk_begins[chunk_i + 1]);
+		                                                              is_consistent[chunk_i] = (parsers[chunk_i].getState() == EPILOGUE) || (chunk_begins[chunk_i + 1] == file_end) || (parsers[chunk_i].finishChunk());
+		                                                          }
+		                                                          catch (...)
+		                                                          {
+		                                                              errors[chunk_i] = std::current_exception();
+		                                                          }
+		                                                      };
+
+		// 1. Split the text at the beginnings of edges; a boundary needs 6 more symbols after it, so that the predicate
+		//    never reads past the end of file
+		chunk_begins = rwe::splitText(begin, std::max(begin, std::min(end, file_end - 6)), min_chunk_size, isEdgeBegin);
+		chunk_begins.back() = end;
+		parsers.assign(chunk_begins.size() - 1, GEXFParser<Real>(EDGE_BEGIN, default_is_directed));
+		is_consistent.assign(parsers.size(), false);
+		errors.assign(parsers.size(), nullptr);
+		runChunks(parsers.size(), parse_chunk);
+
+		// 2. Chunks are checked in the order of the text up to the end of the section
+		for (uint32_t chunk_i = 0; chunk_i < parsers.size(); ++chunk_i)
+		{
+			if (errors[chunk_i])
+				std::rethrow_exception(errors[chunk_i]);
+			if (!is_consistent[chunk_i])
+				return false;
+			if (parsers[chunk_i].getState() == EPILOGUE)
+			{
+				parsers.erase(parsers.begin() + chunk_i + 1, parsers.end());
+				break;
+			}
+		}
+
+		return true;
+	}
+
+	// Orders edge records by unordered pairs of their end points
+	template <typename Record>
+	bool const isLessPair(Record const &record_1, Record const &record_2)
+	{
+		return std::make_pair(std::min(record_1.out_vertex, record_1.in_vertex), std::max(record_1.out_vertex, record_1.in_vertex)) <
+		       std::make_pair(std::min(record_2.out_vertex, record_2.in_vertex), std::max(record_2.out_vertex, record_2.in_vertex));
+	}
+
+	// Orders edge records the same way as edges of MetricGraph are laid out
+	template <typename Record>
+	bool const isLessEdge(Record const &record_1, Record const &record_2)
+	{
+		return std::make_pair(record_1.out_vertex, record_1.in_vertex) < std::make_pair(record_2.out_vertex, record_2.in_vertex);
+	}
+
+	// Folds a record into the merged record of the same pair of vertices the same way consecutive calls of "updateEdge"
+	// would do:
+	//     - a directed edge followed by a directed edge of the same direction only updates the length
+	//     - a directed edge followed by a directed edge of the opposite direction becomes undirected
+	//     - an undirected edge followed by a directed edge only updates the length
+	//     - anything followed by an undirected edge becomes undirected
+	// Folding is associative, so records may be folded in groups which are folded afterwards
+	template <typename Record>
+	void foldRecord(Record &merged_record, Record const &curr_record)
+	{
+		merged_record.length = curr_record.length;
+		if ((curr_record.is_directed) && ((!merged_record.is_directed) || (merged_record.out_vertex == curr_record.out_vertex)))
+			return;
+		merged_record.out_vertex = std::min(curr_record.out_vertex, curr_record.in_vertex);
+		merged_record.in_vertex = std::max(curr_record.out_vertex, curr_record.in_vertex);
+		merged_record.is_directed = false;
+	}
+
+	// Adds a suffix unique to the caller to a prefix of names of temporary files: calls within a process get different
+	// numbers, and processes get different random numbers
+	std::string const makeUniquePrefix(std::string const &prefix)
+	{
+		static std::atomic<uint64_t>    call_counter(0);
+		std::random_device              random_device;
+		uint64_t const                  random_number   = (uint64_t(random_device()) << 32) ^ random_device() ^ std::chrono::system_clock::now().time_since_epoch().count();
+
+		return prefix + " (" + std::to_string(random_number) + "-" + std::to_string(call_counter++) + ")";
+	}
+
+	// Reads a run of records from a temporary file sequentially through its own buffer
+	template <typename Record>
+	class RunReader
+	{
+	public:
+		RunReader(std::string const &file_name, uint64_t const buffer_size) :
+			stream(file_name, std::fstream::in | std::fstream::binary), buffer(std::max<uint64_t>(buffer_size, 1)), position(0), size(0)
+		{
+			if (!this->stream.is_open())
+				throw std::runtime_error("Unable to open a temporary file.");
+		}
+
+		// Gets the next record, returns false at the end of the run
+		bool const next(Record &record)
+		{
+			if (this->position == this->size)
+			{
+				this->stream.read(reinterpret_cast<char *>(this->buffer.data()), this->buffer.size() * sizeof(Record));
+				this->position = 0;
+				this->size = this->stream.gcount() / sizeof(Record);
+				if (this->size == 0)
+					return false;
+			}
+			record = this->buffer[this->position++];
+			return true;
+		}
+	private:
+		std::fstream            stream;
+		std::vector<Record>     buffer;
+		uint64_t                position;
+		uint64_t                size;
+	};
+
+	// Writes a run of records to a temporary file sequentially through its own buffer
+	template <typename Record>
+	class RunWriter
+	{
+	public:
+		RunWriter(std::string const &file_name, uint64_t const buffer_size) :
+			stream(file_name, std::fstream::out | std::fstream::binary | std::fstream::trunc), buffer()
+		{
+			if (!this->stream.is_open())
+				throw std::runtime_error("Unable to create a temporary file.");
+			this->buffer.reserve(std::max<uint64_t>(buffer_size, 1));
+		}
+
+		void write(Record const &record)
+		{
+			this->buffer.push_back(record);
+			if (this->buffer.size() == this->buffer.capacity())
+				this->flush();
+		}
+
+		void write(Record const *records, uint64_t const record_count)
+		{
+			this->flush();
+			this->stream.write(reinterpret_cast<char const *>(records), record_count * sizeof(Record));
+		}
+
+		void close(void)
+		{
+			this->flush();
+			this->stream.close();
+			if (this->stream.fail())
+				throw std::runtime_error("Unable to write a temporary file.");
+		}
+	private:
+		std::fstream            stream;
+		std::vector<Record>     buffer;
+
+		void flush(void)
+		{
+			this->stream.write(reinterpret_cast<char const *>(this->buffer.data()), this->buffer.size() * sizeof(Record));
+			this->buffer.clear();
+		}
+	};
+
+	// Merges runs sorted by the comparator into a single sequence of records passed to the consumer; records that are
+	// equal with respect to the comparator are folded in the order of runs (see "foldRecord")
+	template <typename Record, typename Comparator, typename Consumer>
+	void mergeRuns(std::vector<std::string> const &run_names, uint64_t const buffer_size, Comparator const &is_less, Consumer const &consume)
+	{
+		std::deque<RunReader<Record>>   readers;
+		std::vector<Record>             heads(run_names.size());
+		auto const                      is_later        = [&heads, &is_less](uint32_t const run_1, uint32_t const run_2)
+		                                                  {
+		                                                      return (is_less(heads[run_2], heads[run_1])) || ((!is_less(heads[run_1], heads[run_2])) && (run_2 < run_1));
+		                                                  };
+		std::priority_queue<uint32_t, std::vector<uint32_t>, decltype(is_later)>    queue(is_later);
+		Record                          merged_record   = {};
+		bool                            has_merged      = false;
+
+		// 1. The buffer is shared equally by all runs
+		for (uint32_t run_i = 0; run_i < run_names.size(); ++run_i)
+		{
+			readers.emplace_back(run_names[run_i], buffer_size / run_names.size());
+			if (readers[run_i].next(heads[run_i]))
+				queue.push(run_i);
+		}
+
+		// 2. Each time the least head is taken, ties go to earlier runs
+		while (!queue.empty())
+		{
+			uint32_t const run_i = queue.top();
+
+			queue.pop();
+			if ((has_merged) && (!is_less(merged_record, heads[run_i])))
+				foldRecord(merged_record, heads[run_i]);
+			else
+			{
+				if (has_merged)
+					consume(merged_record);
+				merged_record = heads[run_i];
+				has_merged = true;
+			}
+			if (readers[run_i].next(heads[run_i]))
+				queue.push(run_i);
+		}
+		if (has_merged)
+			consume(merged_record);
+
+		return;
+	}
+
+	// Writes a section of a binary file sequentially through its own buffer, so that several sections may be written
+	// at the same time
+	class SectionWriter
+	{
+	public:
+		SectionWriter(std::fstream &stream, uint64_t const offset, uint64_t const buffer_size) :
+			stream(stream), offset(offset), buffer()
+		{
+			this->buffer.reserve(std::max<uint64_t>(buffer_size, 64));
+		}
+
+		template <typename Value>
+		void write(Value const value)
+		{
+			if (this->buffer.size() + sizeof(Value) > this->buffer.capacity())
+				this->flush();
+			this->buffer.insert(this->buffer.end(), reinterpret_cast<char const *>(&value), reinterpret_cast<char const *>(&value) + sizeof(Value));
+		}
+
+		// Pads the section with zeros up to the specified offset
+		void pad(uint64_t const end_offset)
+		{
+			while (this->offset + this->buffer.size() < end_offset)
+				this->write<char>(0);
+			this->flush();
+		}
+
+		void flush(void)
+		{
+			this->stream.seekp(this->offset);
+			this->stream.write(this->buffer.data(), this->buffer.size());
+			this->offset += this->buffer.size();
+			this->buffer.clear();
+		}
+	private:
+		std::fstream           &stream;
+		uint64_t                offset;
+		std::vector<char>       buffer;
+	};
+}
 
 
 
@@ -22,15 +675,17 @@
 
 
 
-rwe::MetricGraph::MetricGraph(void) :
-	edges(), associated_wanders()
+template <typename Real>
+rwe::MetricGraph<Real>::MetricGraph(void) :
+	edges(), edge_columns(), vertex_index(), associated_wanders()
 {
 	// Intended to be empty
 }
 
 
 
-rwe::MetricGraph::~MetricGraph(void)
+template <typename Real>
+rwe::MetricGraph<Real>::~MetricGraph(void)
 {
 	// 1. Kill all associated wanders
 	for (uint32_t wander_i = 0; wander_i < this->associated_wanders.size(); ++wander_i)
@@ -47,7 +702,8 @@ rwe::MetricGraph::~MetricGraph(void)
 
 
 
-rwe::MetricGraph & rwe::MetricGraph::operator=(rwe::MetricGraph &&other)
+template <typename Real>
+rwe::MetricGraph<Real> & rwe::MetricGraph<Real>::operator=(rwe::MetricGraph<Real> &&other)
 {
 	// 1. Invalidate associated wanders
 	for (uint32_t wander_i = 0; wander_i < this->associated_wanders.size(); ++wander_i)
@@ -55,6 +711,8 @@ rwe::MetricGraph & rwe::MetricGraph::operator=(rwe::MetricGraph &&other)
 	
 	// 2. Copy data from <other>
 	this->edges = std::move(other.edges);
+	this->edge_columns = std::move(other.edge_columns);
+	this->vertex_index = std::move(other.vertex_index);
 	this->associated_wanders.insert(this->associated_wanders.end(), other.associated_wanders.begin(), other.associated_wanders.end());
 
 	return *this;
@@ -70,591 +728,1960 @@ rwe::MetricGraph & rwe::MetricGraph::operator=(rwe::MetricGraph &&other)
 
 
 
-bool const rwe::MetricGraph::checkVertex(uint32_t const vertex) const
+template <typename Real>
+bool const rwe::MetricGraph<Real>::checkVertex(uint32_t const vertex) const
 {
-	// 1. Check if <vertex> is present in the <id>'s of neighbourhoods
-	auto    comparator          = [](VertexView const curr_vertex, uint32_t const value){return curr_vertex.id < value;};
-	auto    vertex_lower_bound  = std::lower_bound(this->edges.begin(), this->edges.end(), vertex, comparator);
+	return this->vertex_index.find(vertex) != this->vertex_index.end();
+}
+
+
+
+template <typename Real>
+uint32_t const rwe::MetricGraph<Real>::getVertexCount(void) const
+{
+	return this->edges.size();
+}
+
+
+
+template <typename Real>
+uint64_t const rwe::MetricGraph<Real>::getEdgeCount(void) const
+{
+	return this->edge_columns.lengths.size();
+}
+
+
+
+template <typename Real>
+std::vector<uint32_t> const rwe::MetricGraph<Real>::getVertexList(void) const
+{
+	std::vector<uint32_t>   vertices    = this->getSortedIndices();
+
+	for (uint32_t vertex_i = 0; vertex_i < vertices.size(); ++vertex_i)
+		vertices[vertex_i] = this->edges[vertices[vertex_i]].id;
+
+	return vertices;
+}
+
 
-	if ((vertex_lower_bound != this->edges.end()) && (vertex_lower_bound->id == vertex))
-		return true;
 
-	// 2. Try looking for <vertex> among adjacent vertices
-	for (uint32_t neighbourhood_i = 0; neighbourhood_i < this->edges.size(); ++neighbourhood_i)
+template <typename Real>
+Real const rwe::MetricGraph<Real>::getEdgeLength(uint32_t const out_vertex, uint32_t in_vertex) const
+{
+	// 1. Try to find corresponding edge
+	Edge edge = this->getEdge(out_vertex, in_vertex);
+
+	if (edge.first != this->edges.size())
+		return this->edge_columns.lengths[this->edges[edge.first].out_edges[edge.second]];
+
+	// 2. If there is no edge between <out_vertex> and <in_vertex>, return infinity
+	return std::numeric_limits<Real const>::infinity();
+}
+
+
+
+template <typename Real>
+rwe::MemoryUsage const rwe::MetricGraph<Real>::getMemoryUsage(void) const
+{
+	uint64_t        edge_id_list_bytes  = 0;
+	uint64_t const  vertex_index_bytes  = this->vertex_index.bucket_count() * sizeof(void *) + this->vertex_index.size() * (sizeof(typename VertexIndex::value_type) + sizeof(void *));
+
+	for (uint32_t vertex_1 = 0; vertex_1 < this->edges.size(); ++vertex_1)
+		edge_id_list_bytes += (this->edges[vertex_1].out_edges.capacity() + this->edges[vertex_1].in_edges.capacity()) * sizeof(uint64_t);
+
+	return MemoryUsage
+	{
+		{"vertex views",    this->edges.capacity() * sizeof(VertexView),                        this->edges.capacity() * sizeof(VertexView)},
+		{"edge ID lists",   edge_id_list_bytes,                                                 edge_id_list_bytes},
+		{"edge sources",    this->edge_columns.sources.capacity() * sizeof(uint32_t),           this->edge_columns.sources.capacity() * sizeof(uint32_t)},
+		{"edge targets",    this->edge_columns.targets.capacity() * sizeof(uint32_t),           this->edge_columns.targets.capacity() * sizeof(uint32_t)},
+		{"edge lengths",    this->edge_columns.lengths.capacity() * sizeof(Real),               this->edge_columns.lengths.capacity() * sizeof(Real)},
+		{"edge directions", this->edge_columns.directions.capacity() * sizeof(uint64_t),        this->edge_columns.directions.capacity() * sizeof(uint64_t)},
+		{"vertex index",    vertex_index_bytes,                                                 vertex_index_bytes}
+	};
+}
+
+
+
+template <typename Real>
+void rwe::MetricGraph<Real>::outputEdgeList(std::ostream &output_stream) const
+{
+	std::vector<uint32_t> const sorted_indices = this->getSortedIndices();
+
+	for (uint32_t vertex_1 = 0; vertex_1 < this->edges.size(); ++vertex_1)
+	{
+		VertexView const &curr_vertex = this->edges[sorted_indices[vertex_1]];
+		for (uint32_t vertex_2 = 0; vertex_2 < curr_vertex.out_edges.size(); ++vertex_2)
+		{
+			uint64_t const edge = curr_vertex.out_edges[vertex_2];
+			output_stream << curr_vertex.id << ((this->isDirected(edge)) ? (" ---> ") : (" ---- ")) << this->edge_columns.targets[edge] << '\t' << this->edge_columns.lengths[edge] << '\n';
+		}
+	}
+
+	return;
+}
+
+
+
+template <typename Real>
+std::vector<uint32_t> const rwe::MetricGraph<Real>::getOutNeighbours(uint32_t const vertex) const
+{
+	auto                    vertex_i    = this->vertex_index.find(vertex);
+	std::vector<uint32_t>   answer;
+
+	if (vertex_i == this->vertex_index.end())
+		return answer;
+
+	VertexView const &curr_vertex = this->edges[vertex_i->second];
+
+	// 1. Everything stored under <vertex> is either <vertex> ---> <x> or <vertex> ---- <x>
+	answer.reserve(curr_vertex.out_edges.size() + curr_vertex.in_edges.size());
+	for (uint32_t out_edge_i = 0; out_edge_i < curr_vertex.out_edges.size(); ++out_edge_i)
+		answer.push_back(this->edge_columns.targets[curr_vertex.out_edges[out_edge_i]]);
+
+	// 2. Undirected edges <x> ---- <vertex> are stored under <x>
+	for (uint32_t in_edge_i = 0; in_edge_i < curr_vertex.in_edges.size(); ++in_edge_i)
+	{
+		uint64_t const edge = curr_vertex.in_edges[in_edge_i];
+		if ((!this->isDirected(edge)) && (this->edge_columns.sources[edge] != vertex))
+			answer.push_back(this->edge_columns.sources[edge]);
+	}
+	std::inplace_merge(answer.begin(), answer.begin() + curr_vertex.out_edges.size(), answer.end());
+
+	return answer;
+}
+
+
+
+template <typename Real>
+std::vector<uint32_t> const rwe::MetricGraph<Real>::getInNeighbours(uint32_t const vertex) const
+{
+	auto                    vertex_i    = this->vertex_index.find(vertex);
+	std::vector<uint32_t>   answer;
+
+	if (vertex_i == this->vertex_index.end())
+		return answer;
+
+	VertexView const &curr_vertex = this->edges[vertex_i->second];
+
+	// 1. Everything that leads to <vertex> is either <x> ---> <vertex> or <x> ---- <vertex>
+	answer.reserve(curr_vertex.in_edges.size() + curr_vertex.out_edges.size());
+	for (uint32_t in_edge_i = 0; in_edge_i < curr_vertex.in_edges.size(); ++in_edge_i)
+		answer.push_back(this->edge_columns.sources[curr_vertex.in_edges[in_edge_i]]);
+
+	// 2. Undirected edges <vertex> ---- <x> are stored under <vertex>
+	for (uint32_t out_edge_i = 0; out_edge_i < curr_vertex.out_edges.size(); ++out_edge_i)
+	{
+		uint64_t const edge = curr_vertex.out_edges[out_edge_i];
+		if ((!this->isDirected(edge)) && (this->edge_columns.targets[edge] != vertex))
+			answer.push_back(this->edge_columns.targets[edge]);
+	}
+	std::inplace_merge(answer.begin(), answer.begin() + curr_vertex.in_edges.size(), answer.end());
+
+	return answer;
+}
+
+
+
+template <typename Real>
+std::vector<uint32_t> const rwe::MetricGraph<Real>::getUndirectedNeighbours(uint32_t const vertex) const
+{
+	auto                    vertex_i    = this->vertex_index.find(vertex);
+	std::vector<uint32_t>   answer;
+
+	if (vertex_i == this->vertex_index.end())
+		return answer;
+
+	VertexView const &curr_vertex = this->edges[vertex_i->second];
+
+	// 1. Undirected edges <x> ---- <vertex> are stored under <x>, where <x> is not greater than <vertex>
+	for (uint32_t in_edge_i = 0; in_edge_i < curr_vertex.in_edges.size(); ++in_edge_i)
+	{
+		uint64_t const edge = curr_vertex.in_edges[in_edge_i];
+		if ((!this->isDirected(edge)) && (this->edge_columns.sources[edge] != vertex))
+			answer.push_back(this->edge_columns.sources[edge]);
+	}
+
+	// 2. Undirected edges <vertex> ---- <x> are stored under <vertex>, where <x> is not less than <vertex>
+	for (uint32_t out_edge_i = 0; out_edge_i < curr_vertex.out_edges.size(); ++out_edge_i)
+		if (!this->isDirected(curr_vertex.out_edges[out_edge_i]))
+			answer.push_back(this->edge_columns.targets[curr_vertex.out_edges[out_edge_i]]);
+
+	return answer;
+}
+
+
+
+template <typename Real>
+typename rwe::MetricGraph<Real>::Edge rwe::MetricGraph<Real>::getEdge(uint32_t const out_vertex, uint32_t const in_vertex, bool const is_directed, bool const strict_mode) const
+{
+	uint32_t const  out_vertex_new      = (is_directed) ? (out_vertex) : (std::min(out_vertex, in_vertex));
+	uint32_t const  in_vertex_new       = (is_directed) ? (in_vertex)  : (std::max(out_vertex, in_vertex));
+	auto            out_vertex_i        = this->vertex_index.find(out_vertex_new);
+	auto            in_vertex_i         = this->vertex_index.find(in_vertex_new);
+
+	// 1. If any of the vertices is absent, there is no edge
+	if ((out_vertex_i == this->vertex_index.end()) || (in_vertex_i == this->vertex_index.end()))
+		return std::make_pair(this->edges.size(), 0);
+
+	// 2. Try to find a direct match: <out_vertex_new> ---> <in_vertex_new>
+	VertexView const   &out_view        = this->edges[out_vertex_i->second];
+	uint32_t const      in_position     = this->findOutEdge(out_view, in_vertex_new);
+
+	if ((in_position != out_view.out_edges.size()) && (this->edge_columns.targets[out_view.out_edges[in_position]] == in_vertex_new))
+	{
+		if ((strict_mode) && (this->isDirected(out_view.out_edges[in_position]) != is_directed))
+			return std::make_pair(this->edges.size(), 0);
+		return std::make_pair(out_vertex_i->second, in_position);
+	}
+
+	// 3. If this is NOT a strict mode and the edge is directed, we may try to find <in_vertex_new> ---- <out_vertex_new>
+	if ((!strict_mode) && (is_directed) && (in_vertex_new < out_vertex_new))
+	{
+		VertexView const   &in_view         = this->edges[in_vertex_i->second];
+		uint32_t const      out_position    = this->findOutEdge(in_view, out_vertex_new);
+
+		if ((out_position != in_view.out_edges.size()) && (this->edge_columns.targets[in_view.out_edges[out_position]] == out_vertex_new) && (!this->isDirected(in_view.out_edges[out_position])))
+			return std::make_pair(in_vertex_i->second, out_position);
+	}
+
+	// 4. Otherwise, such edge doesn't exist
+	return std::make_pair(this->edges.size(), 0);
+}
+
+
+
+template <typename Real>
+uint32_t const rwe::MetricGraph<Real>::findOutEdge(VertexView const &out_view, uint32_t const in_vertex) const
+{
+	auto comparator = [this](uint64_t const edge, uint32_t const value){return this->edge_columns.targets[edge] < value;};
+
+	return std::distance(out_view.out_edges.begin(), std::lower_bound(out_view.out_edges.begin(), out_view.out_edges.end(), in_vertex, comparator));
+}
+
+
+
+template <typename Real>
+uint32_t const rwe::MetricGraph<Real>::findInEdge(VertexView const &in_view, uint32_t const out_vertex) const
+{
+	auto comparator = [this](uint64_t const edge, uint32_t const value){return this->edge_columns.sources[edge] < value;};
+
+	return std::distance(in_view.in_edges.begin(), std::lower_bound(in_view.in_edges.begin(), in_view.in_edges.end(), out_vertex, comparator));
+}
+
+
+
+template <typename Real>
+bool const rwe::MetricGraph<Real>::isDirected(uint64_t const edge) const
+{
+	return (this->edge_columns.directions[edge / 64] >> (edge % 64)) & 1;
+}
+
+
+
+template <typename Real>
+std::vector<uint32_t> const rwe::MetricGraph<Real>::getSortedIndices(void) const
+{
+	std::vector<uint32_t>   indices(this->edges.size());
+	auto const              comparator  = [this](uint32_t const vertex_1, uint32_t const vertex_2){return this->edges[vertex_1].id < this->edges[vertex_2].id;};
+
+	// Dense indices follow the ascending order of IDs unless vertices have been added one by one
+	std::iota(indices.begin(), indices.end(), 0);
+	if (!std::is_sorted(indices.begin(), indices.end(), comparator))
+		std::sort(indices.begin(), indices.end(), comparator);
+
+	return indices;
+}
+
+
+
+
+
+// Modifiers
+
+
+
+
+
+template <typename Real>
+void rwe::MetricGraph<Real>::updateEdge(uint32_t const out_vertex, uint32_t const in_vertex, Real const length, bool const is_directed)
+{
+	// 1. <length> must be positive
+	if (length <= 0)
+		throw std::invalid_argument("Desired length of an edge must be a positive number.");
+
+	uint32_t const  out_vertex_new  = (is_directed) ? (out_vertex) : (std::min(out_vertex, in_vertex));
+	uint32_t const  in_vertex_new   = (is_directed) ? (in_vertex)  : (std::max(out_vertex, in_vertex));
+	Edge            existing_edge   = this->getEdge(out_vertex_new, in_vertex_new, is_directed);
+
+	if (existing_edge.first == this->edges.size())
+		existing_edge = this->getEdge(in_vertex_new, out_vertex_new);
+
+	// 2. If there is no edge like this, we just add a new edge to the columns
+	if (existing_edge.first == this->edges.size())
+	{
+		for (uint32_t wander_i = 0; wander_i < this->associated_wanders.size(); ++wander_i)
+			this->associated_wanders[wander_i]->invalidate();
+		this->addVertex(in_vertex_new);
+		this->addVertex(out_vertex_new);
+		this->insertEdge(out_vertex_new, in_vertex_new, length, is_directed);
+		return;
+	}
+
+	// 3. If there is an edge like this, we need to check how strict the match is:
+	//        - if new edge is <out_vertex_new> ---> <in_vertex_new> but existing is <out_vertex_new> ---> <in_vertex_new>,
+	//          we only need to update the length
+	//        - if new edge is <out_vertex_new> ---> <in_vertex_new> but existing is <out_vertex_new> <--- <in_vertex_new>,
+	//          we need to replace it with a single undirected edge <out_vertex_new> ---- <in_vertex_new>
+	//        - if new edge is <out_vertex_new> ---> <in_vertex_new> but existing is <out_vertex_new> ---- <in_vertex_new>,
+	//          we only need to update the length
+	//        - if new edge is <out_vertex_new> ---- <in_vertex_new> but existing is <out_vertex_new> <--- <in_vertex_new> or <out_vertex_new> ---> <in_vertex_new>,
+	//          we need to replace it with a single undirected edge <out_vertex_new> ---- <in_vertex_new>
+	//        - if new edge is <out_vertex_new> ---- <in_vertex_new> but existing is <out_vertex_new> ---- <in_vertex_new>,
+	//          we only need to update the length
+	VertexView const   &existing_view   = this->edges[existing_edge.first];
+	uint64_t const      edge            = existing_view.out_edges[existing_edge.second];
+
+	// 3.1. If only the length changes, associated wanders only need to know which edge it was
+	if ((!this->isDirected(edge)) || ((existing_view.id == out_vertex_new) && (is_directed)))
+	{
+		this->edge_columns.lengths[edge] = length;
+		for (uint32_t wander_i = 0; wander_i < this->associated_wanders.size(); ++wander_i)
+			this->associated_wanders[wander_i]->invalidateEdge(edge);
+		return;
+	}
+
+	// 3.2. Otherwise, the edge becomes undirected and associated wanders have to recompile the graph
+	for (uint32_t wander_i = 0; wander_i < this->associated_wanders.size(); ++wander_i)
+		this->associated_wanders[wander_i]->invalidate();
+	if (existing_view.id <= out_vertex_new)
+	{
+		this->edge_columns.lengths[edge] = length;
+		this->setDirected(edge, false);
+		return;
+	}
+	this->eraseEdge(edge);
+	this->updateEdge(out_vertex_new, in_vertex_new, length, false);
+	
+	return;
+}
+
+
+
+template <typename Real>
+uint32_t rwe::MetricGraph<Real>::addVertex(uint32_t const vertex)
+{
+	auto        vertex_i            = this->vertex_index.find(vertex);
+
+	// 1. If <vertex> is already present, just return its dense index
+	if (vertex_i != this->vertex_index.end())
+		return vertex_i->second;
+
+	// 2. Otherwise, append an empty neighbourhood; dense indices of other vertices stay as they are
+	this->edges.push_back({vertex, EdgeIDList(), EdgeIDList()});
+	this->vertex_index[vertex] = this->edges.size() - 1;
+
+	return this->edges.size() - 1;
+}
+
+
+
+template <typename Real>
+void rwe::MetricGraph<Real>::insertEdge(uint32_t const out_vertex, uint32_t const in_vertex, Real const length, bool const is_directed)
+{
+	uint64_t const edge = this->edge_columns.lengths.size();
+
+	// 1. Append the attributes of the new edge to the columns
+	this->edge_columns.sources.push_back(out_vertex);
+	this->edge_columns.targets.push_back(in_vertex);
+	this->edge_columns.lengths.push_back(length);
+	if (edge % 64 == 0)
+		this->edge_columns.directions.push_back(0);
+	this->setDirected(edge, is_directed);
+
+	// 2. Register the new edge in the neighbourhoods of both end points
+	VertexView &out_view = this->edges[this->vertex_index.at(out_vertex)];
+	out_view.out_edges.insert(out_view.out_edges.begin() + this->findOutEdge(out_view, in_vertex), edge);
+
+	VertexView &in_view = this->edges[this->vertex_index.at(in_vertex)];
+	in_view.in_edges.insert(in_view.in_edges.begin() + this->findInEdge(in_view, out_vertex), edge);
+
+	return;
+}
+
+
+
+template <typename Real>
+void rwe::MetricGraph<Real>::eraseEdge(uint64_t const edge)
+{
+	uint64_t const  last_edge       = this->edge_columns.lengths.size() - 1;
+	VertexView     &out_view        = this->edges[this->vertex_index.at(this->edge_columns.sources[edge])];
+	VertexView     &in_view         = this->edges[this->vertex_index.at(this->edge_columns.targets[edge])];
+
+	// 1. Remove the edge from the neighbourhoods of both end points
+	out_view.out_edges.erase(out_view.out_edges.begin() + this->findOutEdge(out_view, this->edge_columns.targets[edge]));
+	in_view.in_edges.erase(in_view.in_edges.begin() + this->findInEdge(in_view, this->edge_columns.sources[edge]));
+
+	// 2. Move the last edge into the freed slot, so that the columns stay contiguous
+	if (edge != last_edge)
+	{
+		VertexView &last_out_view = this->edges[this->vertex_index.at(this->edge_columns.sources[last_edge])];
+		VertexView &last_in_view = this->edges[this->vertex_index.at(this->edge_columns.targets[last_edge])];
+
+		last_out_view.out_edges[this->findOutEdge(last_out_view, this->edge_columns.targets[last_edge])] = edge;
+		last_in_view.in_edges[this->findInEdge(last_in_view, this->edge_columns.sources[last_edge])] = edge;
+		this->edge_columns.sources[edge] = this->edge_columns.sources[last_edge];
+		this->edge_columns.targets[edge] = this->edge_columns.targets[last_edge];
+		this->edge_columns.lengths[edge] = this->edge_columns.lengths[last_edge];
+		this->setDirected(edge, this->isDirected(last_edge));
+	}
+
+	// 3. Drop the last slot of each column
+	this->edge_columns.sources.pop_back();
+	this->edge_columns.targets.pop_back();
+	this->edge_columns.lengths.pop_back();
+	this->setDirected(last_edge, false);
+	if (last_edge % 64 == 0)
+		this->edge_columns.directions.pop_back();
+
+	return;
+}
+
+
+
+template <typename Real>
+void rwe::MetricGraph<Real>::setDirected(uint64_t const edge, bool const is_directed)
+{
+	if (is_directed)
+		this->edge_columns.directions[edge / 64] |= uint64_t(1) << (edge % 64);
+	else
+		this->edge_columns.directions[edge / 64] &= ~(uint64_t(1) << (edge % 64));
+
+	return;
+}
+
+
+
+
+
+
+// Save/load
+
+
+
+
+
+template <typename Real>
+void rwe::MetricGraph<Real>::toGEXF(std::string const file_name, bool const rewrite) const
+{
+	std::string const                   file_format         = ".gexf";
+	uint64_t const                      max_line_size       = 96 + 2 * max_number_length;
+	uint64_t const                      lines_per_block     = 1 << 14;
+	uint32_t const                      buffer_count        = std::max<uint32_t>(std::thread::hardware_concurrency(), 1);
+	std::string                         full_file_name;
+	std::fstream                        out_file;
+
+	std::vector<uint32_t> const         sorted_indices      = this->getSortedIndices();
+	uint64_t                            edge_count          = 0;
+	std::vector<uint32_t>               block_begins(1, 0);
+	std::vector<uint64_t>               block_edge_ids(1, 0);
+	std::vector<std::vector<char>>      buffers(buffer_count);
+	std::vector<uint64_t>               buffer_sizes(buffer_count, 0);
+	auto const                          format_block        = [this, &sorted_indices, &block_begins, &block_edge_ids, &buffers, &buffer_sizes](uint32_t const block_i, uint32_t const buffer_i)
+	                                                          {
+	                                                              char       *position    = buffers[buffer_i].data();
+	                                                              uint64_t    edge_id     = block_edge_ids[block_i];
+
+	                                                              for (uint32_t vertex_1 = block_begins[block_i]; vertex_1 < block_begins[block_i + 1]; ++vertex_1)
+	                                                              {
+	                                                                  VertexView const &curr_vertex = this->edges[sorted_indices[vertex_1]];
+	                                                                  for (uint32_t vertex_2 = 0; vertex_2 < curr_vertex.out_edges.size(); ++vertex_2)
+	                                                                  {
+	                                                                      uint64_t const edge = curr_vertex.out_edges[vertex_2];
+	                                                                      position = appendText(position, "\t\t\t<edge id=\"");
+	                                                                      position = formatInteger(position, edge_id++);
+	                                                                      position = appendText(position, "\" source=\"");
+	                                                                      position = formatInteger(position, curr_vertex.id);
+	                                                                      position = appendText(position, "\" target=\"");
+	                                                                      position = formatInteger(position, this->edge_columns.targets[edge]);
+	                                                                      if (this->isDirected(edge))
+	                                                                          position = appendText(position, "\" type=\"directed\" weight=\"");
+	                                                                      else
+	                                                                          position = appendText(position, "\" type=\"undirected\" weight=\"");
+	                                                                      position = formatReal(position, this->edge_columns.lengths[edge]);
+	                                                                      position = appendText(position, "\" />\n");
+	                                                                  }
+	                                                              }
+	                                                              buffer_sizes[buffer_i] = position - buffers[buffer_i].data();
+	                                                          };
+
+	// 1. Check if specified file already exists
+	full_file_name = findFileName(file_name, file_format, rewrite);
+
+	// 2. Dump information about graph into this file
+	out_file.open(full_file_name, std::fstream::out);
+	out_file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+	out_file << "<gexf xmlns=\"http://www.gexf.net/1.2draft\" xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" xsi:schemaLocation=\"http://www.gexf.net/1.2draft http://www.gexf.net/1.2draft/gexf.xsd\" version=\"1.2\">\n";
+	out_file << "\t<meta>\n";
+	out_file << "\t\t<creator>Random Walks Emulator v.0.2 by Andrei Eliseev (JointPoints, https://jointpoints.github.io/random-walks/)</creator>\n";
+	out_file << "\t</meta>\n";
+	out_file << "\t<graph>\n";
+
+	// 2.1. Vertices are formatted into a reusable buffer which is flushed block by block
+	out_file << "\t\t<nodes>\n";
+	buffers[0].resize(lines_per_block * max_line_size);
+	for (uint32_t vertex_1 = 0; vertex_1 < this->edges.size(); vertex_1 += lines_per_block)
+	{
+		char *position = buffers[0].data();
+
+		for (uint32_t vertex_2 = vertex_1; vertex_2 < std::min<uint64_t>(vertex_1 + lines_per_block, this->edges.size()); ++vertex_2)
+		{
+			position = appendText(position, "\t\t\t<node id=\"");
+			position = formatInteger(position, this->edges[sorted_indices[vertex_2]].id);
+			position = appendText(position, "\" />\n");
+		}
+		out_file.write(buffers[0].data(), position - buffers[0].data());
+	}
+	out_file << "\t\t</nodes>\n";
+
+	// 2.2. Edges are split into blocks of whole rows, and each round formats as many blocks in parallel as there are
+	//      buffers, which are then written in order
+	out_file << "\t\t<edges>\n";
+	for (uint32_t vertex_1 = 0; vertex_1 < this->edges.size(); ++vertex_1)
+	{
+		edge_count += this->edges[sorted_indices[vertex_1]].out_edges.size();
+		if ((edge_count - block_edge_ids.back() >= lines_per_block) || (vertex_1 + 1 == this->edges.size()))
+		{
+			block_begins.push_back(vertex_1 + 1);
+			block_edge_ids.push_back(edge_count);
+		}
+	}
+	for (uint32_t first_block = 0; first_block + 1 < block_begins.size(); first_block += buffer_count)
+	{
+		uint32_t const round_size = std::min<uint64_t>(buffer_count, block_begins.size() - 1 - first_block);
+
+		for (uint32_t buffer_i = 0; buffer_i < round_size; ++buffer_i)
+			buffers[buffer_i].resize(std::max<uint64_t>(buffers[buffer_i].size(), (block_edge_ids[first_block + buffer_i + 1] - block_edge_ids[first_block + buffer_i]) * max_line_size));
+		runChunks(round_size, [&format_block, first_block](uint32_t const buffer_i) {format_block(first_block + buffer_i, buffer_i);});
+		for (uint32_t buffer_i = 0; buffer_i < round_size; ++buffer_i)
+			out_file.write(buffers[buffer_i].data(), buffer_sizes[buffer_i]);
+	}
+	out_file << "\t\t</edges>\n";
+	out_file << "\t</graph>\n";
+	out_file << "</gexf>\n";
+	out_file.close();
+	
+	return;
+}
+
+
+
+template <typename Real>
+void rwe::MetricGraph<Real>::fromGEXF(std::string const file_name)
+{
+	std::string const                       file_format         = ".gexf";
+	uint64_t const                          min_chunk_size      = 1 << 20;
+	MappedFile                              mapped_file(((file_name.size() >= file_format.size()) && (file_name.substr(file_name.size() - file_format.size()) == file_format)) ? (file_name) : (file_name + file_format));
+	char const                             *file_end            = mapped_file.getData() + mapped_file.getSize();
+	GEXFParser<Real>                        prologue_parser(PROLOGUE, false);
+	char const                             *edges_begin         = nullptr;
+	std::vector<GEXFParser<Real>>           parsers;
+
+	// 1. Open file and find the beginning of the "edges" section and the default edge type before it
+	if (!mapped_file.isOpen())
+		return;
+	edges_begin = prologue_parser.parse(mapped_file.getData(), file_end);
+	if (prologue_parser.getState() == DEFAULT_TYPE_VALUE)
+		throw std::runtime_error("Unable to find out the default edge type.");
+	if (prologue_parser.getState() != EDGE_BEGIN)
+		return;
+
+	// 2. Split the "edges" section at the beginnings of edges and parse the chunks in parallel; each chunk begins the same
+	//    way the previous one ends, unless the file is malformed there, in which case the section is parsed once again
+	//    in a single pass to reproduce the exact behaviour
+	if (!parseGEXFChunks(edges_begin, file_end, file_end, min_chunk_size, prologue_parser.getDefaultIsDirected(), parsers))
+	{
+		GEXFParser<Real> section_parser(EDGE_BEGIN, prologue_parser.getDefaultIsDirected());
+
+		section_parser.parse(edges_begin, file_end);
+		if (section_parser.getState() == EPILOGUE)
+			section_parser.getBuilder().build(*this);
+		return;
+	}
+
+	// 3. Chunks are joined in the order of the file; if the "edges" section is incomplete, the original data is left
+	//    unchanged
+	if (parsers.back().getState() != EPILOGUE)
+		return;
+	for (uint32_t chunk_i = 1; chunk_i < parsers.size(); ++chunk_i)
+		parsers[0].getBuilder().append(std::move(parsers[chunk_i].getBuilder()));
+	parsers[0].getBuilder().build(*this);
+
+	return;
+}
+
+
+
+template <typename Real>
+void rwe::MetricGraph<Real>::toRWEG(std::string const file_name, bool const rewrite) const
+{
+	std::string const   file_format     = ".rweg";
+	std::string         full_file_name;
+	std::fstream        out_file;
+	std::vector<uint32_t>   vertex_ids;
+	std::vector<uint64_t>   offsets;
+	std::vector<uint32_t>   targets;
+	std::vector<double>     lengths;
+	std::vector<uint64_t>   directions;
+
+	// 1. Check if specified file already exists
+	full_file_name = findFileName(file_name, file_format, rewrite);
+
+	// 2. Lay the graph out in CSR form
+	this->layOutCSR(vertex_ids, offsets, targets, lengths, directions);
+
+	// 3. Dump it into this file
+	out_file.open(full_file_name, std::fstream::out | std::fstream::binary);
+	RWEGFile::write(out_file, vertex_ids.size(), targets.size(), vertex_ids.data(), offsets.data(), targets.data(), lengths.data(), directions.data());
+	out_file.close();
+	
+	return;
+}
+
+
+
+template <typename Real>
+void rwe::MetricGraph<Real>::fromRWEG(std::string const file_name)
+{
+	std::string const                       file_format         = ".rweg";
+	uint64_t const                          record_size         = 2 * sizeof(uint32_t) + sizeof(long double) + sizeof(bool);
+	uint64_t const                          records_per_thread  = 1 << 16;
+	std::string const                       full_file_name      = ((file_name.size() >= file_format.size()) && (file_name.substr(file_name.size() - file_format.size()) == file_format)) ? (file_name) : (file_name + file_format);
+	MappedFile                              mapped_file(full_file_name);
+	uint64_t const                          record_count        = mapped_file.getSize() / record_size;
+	uint32_t const                          chunk_count         = std::max<uint64_t>(std::min<uint64_t>(std::thread::hardware_concurrency(), record_count / records_per_thread), 1);
+	std::vector<MetricGraphBuilder<Real>>   builders(chunk_count);
+	std::vector<std::exception_ptr>         errors(chunk_count);
+	auto const                              parse_chunk         = [&mapped_file, record_count, chunk_count, &builders, &errors](uint32_t const chunk_i)
+	                                                              {
+	                                                                  uint64_t const  first_record    = record_count * chunk_i / chunk_count;
+	                                                                  uint64_t const  last_record     = record_count * (chunk_i + 1) / chunk_count;
+	                                                                  uint32_t        out_vertex(0), in_vertex(0);
+	                                                                  long double     length(0.0);
+	                                                                  uint8_t         is_directed(0);
+
+	                                                                  try
+	                                                                  {
+	                                                                      builders[chunk_i].reserve(last_record - first_record);
+	                                                                      for (char const *record = mapped_file.getData() + first_record * record_size; record != mapped_file.getData() + last_record * record_size; record += record_size)
+	                                                                      {
+	                                                                          std::memcpy(&out_vertex, record, sizeof(out_vertex));
+	                                                                          std::memcpy(&in_vertex, record + sizeof(out_vertex), sizeof(in_vertex));
+	                                                                          std::memcpy(&length, record + sizeof(out_vertex) + sizeof(in_vertex), sizeof(length));
+	                                                                          std::memcpy(&is_directed, record + sizeof(out_vertex) + sizeof(in_vertex) + sizeof(length), sizeof(is_directed));
+	                                                                          builders[chunk_i].addEdge(out_vertex, in_vertex, length, is_directed != 0);
+	                                                                      }
+	                                                                  }
+	                                                                  catch (...)
+	                                                                  {
+	                                                                      errors[chunk_i] = std::current_exception();
+	                                                                  }
+	                                                              };
+
+	// 1. Files of version 2 are used right from the mapping
+	if (RWEGFile::checkSignature(mapped_file.getData(), mapped_file.getSize()))
+	{
+		RWEGFile const rweg_file(std::move(mapped_file));
+
+		this->loadCSR(rweg_file.getVertexCount(), rweg_file.getEdgeCount(), rweg_file.getVertexIDs(), rweg_file.getOffsets(), rweg_file.getTargets(), rweg_file.getLengths(), rweg_file.getDirections());
+		return;
+	}
+
+	// 2. Files of version 1 are sequences of records of the same size, the number of records follows from the size of the file
+	if (!mapped_file.isOpen())
+		return;
+	if (mapped_file.getSize() % record_size != 0)
+		throw std::runtime_error("The size of the rweg file is not a multiple of the size of its records.");
+
+	// 3. Each chunk of records is parsed into its own builder
+	runChunks(chunk_count, parse_chunk);
+
+	// 4. Chunks are joined in the order of the file, so that repeated records are folded the same way as before
+	for (uint32_t chunk_i = 0; chunk_i < chunk_count; ++chunk_i)
+		if (errors[chunk_i])
+			std::rethrow_exception(errors[chunk_i]);
+	builders[0].reserve(record_count);
+	for (uint32_t chunk_i = 1; chunk_i < chunk_count; ++chunk_i)
+		builders[0].append(std::move(builders[chunk_i]));
+	builders[0].build(*this);
+
+	return;
+}
+
+
+
+template <typename Real>
+std::string const rwe::MetricGraph<Real>::toRWEGZ(std::string const file_name, bool const rewrite) const
+{
+	std::string const   file_format     = ".rwegz";
+	std::string         full_file_name;
+	std::fstream        out_file;
+	std::vector<uint32_t>   vertex_ids;
+	std::vector<uint64_t>   offsets;
+	std::vector<uint32_t>   targets;
+	std::vector<double>     lengths;
+	std::vector<uint64_t>   directions;
+
+	// 1. Check if specified file already exists
+	full_file_name = findFileName(file_name, file_format, rewrite);
+
+	// 2. Lay the graph out in CSR form and compress it into this file
+	this->layOutCSR(vertex_ids, offsets, targets, lengths, directions);
+	out_file.open(full_file_name, std::fstream::out | std::fstream::binary);
+	RWEGZFile::write(out_file, vertex_ids.size(), targets.size(), vertex_ids.data(), offsets.data(), targets.data(), lengths.data(), directions.data());
+	out_file.close();
+
+	return full_file_name;
+}
+
+
+
+template <typename Real>
+void rwe::MetricGraph<Real>::fromRWEGZ(std::string const file_name)
+{
+	std::string const       file_format     = ".rwegz";
+	std::string const       full_file_name  = ((file_name.size() >= file_format.size()) && (file_name.substr(file_name.size() - file_format.size()) == file_format)) ? (file_name) : (file_name + file_format);
+	RWEGZFile const         rwegz_file(full_file_name);
+	std::vector<uint32_t>   vertex_ids;
+	std::vector<uint64_t>   offsets;
+	std::vector<uint32_t>   targets;
+	std::vector<double>     lengths;
+	std::vector<uint64_t>   directions;
+
+	if (!rwegz_file.isOpen())
+		return;
+
+	// 1. Blocks are decoded in parallel into the same sections as the ones of rweg files of version 2
+	vertex_ids.resize(rwegz_file.getVertexCount());
+	offsets.resize(rwegz_file.getVertexCount() + uint64_t(1));
+	targets.resize(rwegz_file.getEdgeCount());
+	lengths.resize(rwegz_file.getEdgeCount());
+	directions.resize((rwegz_file.getEdgeCount() + 63) / 64);
+	rwegz_file.decode(vertex_ids.data(), offsets.data(), targets.data(), lengths.data(), directions.data());
+
+	// 2. Then they are loaded the same way
+	this->loadCSR(vertex_ids.size(), targets.size(), vertex_ids.data(), offsets.data(), targets.data(), lengths.data(), directions.data());
+
+	return;
+}
+
+
+
+template <typename Real>
+void rwe::MetricGraph<Real>::fromEdgeList(std::string const file_name)
+{
+	uint64_t const                  min_chunk_size      = 1 << 20;
+	MappedFile                      mapped_file(file_name);
+	MetricGraphBuilder<Real>        builder;
+	auto const                      parse_chunk         = [](uint32_t const chunk_i, char const *chunk_begin, char const *chunk_end, MetricGraphBuilder<Real> &chunk_builder)
+	                                                      {
+	                                                          char const     *next_line       = nullptr;
+	                                                          char const     *token_begins[5];
+	                                                          char const     *token_ends[5];
+	                                                          uint64_t        vertices[2];
+	                                                          long double     length(0.0);
+	                                                          bool            is_directed(false);
+
+	                                                          for (char const *line_begin = chunk_begin; line_begin != chunk_end; line_begin = next_line)
+	                                                          {
+	                                                              char const     *line_end        = findLineEnd(line_begin, chunk_end, next_line);
+	                                                              char const     *position        = line_begin;
+	                                                              uint32_t        token_count     = 0;
+
+	                                                              // 1. Empty lines and comments are skipped
+	                                                              while ((token_count < 5) && (nextToken(position, line_end, token_begins[token_count], token_ends[token_count])))
+	                                                                  ++token_count;
+	                                                              if ((token_count == 0) || (*token_begins[0] == '#') || (*token_begins[0] == '%'))
+	                                                                  continue;
+	                                                              if ((token_count < 3) || (token_count > 4))
+	                                                                  throw std::runtime_error("Each line of the edge list must contain the source, the target, the length and, optionally, the type of an edge.");
+
+	                                                              // 2. Parse the edge
+	                                                              for (uint32_t vertex_i = 0; vertex_i < 2; ++vertex_i)
+	                                                                  if ((!parseUnsigned(token_begins[vertex_i], token_ends[vertex_i], vertices[vertex_i])) || (vertices[vertex_i] > std::numeric_limits<uint32_t>::max()))
+	                                                                      throw std::runtime_error("Vertex ID '" + std::string(token_begins[vertex_i], token_ends[vertex_i]) + "' do not comply with the requirements of emulator.");
+	                                                              if (!parseReal(token_begins[2], token_ends[2], length))
+	                                                                  throw std::runtime_error("Unable to interpret length value '" + std::string(token_begins[2], token_ends[2]) + "'.");
+	                                                              is_directed = false;
+	                                                              if (token_count == 4)
+	                                                              {
+	                                                                  if ((isToken(token_begins[3], token_ends[3], "1")) || (isToken(token_begins[3], token_ends[3], "directed")))
+	                                                                      is_directed = true;
+	                                                                  else
+	                                                                      if ((!isToken(token_begins[3], token_ends[3], "0")) && (!isToken(token_begins[3], token_ends[3], "undirected")) && (!isToken(token_begins[3], token_ends[3], "mutual")))
+	                                                                          throw std::runtime_error("Unknown type of the edge '" + std::string(token_begins[3], token_ends[3]) + "'.");
+	                                                              }
+	                                                              chunk_builder.addEdge(vertices[0], vertices[1], length, is_directed);
+	                                                          }
+	                                                      };
+
+	// 1. Open file
+	if (!mapped_file.isOpen())
+		return;
+
+	// 2. Parse chunks of whole lines in parallel and merge all edges into the graph at once
+	parseChunks(splitText(mapped_file.getData(), mapped_file.getData() + mapped_file.getSize(), min_chunk_size, isLineBegin), parse_chunk, builder);
+	builder.build(*this);
+
+	return;
+}
+
+
+
+template <typename Real>
+void rwe::MetricGraph<Real>::fromMatrixMarket(std::string const file_name)
+{
+	std::string const               file_format         = ".mtx";
+	uint64_t const                  min_chunk_size      = 1 << 20;
+	MappedFile                      mapped_file(((file_name.size() >= file_format.size()) && (file_name.substr(file_name.size() - file_format.size()) == file_format)) ? (file_name) : (file_name + file_format));
+	char const                     *file_end            = mapped_file.getData() + mapped_file.getSize();
+	char const                     *line_begin          = mapped_file.getData();
+	char const                     *line_end            = nullptr;
+	char const                     *next_line           = nullptr;
+	char const                     *position            = nullptr;
+	char const                     *token_begins[5];
+	char const                     *token_ends[5];
+	uint32_t                        token_count         = 0;
+	bool                            is_pattern          = false;
+	bool                            is_symmetric        = false;
+	uint64_t                        sizes[3]            = {0, 0, 0};
+	std::vector<char const *>       chunk_begins;
+	std::vector<uint64_t>           entry_counts;
+	MetricGraphBuilder<Real>        builder;
+	auto const                      parse_chunk         = [&sizes, &is_pattern, &is_symmetric, &entry_counts](uint32_t const chunk_i, char const *chunk_begin, char const *chunk_end, MetricGraphBuilder<Real> &chunk_builder)
+	                                                      {
+	                                                          char const     *next_line       = nullptr;
+	                                                          char const     *token_begins[4];
+	                                                          char const     *token_ends[4];
+	                                                          uint64_t        indices[2];
+	                                                          long double     length(1.0);
+
+	                                                          for (char const *line_begin = chunk_begin; line_begin != chunk_end; line_begin = next_line)
+	                                                          {
+	                                                              char const     *line_end        = findLineEnd(line_begin, chunk_end, next_line);
+	                                                              char const     *position        = line_begin;
+	                                                              uint32_t        token_count     = 0;
+
+	                                                              // 1. Empty lines and comments are skipped
+	                                                              while ((token_count < 4) && (nextToken(position, line_end, token_begins[token_count], token_ends[token_count])))
+	                                                                  ++token_count;
+	                                                              if ((token_count == 0) || (*token_begins[0] == '%'))
+	                                                                  continue;
+	                                                              if (token_count != ((is_pattern) ? (2) : (3)))
+	                                                                  throw std::runtime_error("Each entry of the matrix must contain the row, the column and, unless the matrix is a pattern, the value.");
+
+	                                                              // 2. Row i and column j are 1-based and stand for edge i-1 -> j-1
+	                                                              for (uint32_t index_i = 0; index_i < 2; ++index_i)
+	                                                                  if ((!parseUnsigned(token_begins[index_i], token_ends[index_i], indices[index_i])) || (indices[index_i] == 0) || (indices[index_i] > sizes[index_i]))
+	                                                                      throw std::runtime_error("Index '" + std::string(token_begins[index_i], token_ends[index_i]) + "' of a matrix entry is out of range.");
+	                                                              if ((!is_pattern) && (!parseReal(token_begins[2], token_ends[2], length)))
+	                                                                  throw std::runtime_error("Unable to interpret length value '" + std::string(token_begins[2], token_ends[2]) + "'.");
+	                                                              chunk_builder.addEdge(indices[0] - 1, indices[1] - 1, length, !is_symmetric);
+	                                                              ++entry_counts[chunk_i];
+	                                                          }
+	                                                      };
+
+	// 1. Open file and check the banner
+	if (!mapped_file.isOpen())
+		return;
+	line_end = findLineEnd(line_begin, file_end, next_line);
+	position = line_begin;
+	while ((token_count < 5) && (nextToken(position, line_end, token_begins[token_count], token_ends[token_count])))
+		++token_count;
+	if ((token_count != 5) || (!isToken(token_begins[0], token_ends[0], "%%matrixmarket")) || (!isToken(token_begins[1], token_ends[1], "matrix")))
+		throw std::runtime_error("The file does not begin with a valid Matrix Market banner.");
+	if (!isToken(token_begins[2], token_ends[2], "coordinate"))
+		throw std::runtime_error("Only matrices in the coordinate format can be interpreted as metric graphs.");
+	if (isToken(token_begins[3], token_ends[3], "pattern"))
+		is_pattern = true;
+	else
+		if ((!isToken(token_begins[3], token_ends[3], "real")) && (!isToken(token_begins[3], token_ends[3], "double")) && (!isToken(token_begins[3], token_ends[3], "integer")))
+			throw std::runtime_error("Only real, integer and pattern matrices can be interpreted as metric graphs.");
+	if (isToken(token_begins[4], token_ends[4], "symmetric"))
+		is_symmetric = true;
+	else
+		if (!isToken(token_begins[4], token_ends[4], "general"))
+			throw std::runtime_error("Only general and symmetric matrices can be interpreted as metric graphs.");
+
+	// 2. Find the size line after comments
+	for (line_begin = next_line, token_count = 0; line_begin != file_end; line_begin = next_line)
+	{
+		line_end = findLineEnd(line_begin, file_end, next_line);
+		position = line_begin;
+		token_count = 0;
+		while ((token_count < 4) && (nextToken(position, line_end, token_begins[token_count], token_ends[token_count])))
+			++token_count;
+		if ((token_count > 0) && (*token_begins[0] != '%'))
+			break;
+	}
+	if (token_count != 3)
+		throw std::runtime_error("Unable to find out the size of the matrix.");
+	for (uint32_t size_i = 0; size_i < 3; ++size_i)
+		if (!parseUnsigned(token_begins[size_i], token_ends[size_i], sizes[size_i]))
+			throw std::runtime_error("Unable to find out the size of the matrix.");
+	if (sizes[0] != sizes[1])
+		throw std::runtime_error("Only square matrices can be interpreted as metric graphs.");
+	if (sizes[0] > uint64_t(std::numeric_limits<uint32_t>::max()) + 1)
+		throw std::runtime_error("The matrix has more rows than there can be vertices in a metric graph.");
+
+	// 3. Parse chunks of whole lines in parallel and merge all edges into the graph at once
+	chunk_begins = splitText(next_line, file_end, min_chunk_size, isLineBegin);
+	entry_counts.assign(chunk_begins.size() - 1, 0);
+	parseChunks(chunk_begins, parse_chunk, builder);
+	if (std::accumulate(entry_counts.begin(), entry_counts.end(), uint64_t(0)) != sizes[2])
+		throw std::runtime_error("The number of entries does not match the size of the matrix.");
+	builder.build(*this);
+
+	return;
+}
+
+
+
+template <typename Real>
+void rwe::MetricGraph<Real>::fromMETIS(std::string const file_name)
+{
+	std::string const               file_format         = ".graph";
+	uint64_t const                  min_chunk_size      = 1 << 20;
+	MappedFile                      mapped_file(((file_name.size() >= file_format.size()) && (file_name.substr(file_name.size() - file_format.size()) == file_format)) ? (file_name) : (file_name + file_format));
+	char const                     *file_end            = mapped_file.getData() + mapped_file.getSize();
+	char const                     *line_begin          = mapped_file.getData();
+	char const                     *line_end            = nullptr;
+	char const                     *next_line           = nullptr;
+	char const                     *position            = nullptr;
+	char const                     *token_begins[5];
+	char const                     *token_ends[5];
+	uint32_t                        token_count         = 0;
+	uint64_t                        sizes[2]            = {0, 0};
+	uint64_t                        format              = 0;
+	uint64_t                        constraint_count    = 1;
+	uint64_t                        skip_count          = 0;
+	bool                            has_edge_weights    = false;
+	std::vector<char const *>       chunk_begins;
+	std::vector<uint64_t>           first_vertices;
+	std::vector<uint64_t>           edge_counts;
+	MetricGraphBuilder<Real>        builder;
+	auto const                      parse_chunk         = [&sizes, &skip_count, &has_edge_weights, &first_vertices, &edge_counts](uint32_t const chunk_i, char const *chunk_begin, char const *chunk_end, MetricGraphBuilder<Real> &chunk_builder)
+	                                                      {
+	                                                          char const     *next_line       = nullptr;
+	                                                          char const     *token_begin     = nullptr;
+	                                                          char const     *token_end       = nullptr;
+	                                                          uint64_t        vertex          = first_vertices[chunk_i];
+	                                                          uint64_t        neighbour       = 0;
+	                                                          long double     length(1.0);
+
+	                                                          for (char const *line_begin = chunk_begin; line_begin != chunk_end; line_begin = next_line)
+	                                                          {
+	                                                              char const     *line_end        = findLineEnd(line_begin, chunk_end, next_line);
+	                                                              char const     *position        = line_begin;
+
+	                                                              // 1. Comments are skipped, while every other line (even an empty one) describes the next vertex;
+	                                                              //    only empty lines may follow the last vertex
+	                                                              if ((line_begin != line_end) && (*line_begin == '%'))
+	                                                                  continue;
+	                                                              if (vertex > sizes[0])
+	                                                              {
+	                                                                  if (nextToken(position, line_end, token_begin, token_end))
+	                                                                      throw std::runtime_error("The file describes more vertices than the header says.");
+	                                                                  continue;
+	                                                              }
+	                                                              for (uint64_t skip_i = 0; skip_i < skip_count; ++skip_i)
+	                                                                  if (!nextToken(position, line_end, token_begin, token_end))
+	                                                                      throw std::runtime_error("Weights of vertex " + std::to_string(vertex) + " are missing.");
+
+	                                                              // 2. Each undirected edge is listed by both its end points and is taken from the one with the lesser index
+	                                                              while (nextToken(position, line_end, token_begin, token_end))
+	                                                              {
+	                                                                  if ((!parseUnsigned(token_begin, token_end, neighbour)) || (neighbour == 0) || (neighbour > sizes[0]))
+	                                                                      throw std::runtime_error("Neighbour '" + std::string(token_begin, token_end) + "' of vertex " + std::to_string(vertex) + " is out of range.");
+	                                                                  if (has_edge_weights)
+	                                                                  {
+	                                                                      if (!nextToken(position, line_end, token_begin, token_end))
+	                                                                          throw std::runtime_error("Weight of the edge between vertices " + std::to_string(vertex) + " and " + std::to_string(neighbour) + " is missing.");
+	                                                                      if (!parseReal(token_begin, token_end, length))
+	                                                                          throw std::runtime_error("Unable to interpret length value '" + std::string(token_begin, token_end) + "'.");
+	                                                                  }
+	                                                                  if (neighbour > vertex)
+	                                                                  {
+	                                                                      chunk_builder.addEdge(vertex - 1, neighbour - 1, length, false);
+	                                                                      ++edge_counts[chunk_i];
+	                                                                  }
+	                                                              }
+	                                                              ++vertex;
+	                                                          }
+	                                                      };
+
+	// 1. Open file and read the header after comments and empty lines
+	if (!mapped_file.isOpen())
+		return;
+	for (; line_begin != file_end; line_begin = next_line)
+	{
+		line_end = findLineEnd(line_begin, file_end, next_line);
+		if ((line_begin != line_end) && (*line_begin != '%'))
+			break;
+	}
+	position = line_begin;
+	while ((line_begin != file_end) && (token_count < 5) && (nextToken(position, line_end, token_begins[token_count], token_ends[token_count])))
+		++token_count;
+	if ((token_count < 2) || (token_count > 4) || (!parseUnsigned(token_begins[0], token_ends[0], sizes[0])) || (!parseUnsigned(token_begins[1], token_ends[1], sizes[1])))
+		throw std::runtime_error("Unable to find out the number of vertices and edges of the graph.");
+	if (sizes[0] > uint64_t(std::numeric_limits<uint32_t>::max()) + 1)
+		throw std::runtime_error("The graph has more vertices than there can be in a metric graph.");
+
+	// 2. Digits of the format tell whether vertices have sizes and weights and whether edges have weights
+	if ((token_count >= 3) && ((token_ends[2] - token_begins[2] > 3) || (!parseUnsigned(token_begins[2], token_ends[2], format)) || (format % 10 > 1) || (format / 10 % 10 > 1) || (format / 100 > 1)))
+		throw std::runtime_error("Unknown format of the graph '" + std::string(token_begins[2], token_ends[2]) + "'.");
+	if ((token_count == 4) && ((!parseUnsigned(token_begins[3], token_ends[3], constraint_count)) || (constraint_count == 0)))
+		throw std::runtime_error("Unable to interpret the number of vertex weights '" + std::string(token_begins[3], token_ends[3]) + "'.");
+	has_edge_weights = (format % 10 == 1);
+	skip_count = (format / 100) + ((format / 10 % 10 == 1) ? (constraint_count) : (0));
+
+	// 3. Lines are counted in advance, so that each chunk knows the index of its first vertex and every vertex of the
+	//    header is known to have its line
+	chunk_begins = splitText(next_line, file_end, min_chunk_size, isLineBegin);
+	first_vertices.assign(chunk_begins.size(), 1);
+	edge_counts.assign(chunk_begins.size() - 1, 0);
+	for (uint32_t chunk_i = 0; chunk_i + 1 < chunk_begins.size(); ++chunk_i)
+	{
+		first_vertices[chunk_i + 1] = first_vertices[chunk_i];
+		for (line_begin = chunk_begins[chunk_i]; line_begin != chunk_begins[chunk_i + 1]; line_begin = next_line)
+		{
+			line_end = findLineEnd(line_begin, chunk_begins[chunk_i + 1], next_line);
+			first_vertices[chunk_i + 1] += (line_begin == line_end) || (*line_begin != '%');
+		}
+	}
+
+	if (first_vertices.back() - 1 < sizes[0])
+		throw std::runtime_error("The file describes fewer vertices than the header says.");
+
+	// 4. Parse chunks of whole lines in parallel and merge all edges into the graph at once
+	parseChunks(chunk_begins, parse_chunk, builder);
+	if (std::accumulate(edge_counts.begin(), edge_counts.end(), uint64_t(0)) != sizes[1])
+		throw std::runtime_error("The number of edges does not match the header of the file.");
+	builder.build(*this);
+
+	return;
+}
+
+
+
+
+
+// Layout
+
+
+
+
+
+template <typename Real>
+void rwe::MetricGraph<Real>::layOutCSR(std::vector<uint32_t> &vertex_ids, std::vector<uint64_t> &offsets, std::vector<uint32_t> &targets, std::vector<double> &lengths, std::vector<uint64_t> &directions) const
+{
+	std::vector<uint32_t> const sorted_indices  = this->getSortedIndices();
+	std::vector<uint32_t>       vertex_indices(this->edges.size(), std::numeric_limits<uint32_t>::max());
+
+	// 1. Isolated vertices are skipped, the rest get dense indices in the order of IDs
+	vertex_ids.clear();
+	for (uint32_t vertex_1 = 0; vertex_1 < this->edges.size(); ++vertex_1)
+		if ((!this->edges[sorted_indices[vertex_1]].out_edges.empty()) || (!this->edges[sorted_indices[vertex_1]].in_edges.empty()))
+		{
+			vertex_indices[sorted_indices[vertex_1]] = vertex_ids.size();
+			vertex_ids.push_back(this->edges[sorted_indices[vertex_1]].id);
+		}
+
+	// 2. Rows follow the same order, each row is sorted by targets just like the outgoing edges of a vertex
+	offsets.assign(1, 0);
+	targets.clear();
+	lengths.clear();
+	directions.assign((this->getEdgeCount() + 63) / 64, 0);
+	targets.reserve(this->getEdgeCount());
+	lengths.reserve(this->getEdgeCount());
+	for (uint32_t vertex_1 = 0; vertex_1 < this->edges.size(); ++vertex_1)
+	{
+		VertexView const &curr_vertex = this->edges[sorted_indices[vertex_1]];
+		if (vertex_indices[sorted_indices[vertex_1]] == std::numeric_limits<uint32_t>::max())
+			continue;
+		for (uint32_t vertex_2 = 0; vertex_2 < curr_vertex.out_edges.size(); ++vertex_2)
+		{
+			uint64_t const edge = curr_vertex.out_edges[vertex_2];
+			if (this->isDirected(edge))
+				directions[targets.size() / 64] |= uint64_t(1) << (targets.size() % 64);
+			targets.push_back(vertex_indices[this->vertex_index.at(this->edge_columns.targets[edge])]);
+			lengths.push_back(this->edge_columns.lengths[edge]);
+		}
+		offsets.push_back(targets.size());
+	}
+
+	return;
+}
+
+
+
+template <typename Real>
+void rwe::MetricGraph<Real>::loadCSR(uint32_t const vertex_count, uint64_t const edge_count, uint32_t const *vertex_ids, uint64_t const *offsets, uint32_t const *targets, double const *lengths, uint64_t const *directions)
+{
+	// 1. Edges are merged into a non-empty graph the same way as edges of any other file
+	if (!this->edges.empty())
+	{
+		MetricGraphBuilder<Real>    builder;
+
+		builder.reserve(edge_count);
+		for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+			for (uint64_t edge = offsets[vertex_1]; edge < offsets[vertex_1 + 1]; ++edge)
+				builder.addEdge(vertex_ids[vertex_1], vertex_ids[targets[edge]], lengths[edge], (directions[edge / 64] >> (edge % 64)) & 1);
+		builder.build(*this);
+		return;
+	}
+
+	// 2. An empty graph takes the sections as they are, edge IDs follow the order of rows
+	EdgeList        new_edges(vertex_count);
+	EdgeColumns     new_columns;
+	std::vector<uint64_t>   in_degrees(vertex_count, 0);
+
+	new_columns.sources.reserve(edge_count);
+	new_columns.targets.reserve(edge_count);
+	new_columns.lengths.reserve(edge_count);
+	new_columns.directions.assign(directions, directions + (edge_count + 63) / 64);
+	for (uint64_t edge = 0; edge < edge_count; ++edge)
+		++in_degrees[targets[edge]];
+	for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+	{
+		new_edges[vertex_1].id = vertex_ids[vertex_1];
+		new_edges[vertex_1].out_edges.reserve(offsets[vertex_1 + 1] - offsets[vertex_1]);
+		new_edges[vertex_1].in_edges.reserve(in_degrees[vertex_1]);
+	}
+	for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+		for (uint64_t edge = offsets[vertex_1]; edge < offsets[vertex_1 + 1]; ++edge)
+		{
+			Real const length = lengths[edge];
+
+			if (length <= 0)
+				throw std::invalid_argument("Desired length of an edge must be a positive number.");
+			new_edges[vertex_1].out_edges.push_back(edge);
+			new_edges[targets[edge]].in_edges.push_back(edge);
+			new_columns.sources.push_back(vertex_ids[vertex_1]);
+			new_columns.targets.push_back(vertex_ids[targets[edge]]);
+			new_columns.lengths.push_back(length);
+		}
+	this->edges = std::move(new_edges);
+	this->edge_columns = std::move(new_columns);
+	this->vertex_index.reserve(vertex_count);
+	for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+		this->vertex_index[vertex_ids[vertex_1]] = vertex_1;
+	for (uint32_t wander_i = 0; wander_i < this->associated_wanders.size(); ++wander_i)
+		this->associated_wanders[wander_i]->invalidate();
+
+	return;
+}
+
+
+
+
+
+// Builder: constructors and destructors
+
+
+
+
+
+template <typename Real>
+rwe::MetricGraphBuilder<Real>::MetricGraphBuilder(void) :
+	records()
+{
+	// Intended to be empty
+}
+
+
+
+
+
+// Builder: access
+
+
+
+
+
+template <typename Real>
+uint64_t const rwe::MetricGraphBuilder<Real>::getRecordCount(void) const
+{
+	return this->records.size();
+}
+
+
+
+
+
+// Builder: modifiers
+
+
+
+
+
+template <typename Real>
+void rwe::MetricGraphBuilder<Real>::reserve(uint64_t const record_count)
+{
+	this->records.reserve(record_count);
+
+	return;
+}
+
+
+
+template <typename Real>
+void rwe::MetricGraphBuilder<Real>::addEdge(uint32_t const out_vertex, uint32_t const in_vertex, Real const length, bool const is_directed)
+{
+	// 1. <length> must be positive
+	if (length <= 0)
+		throw std::invalid_argument("Desired length of an edge must be a positive number.");
+
+	// 2. Undirected edges are always stored as <min> ---- <max>
+	this->records.push_back(EdgeRecord{(is_directed) ? (out_vertex) : (std::min(out_vertex, in_vertex)), (is_directed) ? (in_vertex) : (std::max(out_vertex, in_vertex)), length, is_directed});
+
+	return;
+}
+
+
+
+template <typename Real>
+void rwe::MetricGraphBuilder<Real>::append(MetricGraphBuilder<Real> &&other)
+{
+	if (this->records.empty())
+		this->records.swap(other.records);
+	else
+		this->records.insert(this->records.end(), other.records.begin(), other.records.end());
+	other.records.clear();
+	other.records.shrink_to_fit();
+
+	return;
+}
+
+
+
+template <typename Real>
+void rwe::MetricGraphBuilder<Real>::build(MetricGraph<Real> &graph)
+{
+	auto                        pair_comparator     = isLessPair<EdgeRecord>;
+	auto                        edge_comparator     = isLessEdge<EdgeRecord>;
+	std::vector<EdgeRecord>     all_records;
+	std::vector<uint32_t>       vertex_ids;
+	typename MetricGraph<Real>::EdgeList    new_edges;
+	typename MetricGraph<Real>::EdgeColumns new_columns;
+	uint64_t                    merged_count        = 0;
+
+	// 1. Existing edges of <graph> go first, pending records follow in the order of their addition
+	all_records.reserve(graph.getEdgeCount() + this->records.size());
+	for (uint32_t vertex_1 = 0; vertex_1 < graph.edges.size(); ++vertex_1)
+	{
+		typename MetricGraph<Real>::VertexView const &curr_vertex = graph.edges[vertex_1];
+		vertex_ids.push_back(curr_vertex.id);
+		for (uint32_t vertex_2 = 0; vertex_2 < curr_vertex.out_edges.size(); ++vertex_2)
+		{
+			uint64_t const edge = curr_vertex.out_edges[vertex_2];
+			all_records.push_back(EdgeRecord{curr_vertex.id, graph.edge_columns.targets[edge], graph.edge_columns.lengths[edge], graph.isDirected(edge)});
+		}
+	}
+	all_records.insert(all_records.end(), this->records.begin(), this->records.end());
+	this->records.clear();
+	this->records.shrink_to_fit();
+
+	// 2. Group records by unordered pairs of vertices without changing their relative order
+	std::stable_sort(all_records.begin(), all_records.end(), pair_comparator);
+
+	// 3. Fold each group the same way consecutive calls of "updateEdge" would do (see "foldRecord")
+	merged_count = 0;
+	for (uint64_t record_i = 0; record_i < all_records.size(); ++record_i)
+	{
+		EdgeRecord const &curr_record = all_records[record_i];
+
+		if ((record_i == 0) || (pair_comparator(all_records[merged_count - 1], curr_record)))
+			all_records[merged_count++] = curr_record;
+		else
+			foldRecord(all_records[merged_count - 1], curr_record);
+	}
+	all_records.resize(merged_count);
+
+	// 4. Lay the merged edges out in the order of MetricGraph, edge IDs follow the same order
+	std::sort(all_records.begin(), all_records.end(), edge_comparator);
+	for (uint64_t record_i = 0; record_i < all_records.size(); ++record_i)
+	{
+		vertex_ids.push_back(all_records[record_i].out_vertex);
+		vertex_ids.push_back(all_records[record_i].in_vertex);
+	}
+	std::sort(vertex_ids.begin(), vertex_ids.end());
+	vertex_ids.erase(std::unique(vertex_ids.begin(), vertex_ids.end()), vertex_ids.end());
+	new_edges.resize(vertex_ids.size());
+	new_columns.sources.reserve(all_records.size());
+	new_columns.targets.reserve(all_records.size());
+	new_columns.lengths.reserve(all_records.size());
+	new_columns.directions.assign((all_records.size() + 63) / 64, 0);
+	for (uint64_t vertex_1 = 0, record_i = 0; vertex_1 < vertex_ids.size(); ++vertex_1)
+	{
+		typename MetricGraph<Real>::VertexView &curr_vertex = new_edges[vertex_1];
+		uint64_t                 row_end     = record_i;
+
+		while ((row_end < all_records.size()) && (all_records[row_end].out_vertex == vertex_ids[vertex_1]))
+			++row_end;
+		curr_vertex.id = vertex_ids[vertex_1];
+		curr_vertex.out_edges.reserve(row_end - record_i);
+		for (; record_i < row_end; ++record_i)
+		{
+			curr_vertex.out_edges.push_back(record_i);
+			new_columns.sources.push_back(all_records[record_i].out_vertex);
+			new_columns.targets.push_back(all_records[record_i].in_vertex);
+			new_columns.lengths.push_back(all_records[record_i].length);
+			if (all_records[record_i].is_directed)
+				new_columns.directions[record_i / 64] |= uint64_t(1) << (record_i % 64);
+		}
+	}
+
+	// 5. Replace contents of <graph> and rebuild its vertex index
+	graph.edges = std::move(new_edges);
+	graph.edge_columns = std::move(new_columns);
+	graph.vertex_index.clear();
+	graph.vertex_index.reserve(graph.edges.size());
+	for (uint32_t vertex_1 = 0; vertex_1 < graph.edges.size(); ++vertex_1)
+		graph.vertex_index[graph.edges[vertex_1].id] = vertex_1;
+
+	// 6. Fill the incoming edges; records are sorted by sources, so are the incoming edges of each vertex
+	for (uint64_t record_i = 0; record_i < all_records.size(); ++record_i)
+		graph.edges[graph.vertex_index[all_records[record_i].in_vertex]].in_edges.push_back(record_i);
+
+	// 7. Invalidate associated wanders
+	for (uint32_t wander_i = 0; wander_i < graph.associated_wanders.size(); ++wander_i)
+		graph.associated_wanders[wander_i]->invalidate();
+
+	return;
+}
+
+
+
+
+
+// External builder: constructors and destructors
+
+
+
+
+
+template <typename Real>
+rwe::ExternalGraphBuilder<Real>::ExternalGraphBuilder(uint64_t const memory_budget, std::string const temp_file_name) :
+	memory_budget(memory_budget), temp_file_name(makeUniquePrefix(temp_file_name)), records(), runs(), run_counter(0), record_count(0)
+{
+	// Intended to be empty
+}
+
+
+
+template <typename Real>
+rwe::ExternalGraphBuilder<Real>::~ExternalGraphBuilder(void)
+{
+	// Runs are numbered in the order of their creation, so that even the runs abandoned by an exception are removed
+	for (uint64_t run_number = 0; run_number < this->run_counter; ++run_number)
+		std::remove(this->getRunName(run_number).c_str());
+}
+
+
+
+
+
+// External builder: access
+
+
+
+
+
+template <typename Real>
+uint64_t const rwe::ExternalGraphBuilder<Real>::getRecordCount(void) const
+{
+	return this->record_count;
+}
+
+
+
+template <typename Real>
+uint64_t const rwe::ExternalGraphBuilder<Real>::getRunCount(void) const
+{
+	return this->runs.size();
+}
+
+
+
+
+
+// External builder: modifiers
+
+
+
+
+
+template <typename Real>
+void rwe::ExternalGraphBuilder<Real>::addEdge(uint32_t const out_vertex, uint32_t const in_vertex, Real const length, bool const is_directed)
+{
+	// 1. <length> must be positive
+	if (length <= 0)
+		throw std::invalid_argument("Desired length of an edge must be a positive number.");
+
+	// 2. Undirected edges are always stored as <min> ---- <max>
+	this->records.push_back(EdgeRecord{(is_directed) ? (out_vertex) : (std::min(out_vertex, in_vertex)), (is_directed) ? (in_vertex) : (std::max(out_vertex, in_vertex)), length, is_directed});
+	++this->record_count;
+	if (this->records.size() >= this->getBufferSize())
+		this->spill();
+
+	return;
+}
+
+
+
+template <typename Real>
+void rwe::ExternalGraphBuilder<Real>::append(MetricGraphBuilder<Real> &&other)
+{
+	uint64_t const buffer_size = this->getBufferSize();
+
+	// 1. Records of the other builder are already checked, so they are only moved into the buffer piece by piece
+	for (uint64_t record_i = 0; record_i < other.records.size();)
+	{
+		uint64_t const piece_size = std::min<uint64_t>(buffer_size - this->records.size(), other.records.size() - record_i);
+
+		this->records.insert(this->records.end(), other.records.begin() + record_i, other.records.begin() + record_i + piece_size);
+		record_i += piece_size;
+		if (this->records.size() >= buffer_size)
+			this->spill();
+	}
+	this->record_count += other.records.size();
+	other.records.clear();
+	other.records.shrink_to_fit();
+
+	return;
+}
+
+
+
+template <typename Real>
+void rwe::ExternalGraphBuilder<Real>::clear(void)
+{
+	this->records.clear();
+	this->records.shrink_to_fit();
+	this->dropRuns(0);
+	this->record_count = 0;
+
+	return;
+}
+
+
+
+
+
+// External builder: save/load
+
+
+
+
+
+template <typename Real>
+void rwe::ExternalGraphBuilder<Real>::fromGEXF(std::string const file_name)
+{
+	std::string const                       file_format         = ".gexf";
+	uint64_t const                          min_chunk_size      = 1 << 20;
+	uint64_t const                          window_size         = std::max<uint64_t>(this->memory_budget / 2, min_chunk_size);
+	MappedFile                              mapped_file(((file_name.size() >= file_format.size()) && (file_name.substr(file_name.size() - file_format.size()) == file_format)) ? (file_name) : (file_name + file_format));
+	char const                             *file_end            = mapped_file.getData() + mapped_file.getSize();
+	GEXFParser<Real>                        prologue_parser(PROLOGUE, false);
+	char const                             *edges_begin         = nullptr;
+	char const                             *window_end          = nullptr;
+	uint64_t                                first_run           = 0;
+	uint64_t                                first_record_count  = 0;
+	bool                                    is_complete         = false;
+	bool                                    is_split            = true;
+	std::vector<GEXFParser<Real>>           parsers;
+
+	// 1. Open file and find the beginning of the "edges" section and the default edge type before it
+	if (!mapped_file.isOpen())
+		return;
+	edges_begin = prologue_parser.parse(mapped_file.getData(), file_end);
+	if (prologue_parser.getState() == DEFAULT_TYPE_VALUE)
+		throw std::runtime_error("Unable to find out the default edge type.");
+	if (prologue_parser.getState() != EDGE_BEGIN)
+		return;
+
+	// 2. Records added before are spilled, so that records of this file can be dropped if it turns out to be malformed
+	this->spill();
+	first_run = this->runs.size();
+	first_record_count = this->record_count;
+	try
+	{
+		// 3. The "edges" section is taken in windows which end at beginnings of edges, each window is split and parsed
+		//    in parallel the same way as in "MetricGraph::fromGEXF"
+		for (char const *window_begin = edges_begin; (window_begin != file_end) && (is_split) && (!is_complete); window_begin = window_end)
+		{
+			window_end = window_begin + std::min<uint64_t>(window_size, file_end - window_begin);
+			while ((window_end < file_end - 6) && (!isEdgeBegin(window_end)))
+				++window_end;
+			window_end = (window_end < file_end - 6) ? (window_end) : (file_end);
+			is_split = parseGEXFChunks(window_begin, window_end, file_end, min_chunk_size, prologue_parser.getDefaultIsDirected(), parsers);
+			for (uint32_t chunk_i = 0; (chunk_i < parsers.size()) && (is_split); ++chunk_i)
+				this->append(std::move(parsers[chunk_i].getBuilder()));
+			is_complete = (is_split) && (parsers.back().getState() == EPILOGUE);
+			parsers.clear();
+		}
+
+		// 4. If the file is malformed at a split point, the section is parsed once again in a single pass to reproduce
+		//    the exact behaviour; the parser keeps its state between windows
+		if (!is_split)
+		{
+			GEXFParser<Real> section_parser(EDGE_BEGIN, prologue_parser.getDefaultIsDirected());
+
+			this->dropRuns(first_run);
+			this->records.clear();
+			this->record_count = first_record_count;
+			for (char const *window_begin = edges_begin; (window_begin != file_end) && (section_parser.getState() != EPILOGUE); window_begin = window_end)
+			{
+				window_end = window_begin + std::min<uint64_t>(window_size, file_end - window_begin);
+				section_parser.parse(window_begin, window_end);
+				this->append(std::move(section_parser.getBuilder()));
+			}
+			is_complete = section_parser.getState() == EPILOGUE;
+		}
+	}
+	catch (...)
 	{
-		VertexList const    &neighbourhood          = this->edges[neighbourhood_i].adjacents;
-		auto                 adjacent_lower_bound   = std::lower_bound(neighbourhood.begin(), neighbourhood.end(), vertex);
+		this->dropRuns(first_run);
+		this->records.clear();
+		this->record_count = first_record_count;
+		throw;
+	}
 
-		if ((adjacent_lower_bound != neighbourhood.end()) && (*adjacent_lower_bound == vertex))
-			return true;
+	// 5. If the "edges" section is incomplete, records of this file are dropped
+	if (!is_complete)
+	{
+		this->dropRuns(first_run);
+		this->records.clear();
+		this->record_count = first_record_count;
 	}
 
-	return false;
+	return;
 }
 
 
 
-std::vector<uint32_t> const rwe::MetricGraph::getVertexList(void) const
+template <typename Real>
+void rwe::ExternalGraphBuilder<Real>::fromRWEG(std::string const file_name)
 {
-	std::set<uint32_t> vertices;
+	std::string const       file_format     = ".rweg";
+	uint64_t const          record_size     = 2 * sizeof(uint32_t) + sizeof(long double) + sizeof(bool);
+	MappedFile              mapped_file(((file_name.size() >= file_format.size()) && (file_name.substr(file_name.size() - file_format.size()) == file_format)) ? (file_name) : (file_name + file_format));
+	uint32_t                out_vertex(0), in_vertex(0);
+	long double             length(0.0);
+	uint8_t                 is_directed(0);
+
+	// 1. Files of version 2 are read row by row right from the mapping
+	if (RWEGFile::checkSignature(mapped_file.getData(), mapped_file.getSize()))
+	{
+		RWEGFile const      rweg_file(std::move(mapped_file));
+		uint32_t const     *vertex_ids  = rweg_file.getVertexIDs();
+		uint64_t const     *offsets     = rweg_file.getOffsets();
+		uint32_t const     *targets     = rweg_file.getTargets();
+		double const       *lengths     = rweg_file.getLengths();
+
+		for (uint32_t vertex_1 = 0; vertex_1 < rweg_file.getVertexCount(); ++vertex_1)
+			for (uint64_t edge = offsets[vertex_1]; edge < offsets[vertex_1 + 1]; ++edge)
+				this->addEdge(vertex_ids[vertex_1], vertex_ids[targets[edge]], lengths[edge], rweg_file.isDirected(edge));
+		return;
+	}
 
-	for (uint32_t vertex_i = 0; vertex_i < this->edges.size(); ++vertex_i)
+	// 2. Files of version 1 are sequences of records of the same size
+	if (!mapped_file.isOpen())
+		return;
+	if (mapped_file.getSize() % record_size != 0)
+		throw std::runtime_error("The size of the rweg file is not a multiple of the size of its records.");
+	for (char const *record = mapped_file.getData(); record != mapped_file.getData() + mapped_file.getSize(); record += record_size)
 	{
-		vertices.insert(vertex_i);
-		vertices.insert(this->edges[vertex_i].adjacents.begin(), this->edges[vertex_i].adjacents.end());
+		std::memcpy(&out_vertex, record, sizeof(out_vertex));
+		std::memcpy(&in_vertex, record + sizeof(out_vertex), sizeof(in_vertex));
+		std::memcpy(&length, record + sizeof(out_vertex) + sizeof(in_vertex), sizeof(length));
+		std::memcpy(&is_directed, record + sizeof(out_vertex) + sizeof(in_vertex) + sizeof(length), sizeof(is_directed));
+		this->addEdge(out_vertex, in_vertex, length, is_directed != 0);
 	}
 
-	return std::vector<uint32_t>(vertices.begin(), vertices.end());
+	return;
 }
 
 
 
-long double const rwe::MetricGraph::getEdgeLength(uint32_t const out_vertex, uint32_t in_vertex) const
+template <typename Real>
+void rwe::ExternalGraphBuilder<Real>::toGEXF(std::string const file_name, bool const rewrite)
 {
-	// 1. Try to find corresponding edge
-	Edge edge = this->getEdge(out_vertex, in_vertex);
-
-	if (edge.first != this->edges.size())
-		return this->edges[edge.first].lengths[edge.second];
+	std::string const       file_format         = ".gexf";
+	uint64_t const          max_line_size       = 96 + 2 * max_number_length;
+	uint64_t const          lines_per_block     = 1 << 14;
+	std::string             full_file_name;
+	std::fstream            out_file;
+	std::vector<uint32_t>   vertex_ids;
+	std::vector<char>       buffer(lines_per_block * max_line_size);
+	char                   *position            = buffer.data();
+	uint64_t                edge_id             = 0;
 
-	// 2. If there is no edge between <out_vertex> and <in_vertex>, return infinity
-	return std::numeric_limits<long double const>::infinity();
-}
+	// 1. Check if specified file already exists
+	full_file_name = findFileName(file_name, file_format, rewrite);
 
+	// 2. Fold all records and sort the edges in the order of MetricGraph, the IDs of vertices are known afterwards
+	this->sortEdges(vertex_ids);
 
+	// 3. Dump information about graph into this file
+	out_file.open(full_file_name, std::fstream::out);
+	out_file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+	out_file << "<gexf xmlns=\"http://www.gexf.net/1.2draft\" xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" xsi:schemaLocation=\"http://www.gexf.net/1.2draft http://www.gexf.net/1.2draft/gexf.xsd\" version=\"1.2\">\n";
+	out_file << "\t<meta>\n";
+	out_file << "\t\t<creator>Random Walks Emulator v.0.2 by Andrei Eliseev (JointPoints, https://jointpoints.github.io/random-walks/)</creator>\n";
+	out_file << "\t</meta>\n";
+	out_file << "\t<graph>\n";
 
-void rwe::MetricGraph::outputEdgeList(std::ostream &output_stream) const
-{
-	for (uint32_t vertex_1 = 0; vertex_1 < this->edges.size(); ++vertex_1)
+	// 3.1. Vertices are formatted into a reusable buffer which is flushed block by block
+	out_file << "\t\t<nodes>\n";
+	for (uint64_t vertex_1 = 0; vertex_1 < vertex_ids.size(); vertex_1 += lines_per_block)
 	{
-		VertexView const &curr_vertex = this->edges[vertex_1];
-		for (uint32_t vertex_2 = 0; vertex_2 < curr_vertex.adjacents.size(); ++vertex_2)
-			output_stream << curr_vertex.id << ((curr_vertex.is_directed[vertex_2]) ? (" ---> ") : (" ---- ")) << curr_vertex.adjacents[vertex_2] << '\t' << curr_vertex.lengths[vertex_2] << '\n';
+		position = buffer.data();
+		for (uint64_t vertex_2 = vertex_1; vertex_2 < std::min<uint64_t>(vertex_1 + lines_per_block, vertex_ids.size()); ++vertex_2)
+		{
+			position = appendText(position, "\t\t\t<node id=\"");
+			position = formatInteger(position, vertex_ids[vertex_2]);
+			position = appendText(position, "\" />\n");
+		}
+		out_file.write(buffer.data(), position - buffer.data());
 	}
+	out_file << "\t\t</nodes>\n";
+
+	// 3.2. Edges come out of the final merge in order and are formatted into the same buffer
+	out_file << "\t\t<edges>\n";
+	position = buffer.data();
+	this->forEachEdge([&out_file, &buffer, &position, &edge_id, lines_per_block](EdgeRecord const &record)
+	                  {
+	                      position = appendText(position, "\t\t\t<edge id=\"");
+	                      position = formatInteger(position, edge_id++);
+	                      position = appendText(position, "\" source=\"");
+	                      position = formatInteger(position, record.out_vertex);
+	                      position = appendText(position, "\" target=\"");
+	                      position = formatInteger(position, record.in_vertex);
+	                      if (record.is_directed)
+	                          position = appendText(position, "\" type=\"directed\" weight=\"");
+	                      else
+	                          position = appendText(position, "\" type=\"undirected\" weight=\"");
+	                      position = formatReal(position, record.length);
+	                      position = appendText(position, "\" />\n");
+	                      if (edge_id % lines_per_block == 0)
+	                      {
+	                          out_file.write(buffer.data(), position - buffer.data());
+	                          position = buffer.data();
+	                      }
+	                  });
+	out_file.write(buffer.data(), position - buffer.data());
+	out_file << "\t\t</edges>\n";
+	out_file << "\t</graph>\n";
+	out_file << "</gexf>\n";
+	out_file.close();
 
 	return;
 }
 
 
 
-rwe::MetricGraph::Edge rwe::MetricGraph::getEdge(uint32_t const out_vertex, uint32_t const in_vertex, bool const is_directed, bool const strict_mode) const
+template <typename Real>
+void rwe::ExternalGraphBuilder<Real>::toRWEG(std::string const file_name, bool const rewrite)
 {
-	uint32_t const  out_vertex_new      = (is_directed) ? (out_vertex) : (std::min(out_vertex, in_vertex));
-	uint32_t const  in_vertex_new       = (is_directed) ? (in_vertex)  : (std::max(out_vertex, in_vertex));
-	auto            out_comparator      = [](VertexView const curr_vertex, uint32_t const value){return curr_vertex.id < value;};
-	auto            out_lower_bound     = std::lower_bound(this->edges.begin(), this->edges.end(), out_vertex_new, out_comparator);
+	std::string const       file_format         = ".rweg";
+	uint64_t const          section_buffer_size = 1 << 20;
+	std::string             full_file_name;
+	std::fstream            out_file;
+	std::vector<uint32_t>   vertex_ids;
+	uint64_t                edge_count          = 0;
+	uint64_t                section_offsets[6];
+	uint64_t                checksum            = 0;
+	uint32_t                row                 = 0;
+	uint64_t                edge                = 0;
+	uint64_t                direction_word      = 0;
 
-	// 1. Try to find a direct match: <out_vertex_new> ---> <in_vertex_new>
-	if ((out_lower_bound != this->edges.end()) && (out_lower_bound->id == out_vertex_new))
-	{
-		auto in_lower_bound = std::lower_bound(out_lower_bound->adjacents.begin(), out_lower_bound->adjacents.end(), in_vertex_new);
+	// 1. Check if specified file already exists
+	full_file_name = findFileName(file_name, file_format, rewrite);
 
-		if ((in_lower_bound != out_lower_bound->adjacents.end()) && (*in_lower_bound == in_vertex_new))
-		{
-			if (strict_mode)
-			{
-				if (out_lower_bound->is_directed[std::distance(out_lower_bound->adjacents.begin(), in_lower_bound)] == is_directed)
-					return std::make_pair(std::distance(this->edges.begin(), out_lower_bound), std::distance(out_lower_bound->adjacents.begin(), in_lower_bound));
-				else
-					return std::make_pair(this->edges.size(), 0);
-			}
-			else
-				return std::make_pair(std::distance(this->edges.begin(), out_lower_bound), std::distance(out_lower_bound->adjacents.begin(), in_lower_bound));
-		}
-	}
+	// 2. Fold all records and sort the edges in the order of MetricGraph, which is the order of rows; sizes of all
+	//    sections are known afterwards
+	edge_count = this->sortEdges(vertex_ids);
+	RWEGFile::computeLayout(vertex_ids.size(), edge_count, section_offsets);
 
-	// 2. If this is NOT a strict mode and the edge is directed, we may try to find <in_vertex_new> ---- <out_vertex_new>
-	if ((!strict_mode) && (is_directed) && (in_vertex_new > out_vertex_new))
+	// 3. Each section is written sequentially at its own offset, the header is left empty for now
+	out_file.open(full_file_name, std::fstream::out | std::fstream::binary | std::fstream::trunc);
 	{
-		out_lower_bound = std::lower_bound(this->edges.begin(), this->edges.end(), in_vertex_new, out_comparator);
+		SectionWriter       header_writer(out_file, 0, sizeof(RWEGHeader));
+		SectionWriter       vertex_id_writer(out_file, section_offsets[0], section_buffer_size);
+		SectionWriter       offset_writer(out_file, section_offsets[1], section_buffer_size);
+		SectionWriter       target_writer(out_file, section_offsets[2], section_buffer_size);
+		SectionWriter       length_writer(out_file, section_offsets[3], section_buffer_size);
+		SectionWriter       direction_writer(out_file, section_offsets[4], section_buffer_size);
+
+		header_writer.pad(section_offsets[0]);
+		for (uint32_t vertex_1 = 0; vertex_1 < vertex_ids.size(); ++vertex_1)
+			vertex_id_writer.write(vertex_ids[vertex_1]);
+		vertex_id_writer.pad(section_offsets[1]);
+		offset_writer.write(uint64_t(0));
+		this->forEachEdge([&vertex_ids, &offset_writer, &target_writer, &length_writer, &direction_writer, &row, &edge, &direction_word](EdgeRecord const &record)
+		                  {
+		                      for (; vertex_ids[row] != record.out_vertex; ++row)
+		                          offset_writer.write(edge);
+		                      target_writer.write(uint32_t(std::lower_bound(vertex_ids.begin(), vertex_ids.end(), record.in_vertex) - vertex_ids.begin()));
+		                      length_writer.write(double(record.length));
+		                      if (record.is_directed)
+		                          direction_word |= uint64_t(1) << (edge % 64);
+		                      if (++edge % 64 == 0)
+		                      {
+		                          direction_writer.write(direction_word);
+		                          direction_word = 0;
+		                      }
+		                  });
+		for (; row < vertex_ids.size(); ++row)
+			offset_writer.write(edge);
+		if (edge % 64 != 0)
+			direction_writer.write(direction_word);
+		offset_writer.pad(section_offsets[2]);
+		target_writer.pad(section_offsets[3]);
+		length_writer.pad(section_offsets[4]);
+		direction_writer.pad(section_offsets[5]);
+	}
+	out_file.close();
+	if (out_file.fail())
+		throw std::runtime_error("Unable to write the rweg file.");
 
-		if ((out_lower_bound != this->edges.end()) && (out_lower_bound->id == in_vertex_new))
-		{
-			auto in_lower_bound = std::lower_bound(out_lower_bound->adjacents.begin(), out_lower_bound->adjacents.end(), out_vertex_new);
+	// 4. The checksum needs one more pass over the written sections, then the header is put in its place
+	{
+		MappedFile const written_file(full_file_name);
 
-			if ((in_lower_bound != out_lower_bound->adjacents.end()) && (*in_lower_bound == in_vertex_new) && (!out_lower_bound->is_directed[std::distance(out_lower_bound->adjacents.begin(), in_lower_bound)]))
-				return std::make_pair(std::distance(this->edges.begin(), out_lower_bound), std::distance(out_lower_bound->adjacents.begin(), in_lower_bound));
-		}
+		checksum = RWEGFile::computeChecksum(written_file.getData() + section_offsets[0], section_offsets[5] - section_offsets[0]);
 	}
+	out_file.open(full_file_name, std::fstream::in | std::fstream::out | std::fstream::binary);
+	RWEGFile::writeHeader(out_file, vertex_ids.size(), edge_count, checksum);
+	out_file.close();
 
-	// 3. Otherwise, such edge doesn't exist
-	return std::make_pair(this->edges.size(), 0);
+	return;
 }
 
 
 
-std::deque<rwe::MetricGraph::Edge> rwe::MetricGraph::getDepartingEdges(uint32_t const out_vertex) const
-{
-	auto                out_comparator  = [](VertexView const curr_vertex, uint32_t const value){return curr_vertex.id < value;};
-	uint32_t const      max_index       = std::distance(this->edges.begin(), std::lower_bound(this->edges.begin(), this->edges.end(), out_vertex, out_comparator));
-	std::deque<Edge>    answer;
 
-	// 1. Traverse edges and find all indices that lead to edges of <out_vertex> ---- <x> or <out_vertex> ---> <x> types
-	for (uint32_t vertex_1 = 0; vertex_1 < (((max_index < this->edges.size()) && (this->edges[max_index].id == out_vertex)) ? (max_index + 1) : (max_index)); ++vertex_1)
-	{
-		VertexView const &curr_vertex = this->edges[vertex_1];
-		
-		if (curr_vertex.id == out_vertex)
-			for (uint32_t vertex_2 = 0; vertex_2 < curr_vertex.adjacents.size(); ++vertex_2)
-				answer.push_back(std::make_pair(vertex_1, vertex_2));
-		else
-		{
-			auto in_lower_bound = std::lower_bound(curr_vertex.adjacents.begin(), curr_vertex.adjacents.end(), out_vertex);
 
-			if ((in_lower_bound != curr_vertex.adjacents.end()) && (*in_lower_bound == out_vertex) && (!curr_vertex.is_directed[std::distance(curr_vertex.adjacents.begin(), in_lower_bound)]))
-				answer.push_back(std::make_pair(vertex_1, std::distance(curr_vertex.adjacents.begin(), in_lower_bound)));
-		}
-	}
+// External builder: runs
+
 
-	return answer;
-}
 
 
 
+template <typename Real>
+uint64_t const rwe::ExternalGraphBuilder<Real>::getBufferSize(void) const
+{
+	uint64_t const min_buffer_size = 1 << 10;
 
+	// Half of the budget is taken by the buffer of records, the other half by sorting it or by the buffers of runs being
+	// merged; when the folded edges are sorted, the buffer of records is shrunk, so that the IDs of vertices fit too
+	return std::max<uint64_t>(this->memory_budget / 2 / sizeof(EdgeRecord), min_buffer_size);
+}
 
-// Modifiers
 
 
+template <typename Real>
+std::string const rwe::ExternalGraphBuilder<Real>::getRunName(uint64_t const run_number) const
+{
+	return this->temp_file_name + " (run " + std::to_string(run_number) + ").tmp";
+}
 
 
 
-void rwe::MetricGraph::updateEdge(uint32_t const out_vertex, uint32_t const in_vertex, long double const length, bool const is_directed)
+template <typename Real>
+void rwe::ExternalGraphBuilder<Real>::writeRun(void)
 {
-	// 1. <length> must be positive
-	if (length <= 0)
-		throw std::invalid_argument("Desired length of an edge must be a positive number.");
+	std::string const       run_name    = this->getRunName(this->run_counter++);
+	RunWriter<EdgeRecord>   run_writer(run_name, 0);
 
-	uint32_t const  out_vertex_new  = (is_directed) ? (out_vertex) : (std::min(out_vertex, in_vertex));
-	uint32_t const  in_vertex_new   = (is_directed) ? (in_vertex)  : (std::max(out_vertex, in_vertex));
-	auto            out_comparator  = [](VertexView const curr_vertex, uint32_t const value){return curr_vertex.id < value;};
-	Edge            existing_edge   = this->getEdge(out_vertex_new, in_vertex_new, is_directed);
+	run_writer.write(this->records.data(), this->records.size());
+	run_writer.close();
+	this->runs.push_back(run_name);
+	this->records.clear();
 
-	if (existing_edge.first == this->edges.size())
-		existing_edge = this->getEdge(in_vertex_new, out_vertex_new);
+	return;
+}
 
-	// 1. If there is no edge like this, we just add a new element to the EdgeList
-	if (existing_edge.first == this->edges.size())
-	{
-		auto out_lower_bound = std::lower_bound(this->edges.begin(), this->edges.end(), out_vertex_new, out_comparator);
 
-		// 1.1. If <out_vertex_new> has been added before
-		if ((out_lower_bound != this->edges.end()) && (out_lower_bound->id == out_vertex_new))
-		{
-			auto in_lower_bound = std::lower_bound(out_lower_bound->adjacents.begin(), out_lower_bound->adjacents.end(), in_vertex_new);
-			out_lower_bound->lengths.insert(out_lower_bound->lengths.begin() + std::distance(out_lower_bound->adjacents.begin(), in_lower_bound), length);
-			out_lower_bound->is_directed.insert(out_lower_bound->is_directed.begin() + std::distance(out_lower_bound->adjacents.begin(), in_lower_bound), is_directed);
-			out_lower_bound->adjacents.insert(in_lower_bound, in_vertex_new);
-			return;
-		}
 
-		// 1.2. If <out_vertex_new> has never been added before
-		this->edges.insert(out_lower_bound, {out_vertex_new, VertexList{in_vertex_new}, LengthList{length}, DirectionList{is_directed}});
-		return;
-	}
+template <typename Real>
+void rwe::ExternalGraphBuilder<Real>::spill(void)
+{
+	auto const      pair_comparator     = isLessPair<EdgeRecord>;
+	uint64_t        merged_count        = 0;
 
-	// 2. If there is an edge like this, we need to check how strict the match is:
-	//        - if new edge is <out_vertex_new> ---> <in_vertex_new> but existing is <out_vertex_new> ---> <in_vertex_new>,
-	//          we only need to update the length
-	//        - if new edge is <out_vertex_new> ---> <in_vertex_new> but existing is <out_vertex_new> <--- <in_vertex_new>,
-	//          we need to replace it with a single undirected edge <out_vertex_new> ---- <in_vertex_new>
-	//        - if new edge is <out_vertex_new> ---> <in_vertex_new> but existing is <out_vertex_new> ---- <in_vertex_new>,
-	//          we only need to update the length
-	//        - if new edge is <out_vertex_new> ---- <in_vertex_new> but existing is <out_vertex_new> <--- <in_vertex_new> or <out_vertex_new> ---> <in_vertex_new>,
-	//          we need to replace it with a single undirected edge <out_vertex_new> ---- <in_vertex_new>
-	//        - if new edge is <out_vertex_new> ---- <in_vertex_new> but existing is <out_vertex_new> ---- <in_vertex_new>,
-	//          we only need to update the length
-	if (this->edges[existing_edge.first].id == out_vertex_new)
-	{
-		this->edges[existing_edge.first].lengths[existing_edge.second] = length;
-		if ((this->edges[existing_edge.first].is_directed[existing_edge.second]) && (is_directed))
-			return;
-		this->edges[existing_edge.first].is_directed[existing_edge.second] = false;
+	if (this->records.empty())
 		return;
-	}
-	if (this->edges[existing_edge.first].id < out_vertex_new)
+
+	// 1. Group records by unordered pairs of vertices without changing their relative order and fold each group the
+	//    same way as "MetricGraphBuilder::build" does
+	std::stable_sort(this->records.begin(), this->records.end(), pair_comparator);
+	for (uint64_t record_i = 0; record_i < this->records.size(); ++record_i)
 	{
-		this->edges[existing_edge.first].lengths[existing_edge.second] = length;
-		this->edges[existing_edge.first].is_directed[existing_edge.second] = false;
-		return;
+		if ((record_i == 0) || (pair_comparator(this->records[merged_count - 1], this->records[record_i])))
+			this->records[merged_count++] = this->records[record_i];
+		else
+			foldRecord(this->records[merged_count - 1], this->records[record_i]);
 	}
-	this->edges[existing_edge.second].adjacents.erase(this->edges[existing_edge.second].adjacents.begin() + existing_edge.first);
-	this->edges[existing_edge.second].lengths.erase(this->edges[existing_edge.second].lengths.begin() + existing_edge.first);
-	this->edges[existing_edge.second].is_directed.erase(this->edges[existing_edge.second].is_directed.begin() + existing_edge.first);
-	if (this->edges[existing_edge.second].adjacents.size() == 0)
-		this->edges.erase(this->edges.begin() + existing_edge.second);
-	this->updateEdge(out_vertex_new, in_vertex_new, length, false);
+	this->records.resize(merged_count);
+
+	// 2. The result is a run
+	this->writeRun();
 
-	// 3. Invalidate associated wanders
-	for (uint32_t wander_i = 0; wander_i < this->associated_wanders.size(); ++wander_i)
-		this->associated_wanders[wander_i]->invalidate();
-	
 	return;
 }
 
 
 
+template <typename Real>
+void rwe::ExternalGraphBuilder<Real>::dropRuns(uint64_t const first_run)
+{
+	for (uint64_t run_i = first_run; run_i < this->runs.size(); ++run_i)
+		std::remove(this->runs[run_i].c_str());
+	this->runs.resize(std::min<uint64_t>(first_run, this->runs.size()));
 
-
-// Save/load
-
-
+	return;
+}
 
 
 
-void rwe::MetricGraph::toGEXF(std::string const file_name, bool const rewrite) const
+template <typename Real>
+template <typename Comparator>
+void rwe::ExternalGraphBuilder<Real>::reduceRuns(Comparator const &is_less)
 {
-	std::string const   file_format     = ".gexf";
-	std::string         file_name_new   = ((file_name.size() >= file_format.size()) && (file_name.substr(file_name.size() - file_format.size()) == file_format)) ? (file_name.substr(0, file_name.size() - file_format.size())) : (file_name);
-	std::fstream        out_file;
+	uint32_t const              max_fan_in      = 64;
+	uint64_t const              buffer_size     = this->getBufferSize();
+	std::vector<std::string>    previous_runs;
 
-	std::vector<uint32_t>   vertex_list;
-	uint64_t                edge_id         = 0;
-
-	// 1. Check if specified file already exists
-	if (!rewrite)
+	// 1. Consecutive runs are merged in groups until few enough runs are left; groups follow the order of runs, so
+	//    records of the same pair are still folded in the order of their addition
+	while (this->runs.size() > max_fan_in)
 	{
-		out_file.open(file_name_new + file_format, std::fstream::in);
-		if (out_file.is_open())
+		previous_runs.swap(this->runs);
+		for (uint64_t first_run = 0; first_run < previous_runs.size(); first_run += max_fan_in)
 		{
-			uint8_t file_number = 1;
-
-			out_file.close();
-			file_name_new += " (1)";
-			out_file.open(file_name_new + file_format, std::fstream::in);
-			while (out_file.is_open())
-			{
-				out_file.close();
-				file_name_new = file_name + " (" + std::to_string(++file_number) + ")";
-				out_file.open(file_name_new + file_format, std::fstream::in);
-			}
+			std::vector<std::string> const  group(previous_runs.begin() + first_run, previous_runs.begin() + std::min<uint64_t>(first_run + max_fan_in, previous_runs.size()));
+			std::string const               run_name    = this->getRunName(this->run_counter++);
+			RunWriter<EdgeRecord>           run_writer(run_name, buffer_size / 2);
+
+			mergeRuns<EdgeRecord>(group, buffer_size / 2, is_less, [&run_writer](EdgeRecord const &record){run_writer.write(record);});
+			run_writer.close();
+			this->runs.push_back(run_name);
+			for (uint32_t run_i = 0; run_i < group.size(); ++run_i)
+				std::remove(group[run_i].c_str());
 		}
-		out_file.close();
+		previous_runs.clear();
 	}
 
-	// 2. Dump information about graph into this file
-	out_file.open(file_name_new + file_format, std::fstream::out);
-	out_file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
-	out_file << "<gexf xmlns=\"http://www.gexf.net/1.2draft\" xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" xsi:schemaLocation=\"http://www.gexf.net/1.2draft http://www.gexf.net/1.2draft/gexf.xsd\" version=\"1.2\">\n";
-	out_file << "\t<meta>\n";
-	out_file << "\t\t<creator>Random Walks Emulator v.0.2 by Andrei Eliseev (JointPoints, https://jointpoints.github.io/random-walks/)</creator>\n";
-	out_file << "\t</meta>\n";
-	out_file << "\t<graph>\n";
-	out_file << "\t\t<nodes>\n";
-	vertex_list = this->getVertexList();
-	for (uint32_t vertex_i = 0; vertex_i < vertex_list.size(); ++vertex_i)
-		out_file << "\t\t\t<node id=\"" + std::to_string(vertex_list[vertex_i]) + "\" />\n";
-	out_file << "\t\t</nodes>\n";
-	out_file << "\t\t<edges>\n";
-	for (uint32_t vertex_1 = 0; vertex_1 < this->edges.size(); ++vertex_1)
-	{
-		VertexView const &curr_vertex = this->edges[vertex_1];
-		for (uint32_t vertex_2 = 0; vertex_2 < curr_vertex.adjacents.size(); ++vertex_2)
-			out_file << "\t\t\t<edge id=\"" + std::to_string(edge_id++) + "\" source=\"" + std::to_string(curr_vertex.id) + "\" target=\"" + \
-			            std::to_string(curr_vertex.adjacents[vertex_2]) + "\" type=\"" + ((curr_vertex.is_directed[vertex_2]) ? ("directed") : ("undirected")) + \
-			            "\" weight=\"" + std::to_string(curr_vertex.lengths[vertex_2]) + "\" />\n";
-	}
-	out_file << "\t\t</edges>\n";
-	out_file << "\t</graph>\n";
-	out_file << "</gexf>\n";
-	out_file.close();
-	
 	return;
 }
 
 
 
-void rwe::MetricGraph::fromGEXF(std::string const file_name)
+template <typename Real>
+uint64_t const rwe::ExternalGraphBuilder<Real>::sortEdges(std::vector<uint32_t> &vertex_ids)
 {
-	enum GEXFLexStates{SPACE, TOKEN};
-	enum GEXFParserStates{EDGE_BEGIN, ATTR_BEGIN, SOURCE_VALUE, TARGET_VALUE, TYPE_VALUE, WEIGHT_VALUE, SKIP_VALUE};
-
-	std::string const   file_format     = ".gexf";
-	std::fstream        in_file;
-
-	// 1. Open file and read data
-	in_file.open(((file_name.size() >= file_format.size()) && (file_name.substr(file_name.size() - file_format.size()) == file_format)) ? (file_name) : (file_name + file_format), std::fstream::in);
-	if (in_file.is_open())
-	{
-		GEXFLexStates                       lexer_state         = SPACE;
-		bool                                ignore_ws_regime    = false;
-		char                                symbol;
-		std::string                         token               = "";
-		std::vector<std::string>            tokens;
-		std::vector<std::string>::iterator  default_type_begin;
-		std::vector<std::string>::iterator  edges_begin;
-		std::vector<std::string>::iterator  edges_end;
-
-		GEXFParserStates                    parser_state        = EDGE_BEGIN;
-		uint32_t                            out_vertex(0), in_vertex(0);
-		long double                         length(0.0);
-		bool                                is_directed(false);
-		bool                                default_is_directed(false);
-		bool                                source_specified    = false;
-		bool                                target_specified    = false;
-		bool                                weight_specified    = false;
-
-		// 1.1. Tokenise the text from file
-		while (in_file >> std::noskipws >> symbol)
-		{
-			switch (lexer_state)
-			{
-			// expect space
-			case SPACE:
-				if ((symbol == ' ') || (symbol == '\t') || (symbol == '\n') || (symbol == '\r'))
-					break;
-				lexer_state = TOKEN;
-			// expect token
-			case TOKEN:
-				if (!ignore_ws_regime)
-				{
-					if ((symbol == '>') || (symbol == '='))
-					{
-						if (token != "")
-						{
-							tokens.push_back(token);
-							token = "";
-						}
-						lexer_state = SPACE;
-						break;
-					}
-					if ((symbol == ' ') || (symbol == '\t') || (symbol == '\n') || (symbol == '\r'))
-					{
-						if (token != "")
-						{
-							tokens.push_back(token);
-							token = "";
-						}
-						lexer_state = SPACE;
-						break;
-					}
-				}
-				if (symbol == '"')
-					ignore_ws_regime = !ignore_ws_regime;
-				else
-					token += symbol;
-				break;
-			}
-		}
-
-		// 1.2. Find out the default edge type
-		default_type_begin = std::find(tokens.begin(), tokens.end(), "defaultedgetype");
-		if (default_type_begin == tokens.end() - 1)
-			throw std::runtime_error("Unable to find out the default edge type.");
-		if (default_type_begin != tokens.end())
-		{
-			if ((*(default_type_begin + 1) == "undirected") || (*(default_type_begin + 1) == "mutual"))
-				default_is_directed = false;
-			else
-				if (*(default_type_begin + 1) == "directed")
-					default_is_directed = true;
-				else
-					throw std::runtime_error("Unknown default type of the edge '" + *(default_type_begin + 1) + "'.");
-		}
-
-		// 1.3. We don't really care about anything but the "edges" section
-		edges_begin = std::find(tokens.begin(), tokens.end(), "<edges");
-		edges_end = std::find(tokens.begin(), tokens.end(), "</edges");
-		if ((edges_begin == tokens.end()) || (edges_end == tokens.end()))
-		{
-			in_file.close();
-			return;
-		}
-		for (auto token_i = edges_begin + 1; token_i < edges_end; ++token_i)
-		{
-			switch (parser_state)
-			{
-			// expect beginning of a new edge
-			case EDGE_BEGIN:
-				if (*token_i != "<edge")
-					throw std::runtime_error("Unexpected token '" + *token_i + "' in the 'edges' section of the gexf file.");
-				source_specified = target_specified = weight_specified = false;
-				out_vertex = in_vertex = 0;
-				length = 0.0;
-				is_directed = default_is_directed;
-				parser_state = ATTR_BEGIN;
-				break;
-			// expect beginning of an attribute
-			case ATTR_BEGIN:
-				if (*token_i == "source")
-				{
-					parser_state = SOURCE_VALUE;
-					break;
-				}
-				if (*token_i == "target")
-				{
-					parser_state = TARGET_VALUE;
-					break;
-				}
-				if (*token_i == "type")
-				{
-					parser_state = TYPE_VALUE;
-					break;
-				}
-				if (*token_i == "weight")
-				{
-					parser_state = WEIGHT_VALUE;
-					break;
-				}
-				if ((*token_i == "<edge") || (*token_i == "/"))
-				{
-					if (source_specified && target_specified && weight_specified)
-					{
-						this->updateEdge(out_vertex, in_vertex, length, is_directed);
-						if (*token_i == "<edge")
-						{
-							source_specified = target_specified = weight_specified = false;
-							out_vertex = in_vertex = 0;
-							length = 0.0;
-							is_directed = default_is_directed;
-							break;
-						}
-						parser_state = EDGE_BEGIN;
-						break;
-					}
-					throw std::runtime_error("Each edge must contain 'source', 'target' and 'weight' attributes.");
-				}
-				if ((*token_i)[0] == '<')
-					throw std::runtime_error("Unexpected token '" + *token_i + "' in the 'edges' section of the gexf file.");
-				parser_state = SKIP_VALUE;
-				break;
-			// expect the source value
-			case SOURCE_VALUE:
-				try
-				{
-					out_vertex = std::stoi(*token_i);
-					source_specified = true;
-					parser_state = ATTR_BEGIN;
-					break;
-				}
-				catch(...){}
-				throw std::runtime_error("Vertex ID '" + *token_i + "' do not comply with the requirements of emulator.");
-			// expect the target value
-			case TARGET_VALUE:
-				try
-				{
-					in_vertex = std::stoi(*token_i);
-					target_specified = true;
-					parser_state = ATTR_BEGIN;
-					break;
-				}
-				catch(...){}
-				throw std::runtime_error("Vertex ID '" + *token_i + "' do not comply with the requirements of emulator.");
-			// expect the type value
-			case TYPE_VALUE:
-				if ((*token_i == "undirected") || (*token_i == "mutual"))
-				{
-					is_directed = false;
-					parser_state = ATTR_BEGIN;
-					break;
-				}
-				if (*token_i == "directed")
-				{
-					is_directed = true;
-					parser_state = ATTR_BEGIN;
-					break;
-				}
-				throw std::runtime_error("Unknown type of the edge '" + *token_i + "'.");
-			// expect the weight value
-			case WEIGHT_VALUE:
-				try
-				{
-					length = std::stold(*token_i);
-					weight_specified = true;
-					parser_state = ATTR_BEGIN;
-					break;
-				}
-				catch(...){}
-				throw std::runtime_error("Unable to interpret weight value '" + *token_i + "'.");
-			// skip the value
-			case SKIP_VALUE:
-				parser_state = ATTR_BEGIN;
-				break;
-			}
-		}
+	auto const                  pair_comparator     = isLessPair<EdgeRecord>;
+	auto const                  edge_comparator     = isLessEdge<EdgeRecord>;
+	uint64_t const              buffer_size         = this->getBufferSize();
+	uint64_t const              edge_buffer_size    = buffer_size / 2;
+	uint64_t const              id_slack            = buffer_size / 2 * sizeof(EdgeRecord) / sizeof(uint32_t);
+	uint64_t                    edge_count          = 0;
+	uint64_t                    unique_vertex_count = 0;
+	std::vector<std::string>    pair_runs;
+	auto const                  compact_vertex_ids  = [&vertex_ids, &unique_vertex_count, id_slack]()
+	                                                  {
+	                                                      std::sort(vertex_ids.begin(), vertex_ids.end());
+	                                                      vertex_ids.erase(std::unique(vertex_ids.begin(), vertex_ids.end()), vertex_ids.end());
+	                                                      unique_vertex_count = vertex_ids.size();
+	                                                      vertex_ids.reserve(2 * unique_vertex_count + id_slack);
+	                                                  };
+
+	// 1. All runs are sorted by unordered pairs of vertices, the last one is the rest of the buffer
+	this->spill();
+	this->reduceRuns(pair_comparator);
+	pair_runs.swap(this->runs);
+
+	// 2. Runs are merged and folded, the folded edges are spilled once again in the order of MetricGraph; IDs of vertices
+	//    are collected and compacted before they take more than twice the number of distinct ones; the buffers of runs
+	//    take a half of the budget, the buffer of edges and the IDs beyond the distinct ones a quarter each
+	vertex_ids.clear();
+	vertex_ids.reserve(id_slack);
+	this->records.shrink_to_fit();
+	this->records.reserve(edge_buffer_size);
+	mergeRuns<EdgeRecord>(pair_runs, buffer_size, pair_comparator, [this, edge_comparator, edge_buffer_size, id_slack, &edge_count, &vertex_ids, &unique_vertex_count, &compact_vertex_ids](EdgeRecord const &record)
+	                      {
+	                          this->records.push_back(record);
+	                          ++edge_count;
+	                          if (this->records.size() == edge_buffer_size)
+	                          {
+	                              std::sort(this->records.begin(), this->records.end(), edge_comparator);
+	                              this->writeRun();
+	                          }
+	                          if (vertex_ids.size() + 2 > 2 * unique_vertex_count + id_slack)
+	                              compact_vertex_ids();
+	                          vertex_ids.push_back(record.out_vertex);
+	                          vertex_ids.push_back(record.in_vertex);
+	                      });
+	if (!this->records.empty())
+	{
+		std::sort(this->records.begin(), this->records.end(), edge_comparator);
+		this->writeRun();
 	}
-	in_file.close();
+	this->records.shrink_to_fit();
+	for (uint64_t run_i = 0; run_i < pair_runs.size(); ++run_i)
+		std::remove(pair_runs[run_i].c_str());
+	compact_vertex_ids();
+	vertex_ids.shrink_to_fit();
 
-	return;
+	return edge_count;
 }
 
 
 
-void rwe::MetricGraph::toRWEG(std::string const file_name, bool const rewrite) const
+template <typename Real>
+template <typename Consumer>
+void rwe::ExternalGraphBuilder<Real>::forEachEdge(Consumer const &consume)
 {
-	std::string const   file_format     = ".rweg";
-	std::string         file_name_new   = ((file_name.size() >= file_format.size()) && (file_name.substr(file_name.size() - file_format.size()) == file_format)) ? (file_name.substr(0, file_name.size() - file_format.size())) : (file_name);;
-	std::fstream        out_file;
-
-	// 1. Check if specified file already exists
-	if (!rewrite)
-	{
-		out_file.open(file_name_new + file_format, std::fstream::in | std::fstream::binary);
-		if (out_file.is_open())
-		{
-			uint8_t file_number = 1;
+	auto const edge_comparator = isLessEdge<EdgeRecord>;
 
-			out_file.close();
-			file_name_new += " (1)";
-			out_file.open(file_name_new + file_format, std::fstream::in | std::fstream::binary);
-			while (out_file.is_open())
-			{
-				out_file.close();
-				file_name_new = file_name + " (" + std::to_string(++file_number) + ")";
-				out_file.open(file_name_new + file_format, std::fstream::in | std::fstream::binary);
-			}
-		}
-		out_file.close();
-	}
+	// 1. Runs sorted in the order of MetricGraph hold distinct edges, so the merge only puts them in order
+	this->reduceRuns(edge_comparator);
+	mergeRuns<EdgeRecord>(this->runs, this->getBufferSize(), edge_comparator, consume);
+	this->dropRuns(0);
+	this->record_count = 0;
 
-	// 2. Dump information about graph into this file
-	out_file.open(file_name_new + file_format, std::fstream::out | std::fstream::binary);
-	for (uint32_t vertex_1 = 0; vertex_1 < this->edges.size(); ++vertex_1)
-	{
-		VertexView const &curr_vertex = this->edges[vertex_1];
-		for (uint32_t vertex_2 = 0; vertex_2 < curr_vertex.adjacents.size(); ++vertex_2)
-		{
-			bool const is_directed = curr_vertex.is_directed[vertex_2];
-			out_file.write(reinterpret_cast<char const *const>(&curr_vertex.id), sizeof(curr_vertex.id));
-			out_file.write(reinterpret_cast<char const *const>(&curr_vertex.adjacents[vertex_2]), sizeof(curr_vertex.adjacents[vertex_2]));
-			out_file.write(reinterpret_cast<char const *const>(&curr_vertex.lengths[vertex_2]), sizeof(curr_vertex.lengths[vertex_2]));
-			out_file.write(reinterpret_cast<char const *const>(&is_directed), sizeof(curr_vertex.is_directed[vertex_2]));
-		}
-	}
-	out_file.close();
-	
 	return;
 }
 
 
 
-void rwe::MetricGraph::fromRWEG(std::string const file_name)
-{
-	std::string const   file_format     = ".rweg";
-	std::fstream        in_file;
 
-	// 1. Open file and read data
-	in_file.open(((file_name.size() >= file_format.size()) && (file_name.substr(file_name.size() - file_format.size()) == file_format)) ? (file_name) : (file_name + file_format), std::fstream::in | std::fstream::binary);
-	if (in_file.is_open())
-	{
-		uint32_t        out_vertex(0), in_vertex(0);
-		long double     length(0.0);
-		bool            is_directed(false);
 
-		in_file.read(reinterpret_cast<char *>(&out_vertex), sizeof(out_vertex));
-		in_file.read(reinterpret_cast<char *>(&in_vertex), sizeof(in_vertex));
-		in_file.read(reinterpret_cast<char *>(&length), sizeof(length));
-		in_file.read(reinterpret_cast<char *>(&is_directed), sizeof(is_directed));
-		while (!in_file.fail())
-		{
-			this->updateEdge(out_vertex, in_vertex, length, is_directed);
-			in_file.read(reinterpret_cast<char *>(&out_vertex), sizeof(out_vertex));
-			in_file.read(reinterpret_cast<char *>(&in_vertex), sizeof(in_vertex));
-			in_file.read(reinterpret_cast<char *>(&length), sizeof(length));
-			in_file.read(reinterpret_cast<char *>(&is_directed), sizeof(is_directed));
-		}
-	}
-	in_file.close();
+// Explicit instantiations
 
-	return;
-}
+
+
+
+
+template class rwe::MetricGraph<float>;
+template class rwe::MetricGraph<double>;
+template class rwe::MetricGraph<long double>;
+template class rwe::MetricGraphBuilder<float>;
+template class rwe::MetricGraphBuilder<double>;
+template class rwe::MetricGraphBuilder<long double>;
+template class rwe::ExternalGraphBuilder<float>;
+template class rwe::ExternalGraphBuilder<double>;
+template class rwe::ExternalGraphBuilder<long double>;
@@ -12,11 +12,11 @@
 
 
 
-#include <vector>   // needed for "vector"
-#include <deque>    // needed for "deque"
-#include <cstdint>  // needed for "int*_t" and "uint*_t" types
-#include <string>   // needed for "string"
-#include <iostream> // needed for "iostream"
+#include <vector>           // needed for "vector"
+#include <unordered_map>    // needed for "unordered_map"
+#include <cstdint>          // needed for "int*_t" and "uint*_t" types
+#include <string>           // needed for "string"
+#include <iostream>         // needed for "iostream"
 
 
 
@@ -29,8 +29,33 @@ namespace rwe
 
 
 
-	// Forward declaration of RWSpace class
-	class RWSpace;
+	// Forward declaration of RWSpace, CompiledGraph, MetricGraphBuilder and ExternalGraphBuilder classes
+	template <typename Real> class RWSpace;
+	template <typename Real> class CompiledGraph;
+	template <typename Real> class MetricGraphBuilder;
+	template <typename Real> class ExternalGraphBuilder;
+
+
+
+
+
+	/**
+	 * \brief Memory footprint of a part of an object
+	 *
+	 * * \c name : name of the data structure;
+	 * * \c bytes : number of bytes currently allocated for it;
+	 * * \c peak_bytes : peak number of bytes allocated for it (see the object for the period
+	 * the peak is taken over).
+	 *
+	 * Capacities of containers are counted rather than their sizes, since containers do not
+	 * release memory when they shrink. Sizes of nodes of hash tables are estimated.
+	 */
+	using MemoryRecord      = struct MemoryRecordStruct {std::string name; uint64_t bytes; uint64_t peak_bytes;};
+
+	/**
+	 * \brief Memory footprint of an object broken down by its data structures
+	 */
+	using MemoryUsage       = std::vector<MemoryRecord>;
 
 
 
@@ -54,7 +79,59 @@ namespace rwe
 	 * non-negative integers up to \f$2^{32}-1\f$);
 	 * * \f$\{(v,w),(w,v)\} \subset E \Rightarrow l((v,w)) = l((w,v))\f$ (i.e., if one
 	 * can go both ways, the distance between end points is the same).
+	 * 
+	 * Each vertex of the graph (including the ones that only appear as a target of some edge)
+	 * is assigned a <b>dense index</b> which is the position of this vertex in the order of
+	 * insertion. Dense indices never change once assigned, and a hash index from IDs to dense
+	 * indices is maintained by every modification of the graph, so that both lookups and
+	 * insertions of vertices take constant time. Graphs constructed at once (e.g., loaded from
+	 * files) have their dense indices in the ascending order of IDs.
+	 * 
+	 * Lengths of edges are stored as values of type \c Real. Files store lengths as
+	 * <tt>long double</tt> (text files and \c rweg files of version 1) or \c double
+	 * (\c rweg files of version 2 and \c rwegz files) values, so each loaded length is
+	 * rounded to the nearest \c Real value and carries a relative error of at most the unit
+	 * roundoff \f$u\f$ of \c Real:
+	 * 
+	 * <table>
+	 * <tr align="center">
+	 *     <th>\c Real</th>
+	 *     <th>\f$u\f$</th>
+	 *     <th>Significant decimal digits</th>
+	 * </tr>
+	 * <tr align="center">
+	 *     <td>\c float</td>
+	 *     <td>\f$2^{-24} \approx 6.0 \cdot 10^{-8}\f$</td>
+	 *     <td>6</td>
+	 * </tr>
+	 * <tr align="center">
+	 *     <td>\c double</td>
+	 *     <td>\f$2^{-53} \approx 1.1 \cdot 10^{-16}\f$</td>
+	 *     <td>15</td>
+	 * </tr>
+	 * <tr align="center">
+	 *     <td><tt>long double</tt></td>
+	 *     <td>\f$2^{-64} \approx 5.4 \cdot 10^{-20}\f$</td>
+	 *     <td>18</td>
+	 * </tr>
+	 * </table>
+	 * 
+	 * The last row assumes the x87 80-bit format; on platforms where <tt>long double</tt> is
+	 * the same as \c double (e.g., MSVC), the second row applies instead. Lengths which are
+	 * positive but round to zero are rejected like any other non-positive length.
+	 * 
+	 * Edge attributes are stored column-wise: every edge is assigned an <b>edge ID</b>
+	 * \f$0,1,...,|E|-1\f$, and sources, targets, lengths and directions of all edges are kept in
+	 * separate contiguous arrays indexed by edge IDs (directions are packed into a bitmap of
+	 * 64-bit words). Each vertex only keeps the lists of IDs of its outgoing and incoming edges
+	 * sorted by the opposite end points, so that scans which only need one attribute (e.g.,
+	 * lengths) touch nothing else, and new attributes can be added as new columns without
+	 * changing the adjacency structure. Edge IDs are not stable: removal of an edge moves the
+	 * last edge into its place.
+	 * 
+	 * \tparam  Real    Type of lengths; \c float, \c double and <tt>long double</tt> are supported.
 	 */
+	template <typename Real>
 	class MetricGraph
 	{
 
@@ -123,7 +200,7 @@ namespace rwe
 		 * Checks whether vertex is present in the graph
 		 * 
 		 * This function helps to find out whether a vertex with specified ID is present in the
-		 * corresponding graph or not.
+		 * corresponding graph or not. Takes constant time.
 		 * 
 		 * \param   vertex  Vertex ID.
 		 * 
@@ -133,12 +210,32 @@ namespace rwe
 		 */
 		bool const                      checkVertex     (uint32_t const vertex)                             const;
 
+		/**
+		 * Get the number of vertices
+		 * 
+		 * This function helps to find out the number of vertices in the corresponding graph.
+		 * Takes constant time.
+		 * 
+		 * \return \f$|V|\f$.
+		 */
+		uint32_t const                  getVertexCount  (void)                                              const;
+
+		/**
+		 * Get the number of edges
+		 * 
+		 * This function helps to find out the number of edges in the corresponding graph (an
+		 * undirected edge is counted once). Takes constant time.
+		 * 
+		 * \return \f$|E|\f$.
+		 */
+		uint64_t const                  getEdgeCount    (void)                                              const;
+
 		/**
 		 * Get vector of vertices IDs
 		 * 
 		 * This function helps to find out the IDs of the vertices in the corresponding graph.
 		 * 
-		 * \return \c std::vector of vertices IDs, i.e. \f$V\f$.
+		 * \return \c std::vector of vertices IDs in ascending order, i.e. \f$V\f$.
 		 */
 		std::vector<uint32_t> const     getVertexList   (void)                                              const;
 
@@ -156,7 +253,57 @@ namespace rwe
 		 * \f$v \rightarrow w\f$ edge exists;
 		 * * Positive infinity, otherwise.
 		 */
-		long double const               getEdgeLength   (uint32_t const out_vertex, uint32_t in_vertex)     const;
+		Real const                      getEdgeLength   (uint32_t const out_vertex, uint32_t in_vertex)     const;
+
+		/**
+		 * Get out-neighbours of a vertex
+		 * 
+		 * This function helps to find out the IDs of the vertices \f$w\f$ such that either
+		 * \f$v-w\f$ edge or \f$v \rightarrow w\f$ edge exists. Takes time linear in the degree of
+		 * \f$v\f$.
+		 * 
+		 * \param   vertex  ID of vertex \f$v\f$.
+		 * 
+		 * \return \c std::vector of IDs in ascending order (empty if \f$v \notin V\f$).
+		 */
+		std::vector<uint32_t> const     getOutNeighbours        (uint32_t const vertex)                     const;
+
+		/**
+		 * Get in-neighbours of a vertex
+		 * 
+		 * This function helps to find out the IDs of the vertices \f$w\f$ such that either
+		 * \f$w-v\f$ edge or \f$w \rightarrow v\f$ edge exists. Takes time linear in the degree of
+		 * \f$v\f$.
+		 * 
+		 * \param   vertex  ID of vertex \f$v\f$.
+		 * 
+		 * \return \c std::vector of IDs in ascending order (empty if \f$v \notin V\f$).
+		 */
+		std::vector<uint32_t> const     getInNeighbours         (uint32_t const vertex)                     const;
+
+		/**
+		 * Get undirected neighbours of a vertex
+		 * 
+		 * This function helps to find out the IDs of the vertices \f$w\f$ such that \f$v-w\f$
+		 * edge exists. Takes time linear in the degree of \f$v\f$.
+		 * 
+		 * \param   vertex  ID of vertex \f$v\f$.
+		 * 
+		 * \return \c std::vector of IDs in ascending order (empty if \f$v \notin V\f$).
+		 */
+		std::vector<uint32_t> const     getUndirectedNeighbours (uint32_t const vertex)                     const;
+
+		/**
+		 * Get memory footprint
+		 * 
+		 * This function helps to find out how many bytes the graph holds in each of its data
+		 * structures: views of vertices, lists of IDs of their edges, columns of edge attributes
+		 * and the index of vertices. Takes time linear in \f$|V|\f$.
+		 * 
+		 * \return Memory footprint of the graph; the graph does not track peaks, so they equal
+		 * current values.
+		 */
+		MemoryUsage const               getMemoryUsage  (void)                                              const;
 
 		/**
 		 * Prints edge list into the stream
@@ -253,7 +400,9 @@ namespace rwe
 		 *                          if \c false, desired type of edge will be \f$v-w\f$.
 		 * 
 		 * \note All \c RWSpace objects associated with the respective metric graph will be
-		 * automatically transferred into the \c invalid state.
+		 * automatically transferred into the \c invalid state. If only the length of an existing
+		 * edge changes, they also record this edge, so that their next \ref RWSpace::reset only
+		 * updates it instead of recompiling the whole graph.
 		 * 
 		 * \throw invalid_argument if desired length is non-positive.
 		 * 
@@ -263,7 +412,7 @@ namespace rwe
 		 * Expected output:
 		 * \include MetricGraph_updateEdge_output.txt
 		 */
-		void updateEdge(uint32_t const out_vertex, uint32_t const in_vertex, long double const length, bool const is_directed = false);
+		void updateEdge(uint32_t const out_vertex, uint32_t const in_vertex, Real const length, bool const is_directed = false);
 		///@}
 
 
@@ -279,6 +428,12 @@ namespace rwe
 		 * <tt>.gexf</tt>, they will be added automatically.
 		 * 
 		 * The lengths of edges will be stored in the \c weight attribute of corresponding edges.
+		 * Each length is written with the fewest digits which \ref fromGEXF reads back as exactly
+		 * the same value of type \c Real (see rwe::formatReal).
+		 * 
+		 * Lines are formatted straight into reusable buffers; edges are split into blocks of
+		 * about 16 thousand lines which are formatted on all hardware threads and written in
+		 * order.
 		 * 
 		 * \param   file_name   Name of a target \c gexf file.
 		 * \param   rewrite     If \c false and a file with the specified name already exists, then
@@ -305,6 +460,14 @@ namespace rwe
 		 * \c source and \c target is repeated multiple times, it will be treated as it is described in
 		 * a table for \ref updateEdge function in the respective order of repetitions.
 		 * 
+		 * The file is mapped into memory (see MappedFile) and scanned only up to the beginning of
+		 * the \c edges section, so the default edge type is only taken into account if it is
+		 * specified before that section (as the \c gexf schema requires). The \c edges section is
+		 * then split at \c edge tags into chunks which are parsed on all hardware threads and
+		 * joined in the order of the file; everything after the \c edges section is ignored. If a
+		 * split point turns out to lie inside a malformed tag or a quoted value, the section is
+		 * parsed once again in a single pass, so the result never depends on the number of chunks.
+		 * 
 		 * \param   file_name   Name of a source \c gexf file.
 		 */
 		void    fromGEXF    (std::string const file_name);
@@ -316,6 +479,9 @@ namespace rwe
 		 * the name specified by user. If the last five symbols of target file name are not
 		 * <tt>.rweg</tt>, they will be added automatically.
 		 * 
+		 * Files are always written in version 2 of the format (see RWEGFile), so lengths are
+		 * rounded to \c double and isolated vertices are omitted.
+		 * 
 		 * \param   file_name   Name of a target \c rweg file.
 		 * \param   rewrite     If \c false and a file with the specified name already exists, then
 		 *                      it will not be rewritten but the ordinal number will be added to the
@@ -331,27 +497,498 @@ namespace rwe
 		 * one by adding all absent vertices, edges and updating their lengths and directions. If a
 		 * file with the specified name does not exist, the original data is left unchanged.
 		 * 
+		 * Both versions of the format are supported; files of version 2 are recognised by their
+		 * signature (see RWEGFile). If the graph is empty, a file of version 2 is copied into it
+		 * section by section, and edge IDs follow the order of edges in the file. Files of
+		 * version 1 are mapped into memory and split into chunks of records which are parsed
+		 * by separate threads.
+		 * 
 		 * \param   file_name   Name of a source \c rweg file.
+		 * 
+		 * \throw runtime_error if a file of version 2 is corrupted, or if the size of a file of
+		 * version 1 is not a multiple of the size of its records (e.g., the file was written on a
+		 * platform with a different size of <tt>long double</tt>).
 		 */
 		void    fromRWEG    (std::string const file_name);
 
+		/**
+		 * Save graph to \c rwegz file
+		 * 
+		 * This function saves respective metric graph to a compressed binary file of \c rwegz
+		 * format (see RWEGZFile) with the name specified by user. If the last six symbols of target
+		 * file name are not <tt>.rwegz</tt>, they will be added automatically.
+		 * 
+		 * Just like with \ref toRWEG, lengths are rounded to \c double and isolated vertices are
+		 * omitted.
+		 * 
+		 * \param   file_name   Name of a target \c rwegz file.
+		 * \param   rewrite     If \c false and a file with the specified name already exists, then
+		 *                      it will not be rewritten but the ordinal number will be added to the
+		 *                      name in parentheses (like <em>'My file name (1).rwegz'</em>, <em>'My
+		 *                      file name (2).rwegz'</em> and so on).
+		 * 
+		 * \return Name of the written file, so that it can be read back (e.g., to measure the
+		 * speed of decoding).
+		 */
+		std::string const   toRWEGZ (std::string const file_name = "Saved files/My metric graph", bool const rewrite = false)   const;
+
+		/**
+		 * Load graph from \c rwegz file
+		 * 
+		 * This function loads graph from the specified \c rwegz file and merges it with the existing
+		 * one by adding all absent vertices, edges and updating their lengths and directions. If the
+		 * last six symbols of source file name are not <tt>.rwegz</tt>, they will be added
+		 * automatically. If a file with the specified name does not exist, the original data is
+		 * left unchanged.
+		 * 
+		 * Blocks of the file are decoded on all hardware threads into the sections of an \c rweg
+		 * file of version 2, which are then loaded the same way as in \ref fromRWEG.
+		 * 
+		 * \param   file_name   Name of a source \c rwegz file.
+		 * 
+		 * \throw runtime_error if the file is corrupted.
+		 */
+		void    fromRWEGZ   (std::string const file_name);
+
+		/**
+		 * Load graph from an edge list
+		 * 
+		 * This function loads graph from the specified plain text file and merges it with the
+		 * existing one by adding all absent vertices, edges and updating their lengths and
+		 * directions. If a file with the specified name does not exist, the original data is left
+		 * unchanged. The name of the file is used as is.
+		 * 
+		 * Each line of the file describes one edge by 3 or 4 tokens separated by spaces or tabs:
+		 * 
+		 * <tt>source target length [type]</tt>
+		 * 
+		 * IDs of vertices must meet the requirements mentioned at the top of this page. The
+		 * optional type is either \c 1 or \c directed for a directed edge, or \c 0, \c undirected
+		 * or \c mutual for an undirected one; edges are undirected by default. Empty lines and
+		 * lines beginning with \c # or \c % are skipped. Repeated edges are treated the same way
+		 * as in \ref fromGEXF.
+		 * 
+		 * The file is mapped into memory (see MappedFile) and split into chunks of whole lines
+		 * which are parsed on all hardware threads.
+		 * 
+		 * \param   file_name   Name of a source edge list file.
+		 * 
+		 * \throw runtime_error if a line cannot be interpreted as an edge.
+		 */
+		void    fromEdgeList    (std::string const file_name);
+
+		/**
+		 * Load graph from \c mtx file
+		 * 
+		 * This function loads graph from the specified file of Matrix Market format and merges it
+		 * with the existing one by adding all absent vertices, edges and updating their lengths
+		 * and directions. If the last four symbols of source file name are not <tt>.mtx</tt>, they
+		 * will be added automatically. If a file with the specified name does not exist, the
+		 * original data is left unchanged.
+		 * 
+		 * The matrix is taken as an adjacency matrix: an entry in row \f$i\f$ and column
+		 * \f$j\f$ with value \f$l\f$ stands for an edge of length \f$l\f$ between vertices with
+		 * IDs \f$i-1\f$ and \f$j-1\f$. The following additional requirements need to be met:
+		 * 
+		 * * The matrix must be square and stored in the \c coordinate format;
+		 * * The field must be \c real, \c double, \c integer or \c pattern (in which case all
+		 * lengths are 1);
+		 * * The symmetry must be \c general (entries stand for edges \f$i-1 \rightarrow j-1\f$) or
+		 * \c symmetric (entries stand for edges \f$i-1 - j-1\f$).
+		 * 
+		 * The file is mapped into memory (see MappedFile) and its entries are split into chunks of
+		 * whole lines which are parsed on all hardware threads.
+		 * 
+		 * \param   file_name   Name of a source \c mtx file.
+		 * 
+		 * \throw runtime_error if the file does not meet the requirements above, or if the number
+		 * of entries differs from the one in the size line.
+		 */
+		void    fromMatrixMarket (std::string const file_name);
+
+		/**
+		 * Load graph from \c graph file
+		 * 
+		 * This function loads graph from the specified file of METIS format and merges it with
+		 * the existing one by adding all absent vertices, edges and updating their lengths. If the
+		 * last six symbols of source file name are not <tt>.graph</tt>, they will be added
+		 * automatically. If a file with the specified name does not exist, the original data is
+		 * left unchanged.
+		 * 
+		 * METIS files describe undirected graphs with vertices numbered from 1; vertex \f$i\f$
+		 * gets ID \f$i-1\f$. Edge weights, if present, are taken as lengths, otherwise all
+		 * lengths are 1. Sizes and weights of vertices are skipped. Each edge is listed by both of
+		 * its end points and is taken from the line of the one with the lesser index.
+		 * 
+		 * The file is mapped into memory (see MappedFile) and split into chunks of whole lines
+		 * which are parsed on all hardware threads, once the lines of each chunk are counted.
+		 * 
+		 * \param   file_name   Name of a source \c graph file.
+		 * 
+		 * \throw runtime_error if the file cannot be interpreted, or if the numbers of vertices or
+		 * edges differ from the ones in the header.
+		 */
+		void    fromMETIS   (std::string const file_name);
+
 		///@}
 	private:
-		friend class RWSpace;
+		friend class RWSpace<Real>;
+		friend class CompiledGraph<Real>;
+		friend class MetricGraphBuilder<Real>;
 
 		using VertexList            = std::vector<uint32_t>;
-		using LengthList            = std::vector<long double>;
-		using DirectionList         = std::vector<bool>;
-		using VertexView            = struct {uint32_t id; VertexList adjacents; LengthList lengths; DirectionList is_directed;};
+		using EdgeIDList            = std::vector<uint64_t>;
+		using LengthColumn          = std::vector<Real>;
+		using DirectionColumn       = std::vector<uint64_t>;
+		using VertexView            = struct {uint32_t id; EdgeIDList out_edges; EdgeIDList in_edges;};
 		using EdgeList              = std::vector<VertexView>;
+		using EdgeColumns           = struct {VertexList sources; VertexList targets; LengthColumn lengths; DirectionColumn directions;};
 		using Edge                  = std::pair<uint32_t, uint32_t>;
 
+		using VertexIndex           = std::unordered_map<uint32_t, uint32_t>;
+
 		EdgeList                edges;
-		std::vector<RWSpace *>   associated_wanders;
+		EdgeColumns             edge_columns;
+		VertexIndex             vertex_index;
+		std::vector<RWSpace<Real> *>    associated_wanders;
 
 		// Access
 		Edge                getEdge             (uint32_t const out_vertex, uint32_t const in_vertex, bool const is_directed = true, bool const strict_mode = false) const;
-		std::deque<Edge>    getDepartingEdges   (uint32_t const out_vertex) const;
+		uint32_t const      findOutEdge         (VertexView const &out_view, uint32_t const in_vertex) const;
+		uint32_t const      findInEdge          (VertexView const &in_view, uint32_t const out_vertex) const;
+		bool const          isDirected          (uint64_t const edge) const;
+		std::vector<uint32_t> const getSortedIndices    (void) const;
+
+		// Modifiers
+		uint32_t            addVertex           (uint32_t const vertex);
+		void                insertEdge          (uint32_t const out_vertex, uint32_t const in_vertex, Real const length, bool const is_directed);
+		void                eraseEdge           (uint64_t const edge);
+		void                setDirected         (uint64_t const edge, bool const is_directed);
+
+		// Layout
+		void                layOutCSR           (std::vector<uint32_t> &vertex_ids, std::vector<uint64_t> &offsets, std::vector<uint32_t> &targets, std::vector<double> &lengths, std::vector<uint64_t> &directions) const;
+		void                loadCSR             (uint32_t const vertex_count, uint64_t const edge_count, uint32_t const *vertex_ids, uint64_t const *offsets, uint32_t const *targets, double const *lengths, uint64_t const *directions);
+	};
+
+
+
+
+
+	/**
+	 * \class MetricGraphBuilder
+	 * \brief A batch builder of metric graphs
+	 * 
+	 * Metric graph builder accumulates raw edge records and then materialises all of them in a
+	 * MetricGraph object at once. Records are sorted, all records that describe the same pair
+	 * of vertices are merged and the graph is laid out in a single pass, so that building a
+	 * graph with \f$|E|\f$ records takes \f$O(|E| \log |E|)\f$ time regardless of vertex
+	 * degrees.
+	 * 
+	 * The result is exactly the same as if \ref MetricGraph::updateEdge was called for each
+	 * record in the order of their addition (see the table in its description).
+	 * 
+	 * \tparam  Real    Type of lengths of the target metric graph.
+	 */
+	template <typename Real>
+	class MetricGraphBuilder
+	{
+
+
+
+	public:
+
+
+
+		/// \name Constructors and destructors
+		///@{
+
+		/**
+		 * Default constructor
+		 * 
+		 * Constructs a builder with no records.
+		 */
+		MetricGraphBuilder      (void);
+
+		///@}
+
+
+
+		/// \name Accessors
+		///@{
+
+		/**
+		 * Get the number of pending records
+		 * 
+		 * \return Number of records added since the last call of \ref build.
+		 */
+		uint64_t const  getRecordCount  (void)                          const;
+
+		///@}
+
+
+
+		/// \name Modifiers
+		///@{
+
+		/**
+		 * Reserve memory for records
+		 * 
+		 * \param   record_count    Expected number of records.
+		 */
+		void            reserve         (uint64_t const record_count);
+
+		/**
+		 * Add edge record
+		 * 
+		 * Adds a record which will be processed as \ref MetricGraph::updateEdge call with the
+		 * same parameters.
+		 * 
+		 * \param   out_vertex      ID of vertex \f$v\f$.
+		 * \param   in_vertex       ID of vertex \f$w\f$.
+		 * \param   length          Desired length of edge between \f$v\f$ and \f$w\f$.
+		 * \param   is_directed     If \c true, desired type of edge will be \f$v \rightarrow w\f$,
+		 *                          if \c false, desired type of edge will be \f$v-w\f$.
+		 * 
+		 * \throw invalid_argument if desired length is non-positive.
+		 */
+		void            addEdge         (uint32_t const out_vertex, uint32_t const in_vertex, Real const length, bool const is_directed = false);
+
+		/**
+		 * Append records of another builder
+		 * 
+		 * Moves all pending records of another builder after the pending records of this one,
+		 * so that several builders filled in parallel may be joined in the order of their
+		 * sources.
+		 * 
+		 * \param   other   A builder to take records from; it is left with no records.
+		 */
+		void            append          (MetricGraphBuilder &&other);
+
+		/**
+		 * Build the graph
+		 * 
+		 * Merges all pending records into the specified metric graph. Existing edges of the
+		 * graph are treated as if they had been added before all pending records. After the
+		 * call the builder contains no records.
+		 * 
+		 * \param   graph   Target metric graph.
+		 * 
+		 * \note All \c RWSpace objects associated with the target metric graph will be
+		 * automatically transferred into the \c invalid state.
+		 */
+		void            build           (MetricGraph<Real> &graph);
+
+		///@}
+	private:
+		friend class ExternalGraphBuilder<Real>;
+
+		using EdgeRecord            = struct {uint32_t out_vertex; uint32_t in_vertex; Real length; bool is_directed;};
+
+		std::vector<EdgeRecord>     records;
+	};
+
+
+
+
+
+	/**
+	 * \class ExternalGraphBuilder
+	 * \brief A builder of metric graph files which do not fit into memory
+	 * 
+	 * External graph builder accepts the same edge records as MetricGraphBuilder, but never
+	 * materialises the graph: it converts a sequence of records straight into a file whose
+	 * contents are exactly the same as if the records had been built into an empty MetricGraph
+	 * which had then been saved (see \ref MetricGraph::toRWEG and \ref MetricGraph::toGEXF).
+	 * 
+	 * Records are buffered up to the memory budget; a full buffer is sorted by unordered pairs of
+	 * vertices, folded the same way as in \ref MetricGraphBuilder::build and spilled to a
+	 * temporary file as a sorted <b>run</b>. On save, runs are joined by a k-way merge (in
+	 * several passes if there are more than 64 of them) which folds records of the same pair
+	 * from different runs in the order of their addition. The folded edges are spilled once
+	 * again in the order of MetricGraph and merged while the target file is written
+	 * sequentially.
+	 * 
+	 * The buffer of records takes a half of the budget, the other half is taken by sorting it
+	 * or by the buffers of runs being merged. Besides the budget, the builder keeps IDs of
+	 * vertices in memory, which take up to 8 bytes per vertex while the edges are sorted and 4
+	 * bytes per vertex afterwards, and the target file is written through buffers of a few MiB.
+	 * Names of temporary files begin with the prefix passed to the
+	 * constructor followed by a suffix unique to the builder, so that several builders may share
+	 * the prefix; the files are removed by the destructor.
+	 * 
+	 * \tparam  Real    Type of lengths of the target metric graph.
+	 */
+	template <typename Real>
+	class ExternalGraphBuilder
+	{
+
+
+
+	public:
+
+
+
+		/// \name Constructors and destructors
+		///@{
+
+		/**
+		 * Budget constructor
+		 * 
+		 * Constructs a builder with no records.
+		 * 
+		 * \param   memory_budget   Number of bytes the builder may use for records and buffers of
+		 *                          runs; it is rounded up to fit at least 2048 records.
+		 * \param   temp_file_name  Prefix of names of temporary files, e.g., the name of the target
+		 *                          file; it is followed by a suffix unique to the builder.
+		 */
+		ExternalGraphBuilder    (uint64_t const memory_budget, std::string const temp_file_name = "Saved files/My metric graph");
+
+		/**
+		 * Destructor
+		 * 
+		 * Removes all temporary files.
+		 */
+		~ExternalGraphBuilder   (void);
+
+		// Prevent implicit creation of copy-constructor and the copy assignment operator
+		ExternalGraphBuilder                (ExternalGraphBuilder &)    = delete;
+		ExternalGraphBuilder &  operator =  (ExternalGraphBuilder &)    = delete;
+
+		///@}
+
+
+
+		/// \name Accessors
+		///@{
+
+		/**
+		 * Get the number of records
+		 * 
+		 * \return Number of records added since the last save or \ref clear.
+		 */
+		uint64_t const  getRecordCount  (void)                          const;
+
+		/**
+		 * Get the number of runs
+		 * 
+		 * \return Number of runs spilled to temporary files so far.
+		 */
+		uint64_t const  getRunCount     (void)                          const;
+
+		///@}
+
+
+
+		/// \name Modifiers
+		///@{
+
+		/**
+		 * Add edge record
+		 * 
+		 * The same as \ref MetricGraphBuilder::addEdge. If the buffer is full, it is spilled.
+		 * 
+		 * \param   out_vertex      ID of vertex \f$v\f$.
+		 * \param   in_vertex       ID of vertex \f$w\f$.
+		 * \param   length          Desired length of edge between \f$v\f$ and \f$w\f$.
+		 * \param   is_directed     If \c true, desired type of edge will be \f$v \rightarrow w\f$,
+		 *                          if \c false, desired type of edge will be \f$v-w\f$.
+		 * 
+		 * \throw invalid_argument if desired length is non-positive.
+		 */
+		void            addEdge         (uint32_t const out_vertex, uint32_t const in_vertex, Real const length, bool const is_directed = false);
+
+		/**
+		 * Append records of a builder
+		 * 
+		 * Moves all pending records of a MetricGraphBuilder after the records of this builder.
+		 * 
+		 * \param   other   A builder to take records from; it is left with no records.
+		 */
+		void            append          (MetricGraphBuilder<Real> &&other);
+
+		/**
+		 * Remove all records
+		 * 
+		 * Drops the buffer and removes all temporary files.
+		 */
+		void            clear           (void);
+
+		///@}
+
+
+
+		/// \name Save/load
+		///@{
+
+		/**
+		 * Add records from \c gexf file
+		 * 
+		 * Reads the file the same way as \ref MetricGraph::fromGEXF, but the \c edges section is
+		 * taken in windows of about a half of the budget, each of which is split into chunks
+		 * parsed on all hardware threads. If the \c edges section turns out to be incomplete,
+		 * records of this file are dropped.
+		 * 
+		 * \param   file_name   Name of a source \c gexf file.
+		 */
+		void            fromGEXF        (std::string const file_name);
+
+		/**
+		 * Add records from \c rweg file
+		 * 
+		 * Reads both versions of the format the same way as \ref MetricGraph::fromRWEG, but
+		 * record by record right from the mapping of the file.
+		 * 
+		 * \param   file_name   Name of a source \c rweg file.
+		 * 
+		 * \throw runtime_error in the same cases as \ref MetricGraph::fromRWEG.
+		 */
+		void            fromRWEG        (std::string const file_name);
+
+		/**
+		 * Save graph to \c gexf file
+		 * 
+		 * Writes the graph made of all records the same way as \ref MetricGraph::toGEXF. After
+		 * the call the builder contains no records.
+		 * 
+		 * \param   file_name   Name of a target \c gexf file.
+		 * \param   rewrite     The same as in \ref MetricGraph::toGEXF.
+		 */
+		void            toGEXF          (std::string const file_name = "Saved files/My metric graph", bool const rewrite = false);
+
+		/**
+		 * Save graph to \c rweg file
+		 * 
+		 * Writes the graph made of all records the same way as \ref MetricGraph::toRWEG. Each
+		 * section is written sequentially at its own offset, the header is written last, when
+		 * the checksum is known. After the call the builder contains no records.
+		 * 
+		 * \param   file_name   Name of a target \c rweg file.
+		 * \param   rewrite     The same as in \ref MetricGraph::toRWEG.
+		 */
+		void            toRWEG          (std::string const file_name = "Saved files/My metric graph", bool const rewrite = false);
+
+		///@}
+	private:
+		using EdgeRecord            = typename MetricGraphBuilder<Real>::EdgeRecord;
+
+		uint64_t                    memory_budget;
+		std::string                 temp_file_name;
+		std::vector<EdgeRecord>     records;
+		std::vector<std::string>    runs;
+		uint64_t                    run_counter;
+		uint64_t                    record_count;
+
+		// Runs
+		uint64_t const              getBufferSize   (void)              const;
+		std::string const           getRunName      (uint64_t const run_number) const;
+		void                        writeRun        (void);
+		void                        spill           (void);
+		void                        dropRuns        (uint64_t const first_run);
+		template <typename Comparator>
+		void                        reduceRuns      (Comparator const &is_less);
+		uint64_t const              sortEdges       (std::vector<uint32_t> &vertex_ids);
+		template <typename Consumer>
+		void                        forEachEdge     (Consumer const &consume);
 	};
 
 
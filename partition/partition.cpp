@@ -0,0 +1,295 @@
+/**
+ * \file
+ *       partition.cpp
+ *
+ * \author
+ *       Andrei Eliseev (JointPoints), 2021
+ */
+#include "partition.hpp"
+
+#include <stdexcept>    // needed for exceptions
+#include <algorithm>    // needed for "max"
+#include <numeric>      // needed for "iota"
+
+
+
+
+
+// Constructors and destructors
+
+
+
+
+
+template <typename Real>
+rwe::GraphPartition<Real>::GraphPartition(CompiledGraph<Real> const &graph, uint32_t const part_count, Real const imbalance) :
+	vertex_parts(graph.getVertexCount(), 0), part_offsets(), part_vertices(), part_lengths(part_count, Real(0)), cut_edge_count(0)
+{
+	uint32_t const              vertex_count        = graph.getVertexCount();
+	uint32_t const              max_pass_count      = 8;
+	std::vector<Real>           vertex_lengths(vertex_count, Real(0));
+	std::vector<uint64_t>       neighbour_offsets(vertex_count + 1, 0);
+	std::vector<uint32_t>       neighbours;
+	std::vector<uint32_t>       order(vertex_count);
+	std::vector<uint32_t>       range_begins(vertex_count, 0);
+	std::vector<uint32_t>       visit_stamps(vertex_count, 0);
+	uint32_t                    visit_stamp         = 0;
+	std::vector<uint32_t>       queue;
+	std::vector<Range>          ranges;
+	Real                        total_length        = 0;
+	Real                        max_vertex_length   = 0;
+
+	// 1. <part_count> must be positive and <imbalance> must be non-negative
+	if (part_count == 0)
+		throw std::invalid_argument("Number of parts must be positive.");
+	if (imbalance < 0)
+		throw std::invalid_argument("Allowed imbalance must be non-negative.");
+
+	// 2. Weigh each vertex with the total length of edges stored under it and collect neighbours of
+	//    each vertex regardless of directions (loops are never cut, so they are skipped)
+	for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+	{
+		for (uint64_t edge_i = graph.offsets[vertex_1]; edge_i < graph.offsets[vertex_1 + 1]; ++edge_i)
+		{
+			vertex_lengths[vertex_1] += graph.lengths[edge_i];
+			if (graph.targets[edge_i] != vertex_1)
+			{
+				++neighbour_offsets[vertex_1 + 1];
+				++neighbour_offsets[graph.targets[edge_i] + 1];
+			}
+		}
+		total_length += vertex_lengths[vertex_1];
+		max_vertex_length = std::max(max_vertex_length, vertex_lengths[vertex_1]);
+	}
+	for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+		neighbour_offsets[vertex_1 + 1] += neighbour_offsets[vertex_1];
+	neighbours.resize(neighbour_offsets.back());
+	{
+		std::vector<uint64_t> neighbour_cursors(neighbour_offsets.begin(), neighbour_offsets.end() - 1);
+
+		for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+			for (uint64_t edge_i = graph.offsets[vertex_1]; edge_i < graph.offsets[vertex_1 + 1]; ++edge_i)
+				if (graph.targets[edge_i] != vertex_1)
+				{
+					neighbours[neighbour_cursors[vertex_1]++] = graph.targets[edge_i];
+					neighbours[neighbour_cursors[graph.targets[edge_i]]++] = vertex_1;
+				}
+	}
+
+	Real const max_part_length = std::max(total_length / part_count * (1 + imbalance), total_length / part_count + max_vertex_length);
+
+	// Breadth-first search over the vertices of a range, the vertex to start from goes first and the
+	// vertices unreachable from it follow; returns the number of vertices reachable from the start
+	auto const search = [&](Range const &range, uint32_t const root)
+	{
+		uint32_t    reached_count   = 0;
+		auto const  expand          = [&](uint32_t const seed)
+		{
+			if (visit_stamps[seed] == visit_stamp)
+				return;
+			visit_stamps[seed] = visit_stamp;
+			queue.push_back(seed);
+			for (uint32_t head = queue.size() - 1; head < queue.size(); ++head)
+				for (uint64_t neighbour_i = neighbour_offsets[queue[head]]; neighbour_i < neighbour_offsets[queue[head] + 1]; ++neighbour_i)
+				{
+					uint32_t const neighbour = neighbours[neighbour_i];
+
+					if ((range_begins[neighbour] == range.begin) && (visit_stamps[neighbour] != visit_stamp))
+					{
+						visit_stamps[neighbour] = visit_stamp;
+						queue.push_back(neighbour);
+					}
+				}
+		};
+
+		++visit_stamp;
+		queue.clear();
+		expand(root);
+		reached_count = queue.size();
+		for (uint32_t order_i = range.begin; order_i < range.end; ++order_i)
+			expand(order[order_i]);
+
+		return reached_count;
+	};
+
+	// 3. Split the graph by recursive bisection: each range of <order> is searched in the breadth-first
+	//    order starting at a pseudo-peripheral vertex and cut in proportion to the numbers of parts
+	//    on both sides, a vertex goes to the second half once the middle of its weight exceeds the
+	//    share of the first one
+	std::iota(order.begin(), order.end(), 0);
+	ranges.push_back(Range{0, vertex_count, 0, part_count});
+	while (!ranges.empty())
+	{
+		Range const curr_range = ranges.back();
+		ranges.pop_back();
+
+		// 3.1. A single part takes the whole range
+		if ((curr_range.part_count == 1) || (curr_range.begin == curr_range.end))
+		{
+			for (uint32_t order_i = curr_range.begin; order_i < curr_range.end; ++order_i)
+			{
+				this->vertex_parts[order[order_i]] = curr_range.first_part;
+				this->part_lengths[curr_range.first_part] += vertex_lengths[order[order_i]];
+			}
+			continue;
+		}
+
+		// 3.2. The last vertex reached by the search is far from its start; a few searches are enough
+		//      to find a vertex which is far from most of the others
+		uint32_t root = order[curr_range.begin];
+
+		for (uint32_t search_i = 0; search_i < 3; ++search_i)
+			root = queue[search(curr_range, root) - 1];
+
+		// 3.3. Cut the search order
+		uint32_t const  first_part_count    = curr_range.part_count / 2;
+		Real            range_length        = 0;
+		Real            accumulated_length  = 0;
+		uint32_t        split               = curr_range.begin;
+
+		for (uint32_t order_i = curr_range.begin; order_i < curr_range.end; ++order_i)
+			range_length += vertex_lengths[order[order_i]];
+		for (uint32_t queue_i = 0; queue_i < queue.size(); ++queue_i)
+		{
+			order[curr_range.begin + queue_i] = queue[queue_i];
+			if (accumulated_length + vertex_lengths[queue[queue_i]] / 2 <= range_length * first_part_count / curr_range.part_count)
+				split = curr_range.begin + queue_i + 1;
+			accumulated_length += vertex_lengths[queue[queue_i]];
+		}
+		for (uint32_t order_i = split; order_i < curr_range.end; ++order_i)
+			range_begins[order[order_i]] = split;
+		ranges.push_back(Range{curr_range.begin, split, curr_range.first_part, first_part_count});
+		ranges.push_back(Range{split, curr_range.end, curr_range.first_part + first_part_count, curr_range.part_count - first_part_count});
+	}
+
+	// 4. Refine the partition: move each vertex to the part most of its neighbours belong to, if the
+	//    balance allows it; ties are broken in favour of lighter parts, so that no move is ever undone
+	{
+		std::vector<uint64_t> connections(part_count, 0);
+		std::vector<uint32_t> touched_parts;
+
+		for (uint32_t pass_i = 0; pass_i < max_pass_count; ++pass_i)
+		{
+			uint64_t move_count = 0;
+
+			for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+			{
+				uint32_t const  own_part    = this->vertex_parts[vertex_1];
+				uint32_t        best_part   = own_part;
+				auto const      length_after    = [&](uint32_t const part){return (part == own_part) ? (this->part_lengths[part]) : (this->part_lengths[part] + vertex_lengths[vertex_1]);};
+
+				// 4.1. Count neighbours in each part
+				touched_parts.clear();
+				for (uint64_t neighbour_i = neighbour_offsets[vertex_1]; neighbour_i < neighbour_offsets[vertex_1 + 1]; ++neighbour_i)
+					if (connections[this->vertex_parts[neighbours[neighbour_i]]]++ == 0)
+						touched_parts.push_back(this->vertex_parts[neighbours[neighbour_i]]);
+
+				// 4.2. Choose the best part
+				for (uint32_t touched_i = 0; touched_i < touched_parts.size(); ++touched_i)
+				{
+					uint32_t const candidate = touched_parts[touched_i];
+
+					if ((candidate == own_part) || (length_after(candidate) > max_part_length))
+						continue;
+					if ((connections[candidate] > connections[best_part]) || ((connections[candidate] == connections[best_part]) && (length_after(candidate) < length_after(best_part))))
+						best_part = candidate;
+				}
+				for (uint32_t touched_i = 0; touched_i < touched_parts.size(); ++touched_i)
+					connections[touched_parts[touched_i]] = 0;
+
+				// 4.3. Move the vertex
+				if (best_part != own_part)
+				{
+					this->part_lengths[own_part] -= vertex_lengths[vertex_1];
+					this->part_lengths[best_part] += vertex_lengths[vertex_1];
+					this->vertex_parts[vertex_1] = best_part;
+					++move_count;
+				}
+			}
+			if (move_count == 0)
+				break;
+		}
+	}
+
+	// 5. List vertices of each part
+	this->part_offsets.assign(part_count + 1, 0);
+	for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+		++this->part_offsets[this->vertex_parts[vertex_1] + 1];
+	for (uint32_t part = 0; part < part_count; ++part)
+		this->part_offsets[part + 1] += this->part_offsets[part];
+	this->part_vertices.resize(vertex_count);
+	{
+		std::vector<uint32_t> part_cursors(this->part_offsets.begin(), this->part_offsets.end() - 1);
+
+		for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+			this->part_vertices[part_cursors[this->vertex_parts[vertex_1]]++] = vertex_1;
+	}
+
+	// 6. Count cut edges
+	for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+		for (uint64_t edge_i = graph.offsets[vertex_1]; edge_i < graph.offsets[vertex_1 + 1]; ++edge_i)
+			if (this->vertex_parts[graph.targets[edge_i]] != this->vertex_parts[vertex_1])
+				++this->cut_edge_count;
+}
+
+
+
+
+
+// Access
+
+
+
+
+
+template <typename Real>
+uint32_t const rwe::GraphPartition<Real>::getPartCount(void) const
+{
+	return this->part_lengths.size();
+}
+
+
+
+template <typename Real>
+uint32_t const rwe::GraphPartition<Real>::getVertexPart(uint32_t const vertex_index) const
+{
+	return this->vertex_parts[vertex_index];
+}
+
+
+
+template <typename Real>
+std::vector<uint32_t> const rwe::GraphPartition<Real>::getPartVertices(uint32_t const part) const
+{
+	return std::vector<uint32_t>(this->part_vertices.begin() + this->part_offsets[part], this->part_vertices.begin() + this->part_offsets[part + 1]);
+}
+
+
+
+template <typename Real>
+Real const rwe::GraphPartition<Real>::getPartLength(uint32_t const part) const
+{
+	return this->part_lengths[part];
+}
+
+
+
+template <typename Real>
+uint64_t const rwe::GraphPartition<Real>::getCutEdgeCount(void) const
+{
+	return this->cut_edge_count;
+}
+
+
+
+
+
+// Explicit instantiations
+
+
+
+
+
+template class rwe::GraphPartition<float>;
+template class rwe::GraphPartition<double>;
+template class rwe::GraphPartition<long double>;
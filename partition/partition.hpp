@@ -0,0 +1,153 @@
+/**
+ * \file
+ *       partition.hpp
+ *
+ * \author
+ *       Andrei Eliseev (JointPoints), 2021
+ */
+#ifndef RWE__PARTITION_HPP__
+#define RWE__PARTITION_HPP__
+
+
+
+
+
+#include "../compiled_graph/compiled_graph.hpp" // needed for "CompiledGraph"
+#include <vector>                               // needed for "vector"
+#include <cstdint>                              // needed for "int*_t" and "uint*_t" types
+
+
+
+
+
+namespace rwe
+{
+
+
+
+
+
+	/**
+	 * \class GraphPartition
+	 * \brief A partition of a compiled graph into several parts
+	 *
+	 * Graph partition splits vertices of a CompiledGraph object into \f$k\f$ disjoint
+	 * <b>parts</b>, so that each part may be owned by a separate emulation thread or worker
+	 * process. Each edge belongs to the part of the vertex it is stored under in the compiled
+	 * graph, so that the owner of a part owns whole rows of edges together with their states.
+	 *
+	 * Two goals are pursued:
+	 *
+	 * * <b>balance</b>: total lengths of edges of the parts, which serve as a proxy for the
+	 * number of agent instances the owners will have to move, should be close to each other;
+	 * * <b>small cut</b>: the number of <b>cut edges</b>, i.e., edges whose end points belong to
+	 * different parts, should be small, since every agent instance reaching the end of a cut
+	 * edge spawns new agent instances in another part.
+	 *
+	 * The partition is first built by recursive bisection: the graph is searched in the
+	 * breadth-first order starting at a vertex far from most of the others, and the search
+	 * order is cut in proportion to the numbers of parts on both sides, so that each part is a
+	 * compact region where possible. Then it is refined by moving boundary vertices to the
+	 * neighbouring parts most of their edges lead to, as long as the balance allows it. The whole
+	 * procedure takes \f$O((|V| + |E|) \log k)\f$ time. Directions of edges are ignored.
+	 *
+	 * \tparam  Real    Type of lengths, the same as the one of the compiled graph.
+	 */
+	template <typename Real>
+	class GraphPartition
+	{
+
+
+
+	public:
+
+
+
+		/// \name Constructors and destructors
+		///@{
+
+		/**
+		 * Partitioning constructor
+		 *
+		 * Splits the specified compiled graph into the specified number of parts.
+		 *
+		 * \param   graph           A compiled graph to partition.
+		 * \param   part_count      Number of parts \f$k\f$.
+		 * \param   imbalance       Allowed relative excess of the total length of edges of each
+		 *                          part over \f$1/k\f$ of the total length of the graph. The bound
+		 *                          is relaxed to fit the heaviest vertex, if needed.
+		 *
+		 * \throw invalid_argument if \c part_count is zero or \c imbalance is negative.
+		 */
+		GraphPartition              (CompiledGraph<Real> const &graph, uint32_t const part_count, Real const imbalance = 0.05);
+
+		///@}
+
+
+
+		/// \name Accessors
+		///@{
+
+		/**
+		 * Get the number of parts
+		 *
+		 * \return \f$k\f$.
+		 */
+		uint32_t const                  getPartCount        (void)                          const;
+
+		/**
+		 * Get part of a vertex
+		 *
+		 * \param   vertex_index    Dense index of the vertex in the compiled graph.
+		 *
+		 * \return Number of the part from \f$0\f$ to \f$k-1\f$.
+		 */
+		uint32_t const                  getVertexPart       (uint32_t const vertex_index)   const;
+
+		/**
+		 * Get vertices of a part
+		 *
+		 * \param   part    Number of the part.
+		 *
+		 * \return \c std::vector of dense indices of vertices of the part in ascending order.
+		 */
+		std::vector<uint32_t> const     getPartVertices     (uint32_t const part)           const;
+
+		/**
+		 * Get total length of a part
+		 *
+		 * \param   part    Number of the part.
+		 *
+		 * \return Total length of edges stored under vertices of the part.
+		 */
+		Real const                      getPartLength       (uint32_t const part)           const;
+
+		/**
+		 * Get the number of cut edges
+		 *
+		 * \return Number of edges whose end points belong to different parts.
+		 */
+		uint64_t const                  getCutEdgeCount     (void)                          const;
+
+		///@}
+	private:
+		using Range                 = struct {uint32_t begin; uint32_t end; uint32_t first_part; uint32_t part_count;};
+
+		std::vector<uint32_t>       vertex_parts;
+		std::vector<uint32_t>       part_offsets;
+		std::vector<uint32_t>       part_vertices;
+		std::vector<Real>           part_lengths;
+		uint64_t                    cut_edge_count;
+	};
+
+
+
+
+
+} // rwe
+
+
+
+
+
+#endif // RWE__PARTITION_HPP__
@@ -0,0 +1,219 @@
+/**
+ * \file
+ *       planner.cpp
+ *
+ * \author
+ *       Andrei Eliseev (JointPoints), 2021
+ */
+#include "planner.hpp"
+
+#include <algorithm>    // needed for "lower_bound", "binary_search", "set_union", "min", "max"
+#include <functional>   // needed for "greater"
+#include <iterator>     // needed for "back_inserter"
+#include <limits>       // needed for "numeric_limits"
+#include <queue>        // needed for "priority_queue"
+#include <utility>      // needed for "pair"
+
+
+
+
+
+namespace
+{
+	// Runs Dijkstra's algorithm from <source> over the undirected arcs of the graph and returns the farthest vertex
+	// reached together with its distance
+	std::pair<long double, uint32_t> const sweep(uint32_t const source, std::vector<uint64_t> const &offsets, std::vector<std::pair<uint32_t, long double>> const &arcs)
+	{
+		std::vector<long double>            distances(offsets.size() - 1, std::numeric_limits<long double>::infinity());
+		std::priority_queue<std::pair<long double, uint32_t>, std::vector<std::pair<long double, uint32_t>>, std::greater<std::pair<long double, uint32_t>>> queue;
+		std::pair<long double, uint32_t>    farthest(0.0L, source);
+
+		distances[source] = 0.0L;
+		queue.emplace(0.0L, source);
+		while (!queue.empty())
+		{
+			std::pair<long double, uint32_t> const curr = queue.top();
+
+			queue.pop();
+			if (curr.first > distances[curr.second])
+				continue;
+			farthest = std::max(farthest, curr);
+			for (uint64_t arc_i = offsets[curr.second]; arc_i < offsets[curr.second + 1]; ++arc_i)
+				if (curr.first + arcs[arc_i].second < distances[arcs[arc_i].first])
+				{
+					distances[arcs[arc_i].first] = curr.first + arcs[arc_i].second;
+					queue.emplace(distances[arcs[arc_i].first], arcs[arc_i].first);
+				}
+		}
+
+		return farthest;
+	}
+}
+
+
+
+
+
+// Constructors and destructors
+
+
+
+
+
+template <typename Real>
+rwe::RunPlanner<Real>::RunPlanner(void) :
+	degree_histogram(), edge_count(0), min_length(0.0L), max_length(0.0L), total_length(0.0L), diameter_estimate(0.0L)
+{
+	// Intended to be empty
+}
+
+
+
+template <typename Real>
+rwe::RunPlanner<Real>::RunPlanner(MetricGraph<Real> const &graph) :
+	degree_histogram(), edge_count(graph.getEdgeCount()), min_length(0.0L), max_length(0.0L), total_length(0.0L), diameter_estimate(0.0L)
+{
+	std::vector<uint32_t> const                             vertex_ids          = graph.getVertexList();
+	uint32_t const                                          vertex_count        = vertex_ids.size();
+	std::vector<uint64_t>                                   offsets(1, 0);
+	std::vector<std::pair<uint32_t, long double>>           arcs;
+
+	// 1. Collect neighbours of each vertex regardless of directions of edges, together with lengths and degrees
+	for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+	{
+		uint32_t const              vertex                  = vertex_ids[vertex_1];
+		std::vector<uint32_t> const out_neighbours          = graph.getOutNeighbours(vertex);
+		std::vector<uint32_t> const in_neighbours           = graph.getInNeighbours(vertex);
+		std::vector<uint32_t> const undirected_neighbours   = graph.getUndirectedNeighbours(vertex);
+		std::vector<uint32_t>       neighbours;
+		uint32_t                    degree                  = 0;
+
+		std::set_union(out_neighbours.begin(), out_neighbours.end(), in_neighbours.begin(), in_neighbours.end(), std::back_inserter(neighbours));
+		for (uint32_t neighbour_i = 0; neighbour_i < neighbours.size(); ++neighbour_i)
+		{
+			long double const length = std::min<long double>(graph.getEdgeLength(vertex, neighbours[neighbour_i]), graph.getEdgeLength(neighbours[neighbour_i], vertex));
+
+			// 1.1. Edges leaving the vertex are counted once, at their tails; undirected edges leave both of their
+			//      vertices, so they are counted at the one with the lower ID
+			if ((std::binary_search(out_neighbours.begin(), out_neighbours.end(), neighbours[neighbour_i])) &&
+			    ((vertex <= neighbours[neighbour_i]) || (!std::binary_search(undirected_neighbours.begin(), undirected_neighbours.end(), neighbours[neighbour_i]))))
+			{
+				this->min_length = ((this->min_length == 0.0L) || (length < this->min_length)) ? (length) : (this->min_length);
+				this->max_length = std::max(this->max_length, length);
+				this->total_length += length;
+			}
+			if (neighbours[neighbour_i] == vertex)
+				continue;
+			arcs.emplace_back(std::lower_bound(vertex_ids.begin(), vertex_ids.end(), neighbours[neighbour_i]) - vertex_ids.begin(), length);
+			++degree;
+		}
+		offsets.push_back(arcs.size());
+		if (degree >= this->degree_histogram.size())
+			this->degree_histogram.resize(degree + 1, 0);
+		++this->degree_histogram[degree];
+	}
+
+	// 2. Sweep twice: from the vertex with the lowest ID and from the farthest vertex found
+	if (vertex_count > 0)
+		this->diameter_estimate = sweep(sweep(0, offsets, arcs).second, offsets, arcs).first;
+}
+
+
+
+
+
+// Access
+
+
+
+
+
+template <typename Real>
+std::vector<uint32_t> const & rwe::RunPlanner<Real>::getDegreeHistogram(void) const
+{
+	return this->degree_histogram;
+}
+
+
+
+template <typename Real>
+long double const rwe::RunPlanner<Real>::getMinLength(void) const
+{
+	return this->min_length;
+}
+
+
+
+template <typename Real>
+long double const rwe::RunPlanner<Real>::getMaxLength(void) const
+{
+	return this->max_length;
+}
+
+
+
+template <typename Real>
+long double const rwe::RunPlanner<Real>::getDiameterEstimate(void) const
+{
+	return this->diameter_estimate;
+}
+
+
+
+
+
+// Planning
+
+
+
+
+
+template <typename Real>
+rwe::RunPlan const rwe::RunPlanner<Real>::plan(long double const epsilon, long double const time_delta, uint32_t const max_thread_count) const
+{
+	uint64_t const      updates_per_thread          = 4096;
+	long double const   mean_length                 = (this->edge_count > 0) ? (this->total_length / this->edge_count) : (1.0L);
+	long double const   mean_agent_count            = (this->total_length / (2 * epsilon) + this->edge_count) / 2;
+	long double const   step_cost                   = this->edge_count + mean_agent_count;
+	RunPlan             plan;
+	long double         precise_step_count          = 0.0L;
+	long double         skip_forward_step_count     = 0.0L;
+	long double         step_count                  = 0.0L;
+
+	// 1. Predict the cost of both algorithms
+	plan.predicted_time = this->diameter_estimate + this->max_length;
+	precise_step_count = plan.predicted_time / time_delta;
+	skip_forward_step_count = std::min(precise_step_count, plan.predicted_time * mean_agent_count / mean_length + 1);
+	plan.precise_cost = precise_step_count * step_cost;
+	plan.skip_forward_cost = skip_forward_step_count * (step_cost + this->edge_count);
+	plan.use_skip_forward = (plan.skip_forward_cost <= plan.precise_cost);
+	step_count = (plan.use_skip_forward) ? (skip_forward_step_count) : (precise_step_count);
+
+	// 2. Each step rounds positions once, so the cheapest precision is the one whose accumulated rounding errors
+	//    stay below the tolerance agent instances are merged with
+	if (step_count * std::numeric_limits<float>::epsilon() / 2 * this->max_length < time_delta / 10)
+		plan.precision = float_precision;
+	else if (step_count * std::numeric_limits<double>::epsilon() / 2 * this->max_length < time_delta / 10)
+		plan.precision = double_precision;
+	else
+		plan.precision = long_double_precision;
+
+	// 3. A new thread only pays off if it has enough updates to make at each step
+	plan.thread_count = std::max<uint32_t>(std::min<long double>(std::max<uint32_t>(max_thread_count, 1), step_cost / updates_per_thread), 1);
+
+	return plan;
+}
+
+
+
+
+
+// Explicit instantiations
+
+
+
+
+
+template class rwe::RunPlanner<float>;
+template class rwe::RunPlanner<double>;
+template class rwe::RunPlanner<long double>;
@@ -0,0 +1,196 @@
+/**
+ * \file
+ *       planner.hpp
+ *
+ * \author
+ *       Andrei Eliseev (JointPoints), 2021
+ */
+#ifndef RWE__PLANNER_HPP__
+#define RWE__PLANNER_HPP__
+
+
+
+
+
+#include "../metric_graph/metric_graph.hpp"     // needed for "MetricGraph"
+#include <vector>                               // needed for "vector"
+#include <cstdint>                              // needed for "int*_t" and "uint*_t" types
+
+
+
+
+
+namespace rwe
+{
+
+
+
+
+
+	/**
+	 * \brief Type of lengths and positions of agent instances
+	 *
+	 * * \c long_double_precision : <tt>long double</tt>;
+	 * * \c double_precision : \c double;
+	 * * \c float_precision : \c float.
+	 */
+	using Precision         = enum PrecisionEnum {long_double_precision, double_precision, float_precision};
+
+
+
+
+
+	/**
+	 * \brief Plan of a single \f$\varepsilon\f$-saturation experiment
+	 *
+	 * * \c use_skip_forward : whether the skip forward algorithm is cheaper than the precise one;
+	 * * \c precision : the cheapest type of lengths whose rounding errors stay below the tenth of a
+	 * time step during the whole emulation;
+	 * * \c thread_count : number of threads to update edges with (see RWSpace::setThreadCount);
+	 * * \c predicted_time : predicted saturation time;
+	 * * \c skip_forward_cost and \c precise_cost : predicted numbers of updates of edges and agent
+	 * instances made by both algorithms.
+	 */
+	using RunPlan           = struct RunPlanStruct {bool use_skip_forward; Precision precision; uint32_t thread_count; long double predicted_time; long double skip_forward_cost; long double precise_cost;};
+
+
+
+
+
+	/**
+	 * \class RunPlanner
+	 * \brief Planner of \f$\varepsilon\f$-saturation experiments on a metric graph
+	 *
+	 * Which emulation algorithm, precision and number of threads are the fastest for a certain
+	 * experiment depends on the size of the graph, the distribution of lengths and the ratio of
+	 * \f$\varepsilon\f$ and the time step \f$\Delta t\f$. Planner collects cheap statistics of the
+	 * graph once and predicts the cost of each experiment from them. Directions of edges are
+	 * ignored by the statistics:
+	 *
+	 * * histogram of degrees (numbers of distinct neighbours) of vertices;
+	 * * the range and the sum \f$L\f$ of lengths of edges;
+	 * * estimate \f$D\f$ of the diameter of the graph, i.e., the length of the longest shortest
+	 * path found by two sweeps of Dijkstra's algorithm (the second one starts at the farthest
+	 * vertex found by the first one). It never exceeds the true diameter of the component of
+	 * the vertex with the lowest ID.
+	 *
+	 * The experiment is predicted to saturate at \f$T = D + \max_{e \in E} l(e)\f$, when agent
+	 * instances have reached the farthest edges and crossed them once. By that time, the number
+	 * of agent instances grows to about \f$N = L / 2\varepsilon + |E|\f$ (the size of the
+	 * thinnest \f$\varepsilon\f$-nets), so \f$N / 2\f$ of them are alive on average. Hence,
+	 * * the precise algorithm makes \f$T / \Delta t\f$ steps, each updating all edges and agent
+	 * instances;
+	 * * the skip forward algorithm makes one step per moment when some agent instance hits a
+	 * vertex. Each agent instance does so once per the mean length of edges, while moments
+	 * closer than \f$\Delta t\f$ are merged, so there are at most as many steps as in the precise
+	 * algorithm. Each step additionally scans all edges to check the necessary condition of
+	 * saturation.
+	 *
+	 * The predictions are rough and only meant to tell cheap experiments from expensive ones.
+	 *
+	 * \tparam  Real    Type of lengths, the same as the one of the graph.
+	 */
+	template <typename Real>
+	class RunPlanner
+	{
+
+
+
+	public:
+
+
+
+		/// \name Constructors and destructors
+		///@{
+
+		/**
+		 * Default constructor
+		 *
+		 * Constructs a planner for an empty graph.
+		 */
+		RunPlanner                  (void);
+
+		/**
+		 * Analysing constructor
+		 *
+		 * Collects statistics of the specified metric graph.
+		 *
+		 * \param   graph   A metric graph to plan experiments on.
+		 */
+		explicit RunPlanner         (MetricGraph<Real> const &graph);
+
+		///@}
+
+
+
+		/// \name Accessors
+		///@{
+
+		/**
+		 * Get histogram of degrees
+		 *
+		 * \return \c std::vector whose \f$k\f$-th element is the number of vertices with \f$k\f$
+		 * distinct neighbours (loops are not counted).
+		 */
+		std::vector<uint32_t> const &   getDegreeHistogram  (void)                          const;
+
+		/**
+		 * Get the shortest length
+		 *
+		 * \return \f$\min_{e \in E} l(e)\f$, or 0 if the graph has no edges.
+		 */
+		long double const               getMinLength        (void)                          const;
+
+		/**
+		 * Get the longest length
+		 *
+		 * \return \f$\max_{e \in E} l(e)\f$, or 0 if the graph has no edges.
+		 */
+		long double const               getMaxLength        (void)                          const;
+
+		/**
+		 * Get estimate of the diameter
+		 *
+		 * \return \f$D\f$ (see above).
+		 */
+		long double const               getDiameterEstimate (void)                          const;
+
+		///@}
+
+
+
+		/// \name Planning
+		///@{
+
+		/**
+		 * Plan an experiment
+		 *
+		 * \param   epsilon             Parameter \f$\varepsilon\f$ of \f$\varepsilon\f$-saturation.
+		 * \param   time_delta          Time step of emulation.
+		 * \param   max_thread_count    Maximal number of threads, e.g., the number of cores.
+		 *
+		 * \return Plan of the \f$\varepsilon\f$-saturation experiment.
+		 */
+		RunPlan const                   plan                (long double const epsilon, long double const time_delta, uint32_t const max_thread_count) const;
+
+		///@}
+	private:
+		std::vector<uint32_t>       degree_histogram;
+		uint64_t                    edge_count;
+		long double                 min_length;
+		long double                 max_length;
+		long double                 total_length;
+		long double                 diameter_estimate;
+	};
+
+
+
+
+
+} // rwe
+
+
+
+
+
+#endif // RWE__PLANNER_HPP__
@@ -0,0 +1,222 @@
+/**
+ * \file
+ *       reduction.cpp
+ *
+ * \author
+ *       Andrei Eliseev (JointPoints), 2021
+ */
+#include "reduction.hpp"
+
+#include <algorithm>    // needed for "lower_bound", "binary_search", "sort"
+#include <map>          // needed for "map"
+
+
+
+
+
+// Constructors and destructors
+
+
+
+
+
+template <typename Real>
+rwe::GraphReduction<Real>::GraphReduction(void) :
+	graph(), start_vertex(0), removed_vertex_count(0), removed_edge_count(0)
+{
+	// Intended to be empty
+}
+
+
+
+template <typename Real>
+rwe::GraphReduction<Real>::GraphReduction(MetricGraph<Real> const &graph, uint32_t const start_vertex) :
+	graph(), start_vertex(0), removed_vertex_count(0), removed_edge_count(0)
+{
+	this->reduce(graph, start_vertex);
+}
+
+
+
+
+
+// Access
+
+
+
+
+
+template <typename Real>
+rwe::MetricGraph<Real> & rwe::GraphReduction<Real>::getGraph(void)
+{
+	return this->graph;
+}
+
+
+
+template <typename Real>
+uint32_t const rwe::GraphReduction<Real>::getStartVertex(void) const
+{
+	return this->start_vertex;
+}
+
+
+
+template <typename Real>
+uint32_t const rwe::GraphReduction<Real>::getRemovedVertexCount(void) const
+{
+	return this->removed_vertex_count;
+}
+
+
+
+template <typename Real>
+uint64_t const rwe::GraphReduction<Real>::getRemovedEdgeCount(void) const
+{
+	return this->removed_edge_count;
+}
+
+
+
+
+
+// Modifiers
+
+
+
+
+
+template <typename Real>
+void rwe::GraphReduction<Real>::reduce(MetricGraph<Real> const &graph, uint32_t const start_vertex)
+{
+	std::vector<uint32_t> const                 vertex_ids          = graph.getVertexList();
+	uint32_t const                              vertex_count        = vertex_ids.size();
+	auto const                                  dense_index         = [&vertex_ids](uint32_t const vertex){return std::distance(vertex_ids.begin(), std::lower_bound(vertex_ids.begin(), vertex_ids.end(), vertex));};
+	std::vector<std::vector<Arc>>               neighbourhoods(vertex_count);
+	std::vector<std::vector<Arc>>               signatures(vertex_count);
+	std::vector<uint32_t>                       degrees(vertex_count, 0);
+	std::vector<bool>                           is_stripped(vertex_count, false);
+	std::vector<uint32_t>                       stripped;
+	std::vector<std::vector<uint32_t>>          children(vertex_count);
+	std::vector<Arc>                            parent_arcs(vertex_count);
+	std::map<std::vector<Arc>, uint32_t>        tree_ids;
+	std::vector<bool>                           is_kept(vertex_count, true);
+	std::vector<uint32_t>                       removed;
+	MetricGraphBuilder<Real>                    builder;
+
+	// 1. Describe each vertex with the list of its edges to other vertices: outgoing (0), incoming (1) and
+	//    undirected (2) ones together with their lengths and opposite end points; loops (3 for directed,
+	//    5 for undirected ones) go straight to the signature of the vertex
+	for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+	{
+		uint32_t const              vertex              = vertex_ids[vertex_1];
+		std::vector<uint32_t> const out_neighbours      = graph.getOutNeighbours(vertex);
+		std::vector<uint32_t> const in_neighbours       = graph.getInNeighbours(vertex);
+		std::vector<uint32_t> const undirected          = graph.getUndirectedNeighbours(vertex);
+
+		for (uint32_t neighbour_i = 0; neighbour_i < out_neighbours.size(); ++neighbour_i)
+		{
+			uint32_t const kind = (std::binary_search(undirected.begin(), undirected.end(), out_neighbours[neighbour_i])) ? (2) : (0);
+			if (out_neighbours[neighbour_i] == vertex)
+				signatures[vertex_1].emplace_back(3 + kind, graph.getEdgeLength(vertex, vertex), 0);
+			else
+				neighbourhoods[vertex_1].emplace_back(kind, graph.getEdgeLength(vertex, out_neighbours[neighbour_i]), dense_index(out_neighbours[neighbour_i]));
+		}
+		for (uint32_t neighbour_i = 0; neighbour_i < in_neighbours.size(); ++neighbour_i)
+			if ((in_neighbours[neighbour_i] != vertex) && (!std::binary_search(undirected.begin(), undirected.end(), in_neighbours[neighbour_i])))
+				neighbourhoods[vertex_1].emplace_back(1, graph.getEdgeLength(in_neighbours[neighbour_i], vertex), dense_index(in_neighbours[neighbour_i]));
+		degrees[vertex_1] = neighbourhoods[vertex_1].size();
+		if ((degrees[vertex_1] == 1) && (vertex != start_vertex))
+		{
+			is_stripped[vertex_1] = true;
+			stripped.push_back(vertex_1);
+		}
+	}
+
+	// 2. Strip vertices with a single neighbour; each stripped vertex hangs on its last neighbour, and its
+	//    pendant tree is identified by the lengths and types of its loops and of the edges to the trees
+	//    hanging on it (these trees are always stripped earlier)
+	for (uint32_t head = 0; head < stripped.size(); ++head)
+	{
+		uint32_t const  vertex_1    = stripped[head];
+		uint32_t        parent      = vertex_count;
+
+		std::sort(signatures[vertex_1].begin(), signatures[vertex_1].end());
+		auto const tree_id = tree_ids.emplace(signatures[vertex_1], tree_ids.size()).first->second;
+
+		// 2.1. Two adjacent vertices of a tree without the start vertex may be stripped at once; such
+		//      vertices do not hang on anything
+		for (uint32_t neighbour_i = 0; neighbour_i < neighbourhoods[vertex_1].size(); ++neighbour_i)
+			if (!is_stripped[std::get<2>(neighbourhoods[vertex_1][neighbour_i])])
+			{
+				Arc const &curr_arc = neighbourhoods[vertex_1][neighbour_i];
+
+				// 2.2. Outgoing and incoming edges swap their types when seen from the other end point
+				parent = std::get<2>(curr_arc);
+				parent_arcs[vertex_1] = Arc((std::get<0>(curr_arc) == 2) ? (2) : (1 - std::get<0>(curr_arc)), std::get<1>(curr_arc), tree_id);
+				signatures[parent].push_back(parent_arcs[vertex_1]);
+				children[parent].push_back(vertex_1);
+				break;
+			}
+		if ((parent < vertex_count) && (--degrees[parent] == 1) && (vertex_ids[parent] != start_vertex))
+		{
+			is_stripped[parent] = true;
+			stripped.push_back(parent);
+		}
+	}
+
+	// 3. Among twins hanging on the same vertex, keep the one with the lowest ID and remove the whole
+	//    pendant trees of the others
+	for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+	{
+		std::vector<uint32_t> &curr_children = children[vertex_1];
+
+		std::sort(curr_children.begin(), curr_children.end(), [&parent_arcs](uint32_t const vertex_2, uint32_t const vertex_3){return (parent_arcs[vertex_2] < parent_arcs[vertex_3]) || ((parent_arcs[vertex_2] == parent_arcs[vertex_3]) && (vertex_2 < vertex_3));});
+		for (uint32_t child_i = 1; child_i < curr_children.size(); ++child_i)
+			if (parent_arcs[curr_children[child_i]] == parent_arcs[curr_children[child_i - 1]])
+				removed.push_back(curr_children[child_i]);
+	}
+	for (uint32_t removed_i = 0; removed_i < removed.size(); ++removed_i)
+	{
+		is_kept[removed[removed_i]] = false;
+		removed.insert(removed.end(), children[removed[removed_i]].begin(), children[removed[removed_i]].end());
+	}
+
+	// 4. Build the reduced graph out of the edges between kept vertices
+	for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+		if (is_kept[vertex_1])
+			for (uint32_t neighbour_i = 0; neighbour_i < neighbourhoods[vertex_1].size(); ++neighbour_i)
+			{
+				Arc const &curr_arc = neighbourhoods[vertex_1][neighbour_i];
+
+				if ((is_kept[std::get<2>(curr_arc)]) && ((std::get<0>(curr_arc) == 0) || ((std::get<0>(curr_arc) == 2) && (vertex_1 < std::get<2>(curr_arc)))))
+					builder.addEdge(vertex_ids[vertex_1], vertex_ids[std::get<2>(curr_arc)], std::get<1>(curr_arc), std::get<0>(curr_arc) == 0);
+			}
+	for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+		if (is_kept[vertex_1])
+			for (uint32_t arc_i = 0; arc_i < signatures[vertex_1].size(); ++arc_i)
+				if (std::get<0>(signatures[vertex_1][arc_i]) >= 3)
+					builder.addEdge(vertex_ids[vertex_1], vertex_ids[vertex_1], std::get<1>(signatures[vertex_1][arc_i]), std::get<0>(signatures[vertex_1][arc_i]) == 3);
+	this->graph = MetricGraph<Real>();
+	builder.build(this->graph);
+
+	this->start_vertex = start_vertex;
+	this->removed_vertex_count = vertex_count - this->graph.getVertexCount();
+	this->removed_edge_count = graph.getEdgeCount() - this->graph.getEdgeCount();
+
+	return;
+}
+
+
+
+
+
+// Explicit instantiations
+
+
+
+
+
+template class rwe::GraphReduction<float>;
+template class rwe::GraphReduction<double>;
+template class rwe::GraphReduction<long double>;
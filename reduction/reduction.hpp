@@ -0,0 +1,175 @@
+/**
+ * \file
+ *       reduction.hpp
+ *
+ * \author
+ *       Andrei Eliseev (JointPoints), 2021
+ */
+#ifndef RWE__REDUCTION_HPP__
+#define RWE__REDUCTION_HPP__
+
+
+
+
+
+#include "../metric_graph/metric_graph.hpp"     // needed for "MetricGraph"
+#include <vector>                               // needed for "vector"
+#include <cstdint>                              // needed for "int*_t" and "uint*_t" types
+#include <tuple>                                // needed for "tuple"
+
+
+
+
+
+namespace rwe
+{
+
+
+
+
+
+	/**
+	 * \class GraphReduction
+	 * \brief A metric graph reduced for epsilon saturation experiments started at a given vertex
+	 *
+	 * Graph reduction is a pre-pass which removes parts of a metric graph that can not change
+	 * the result of an \f$\varepsilon\f$-saturation experiment started at a certain vertex. The
+	 * experiment may then be run on the smaller graph, which saves updates of edges and agent
+	 * instances, and its saturation time is the saturation time for the original graph.
+	 *
+	 * <b>Pendant trees</b> are found by repeatedly stripping vertices with a single neighbour
+	 * (other than the start vertex). Each stripped vertex \f$c\f$ hangs on its last neighbour
+	 * \f$p\f$ and roots the pendant tree of all vertices stripped below it. Two pendant trees
+	 * hanging on the same vertex \f$p\f$ are <b>twins</b>, if some isomorphism of these trees
+	 * preserves lengths and types of all edges (including loops and the edges to \f$p\f$).
+	 * Only one tree of each group of twins is kept, the others are removed together with all
+	 * their edges.
+	 *
+	 * The reduction is exact. Swapping two twins is an automorphism of the graph which fixes
+	 * the start vertex, so at each moment both twins carry the same agent instances. Every agent
+	 * instance that leaves a removed twin reaches \f$p\f$ together with its mirror image that
+	 * leaves the kept twin, and all agent instances it spawns there coincide with the ones
+	 * spawned (or reflected) by the mirror image, so they are merged with them. Edges of both
+	 * twins also become saturated at the same moment. Lengths are compared exactly, so the
+	 * saturation times for the original and the reduced graphs coincide up to the last bit.
+	 *
+	 * \tparam  Real    Type of lengths, the same as the one of the original graph.
+	 */
+	template <typename Real>
+	class GraphReduction
+	{
+
+
+
+	public:
+
+
+
+		/// \name Constructors and destructors
+		///@{
+
+		/**
+		 * Default constructor
+		 *
+		 * Constructs an empty reduced graph.
+		 */
+		GraphReduction              (void);
+
+		/**
+		 * Reducing constructor
+		 *
+		 * Reduces the specified metric graph for experiments started at the specified vertex.
+		 *
+		 * \param   graph           A metric graph to reduce.
+		 * \param   start_vertex    ID of the vertex experiments start at.
+		 */
+		explicit GraphReduction     (MetricGraph<Real> const &graph, uint32_t const start_vertex);
+
+		// Prevent implicit creation of copy- and move-constructors, as well as the assignment operator
+		GraphReduction                  (GraphReduction &)  = delete;
+		GraphReduction                  (GraphReduction &&) = delete;
+		GraphReduction &    operator =  (GraphReduction &)  = delete;
+
+		///@}
+
+
+
+		/// \name Accessors
+		///@{
+
+		/**
+		 * Get the reduced graph
+		 *
+		 * The same MetricGraph object is kept for the whole life of the GraphReduction object, so
+		 * an RWSpace object may be associated with it once and survive any number of \ref reduce
+		 * calls.
+		 *
+		 * \return Reference to the reduced graph.
+		 */
+		MetricGraph<Real> &     getGraph                (void);
+
+		/**
+		 * Get start vertex
+		 *
+		 * \return ID of the vertex the graph has been reduced for.
+		 */
+		uint32_t const          getStartVertex          (void)                          const;
+
+		/**
+		 * Get the number of removed vertices
+		 *
+		 * \return Number of vertices of the original graph absent in the reduced graph.
+		 */
+		uint32_t const          getRemovedVertexCount   (void)                          const;
+
+		/**
+		 * Get the number of removed edges
+		 *
+		 * \return Number of edges of the original graph absent in the reduced graph.
+		 */
+		uint64_t const          getRemovedEdgeCount     (void)                          const;
+
+		///@}
+
+
+
+		/// \name Modifiers
+		///@{
+
+		/**
+		 * Reduce a graph
+		 *
+		 * Replaces the reduced graph with the reduction of the specified metric graph for
+		 * experiments started at the specified vertex. If the start vertex is absent, no vertex
+		 * is protected from stripping, so experiments on the reduced graph fail the same way as
+		 * on the original one.
+		 *
+		 * \param   graph           A metric graph to reduce.
+		 * \param   start_vertex    ID of the vertex experiments start at.
+		 *
+		 * \note All \c RWSpace objects associated with the reduced graph will be automatically
+		 * transferred into the \c invalid state.
+		 */
+		void                    reduce                  (MetricGraph<Real> const &graph, uint32_t const start_vertex);
+
+		///@}
+	private:
+		using Arc               = std::tuple<uint32_t, Real, uint32_t>;
+
+		MetricGraph<Real>           graph;
+		uint32_t                    start_vertex;
+		uint32_t                    removed_vertex_count;
+		uint64_t                    removed_edge_count;
+	};
+
+
+
+
+
+} // rwe
+
+
+
+
+
+#endif // RWE__REDUCTION_HPP__
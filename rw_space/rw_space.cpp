@@ -8,18 +8,173 @@
 #include "rw_space.hpp"
 
 #include <stdexcept>    // needed for exceptions
-#include <algorithm>    // needed for "lower_bound"
+#include <algorithm>    // needed for "lower_bound", "upper_bound", "max_element", "sort", "inplace_merge"
 #include <cmath>        // needed for "fmod", "floor"
 #include <utility>      // needed for "swap"
 #include <thread>       // needed for "thread"
 #include <queue>        // needed for "priority_queue"
+#include <limits>       // needed for "numeric_limits"
+#include <mutex>        // needed for "mutex", "unique_lock"
+#include <condition_variable>   // needed for "condition_variable"
+#include <functional>   // needed for "function"
+#include <system_error> // needed for "system_error"
+#include <exception>    // needed for "exception_ptr", "current_exception", "rethrow_exception"
 //#include <set>          // needed for "set"
 
 
 
 
 
-bool inline rwe::RWSpace::AgentInstance::operator<(AgentInstance const &other) const
+// A fixed set of threads which process chunks of every emulation step; chunk 0 is processed by the calling
+// thread and chunk i > 0 by worker i, so the workers are started once per emulation and only woken up by the
+// steps large enough to be split; each chunk keeps its own buffers, so that they are not reallocated at each step
+template <typename Real>
+class rwe::RWSpace<Real>::StepWorkers
+{
+public:
+	// Buffers of a single chunk; chunk 0 reports to the caller directly, so only its scratch results of single edges
+	// are used
+	using ChunkBuffers = struct {EdgeUpdateResult results; EdgeUpdateResult edge_results; std::vector<uint64_t> hit_edges; bool is_saturated;};
+
+	StepWorkers(void) :
+		task(nullptr), step_number(0), chunk_count(1), pending_count(0), is_stopping(false)
+	{
+	}
+
+	~StepWorkers(void)
+	{
+		this->stop();
+	}
+
+	// Starts <thread_count> - 1 workers; if the platform fails to start one of them, the ones already started
+	// are stopped
+	void start(uint32_t const thread_count)
+	{
+		try
+		{
+			this->errors.resize(thread_count);
+			this->buffers.resize(thread_count);
+			for (uint32_t worker_i = 1; worker_i < thread_count; ++worker_i)
+				this->threads.emplace_back(&StepWorkers::work, this, worker_i);
+		}
+		catch (std::system_error const &error)
+		{
+			this->stop();
+			throw std::runtime_error(std::string("Unable to start worker threads: ") + error.what());
+		}
+	}
+
+	// Calls <task> for chunks 0, 1, ..., <chunk_count> - 1 in parallel and waits for all of them to finish;
+	// an exception thrown by any chunk is rethrown here
+	void run(uint32_t const chunk_count, std::function<void (uint32_t const)> const &task)
+	{
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+
+			this->task = &task;
+			this->chunk_count = chunk_count;
+			this->pending_count = chunk_count - 1;
+			++this->step_number;
+		}
+		if (chunk_count > 1)
+			this->step_begun.notify_all();
+
+		try
+		{
+			task(0);
+		}
+		catch (...)
+		{
+			this->errors[0] = std::current_exception();
+		}
+
+		std::unique_lock<std::mutex> lock(this->mutex);
+		this->step_done.wait(lock, [this](void){return this->pending_count == 0;});
+		for (uint32_t chunk_i = 0; chunk_i < chunk_count; ++chunk_i)
+			if (this->errors[chunk_i])
+			{
+				std::exception_ptr const error = this->errors[chunk_i];
+
+				for (; chunk_i < chunk_count; ++chunk_i)
+					this->errors[chunk_i] = nullptr;
+				std::rethrow_exception(error);
+			}
+	}
+	// Returns buffers of chunk <chunk_i>
+	ChunkBuffers &getBuffers(uint32_t const chunk_i)
+	{
+		return this->buffers[chunk_i];
+	}
+private:
+	void work(uint32_t const chunk_i)
+	{
+		uint64_t    last_step_number    = 0;
+
+		while (true)
+		{
+			std::function<void (uint32_t const)> const *task;
+			{
+				std::unique_lock<std::mutex> lock(this->mutex);
+
+				this->step_begun.wait(lock, [this, &last_step_number](void){return (this->is_stopping) || (this->step_number != last_step_number);});
+				if (this->is_stopping)
+					return;
+				last_step_number = this->step_number;
+				if (chunk_i >= this->chunk_count)
+					continue;
+				task = this->task;
+			}
+
+			try
+			{
+				(*task)(chunk_i);
+			}
+			catch (...)
+			{
+				this->errors[chunk_i] = std::current_exception();
+			}
+
+			{
+				std::unique_lock<std::mutex> lock(this->mutex);
+
+				--this->pending_count;
+			}
+			this->step_done.notify_one();
+		}
+	}
+
+	void stop(void)
+	{
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+
+			this->is_stopping = true;
+		}
+		this->step_begun.notify_all();
+		for (uint32_t worker_i = 0; worker_i < this->threads.size(); ++worker_i)
+			this->threads[worker_i].join();
+		this->threads.clear();
+	}
+
+	std::vector<std::thread>                        threads;
+	std::vector<std::exception_ptr>                 errors;
+	std::vector<ChunkBuffers>                       buffers;
+	std::mutex                                      mutex;
+	std::condition_variable                         step_begun;
+	std::condition_variable                         step_done;
+	std::function<void (uint32_t const)> const     *task;
+	uint64_t                                        step_number;
+	uint32_t                                        chunk_count;
+	uint32_t                                        pending_count;
+	bool                                            is_stopping;
+};
+
+
+
+
+
+template <typename Real>
+bool inline rwe::RWSpace<Real>::AgentInstance::operator<(AgentInstance const &other) const
 {
 	return this->position < other.position;
 }
@@ -34,8 +189,9 @@ bool inline rwe::RWSpace::AgentInstance::operator<(AgentInstance const &other) c
 
 
 
-rwe::RWSpace::RWSpace(MetricGraph &graph) :
-	graph(graph), wander_state(invalid)
+template <typename Real>
+rwe::RWSpace<Real>::RWSpace(MetricGraph<Real> &graph) :
+	graph(graph), vertex_order(id_order), thread_count(1), is_snapshot_valid(false), wander_state(invalid), peak_agent_count(0), peak_buffer_bytes(0)
 {
 	graph.associated_wanders.push_back(this);
 	this->reset();
@@ -43,7 +199,8 @@ rwe::RWSpace::RWSpace(MetricGraph &graph) :
 
 
 
-rwe::RWSpace::~RWSpace(void)
+template <typename Real>
+rwe::RWSpace<Real>::~RWSpace(void)
 {
 	for (uint32_t wander_i = 0; wander_i < this->graph.associated_wanders.size(); ++wander_i)
 		if (this->graph.associated_wanders[wander_i] == this)
@@ -60,7 +217,8 @@ rwe::RWSpace::~RWSpace(void)
 
 
 
-rwe::RWSpace & rwe::RWSpace::operator=(rwe::RWSpace &&other)
+template <typename Real>
+rwe::RWSpace<Real> & rwe::RWSpace<Real>::operator=(rwe::RWSpace<Real> &&other)
 {
 	*this = std::move(other);
 
@@ -71,13 +229,66 @@ rwe::RWSpace & rwe::RWSpace::operator=(rwe::RWSpace &&other)
 
 
 
+// Access
+
+
+
+
+
+template <typename Real>
+rwe::MemoryUsage const rwe::RWSpace<Real>::getMemoryUsage(void) const
+{
+	MemoryUsage     usage           = this->compiled_graph.getMemoryUsage();
+	uint64_t        list_bytes      = 0;
+
+	// 1. Arrays of the snapshot
+	for (uint32_t record_i = 0; record_i < usage.size(); ++record_i)
+		usage[record_i].name = "snapshot " + usage[record_i].name;
+
+	// 2. States of edges
+	for (uint64_t edge_i = 0; edge_i < this->graph_state.size(); ++edge_i)
+		list_bytes += this->graph_state[edge_i].agents.capacity() * sizeof(AgentInstance);
+	usage.push_back({"edge states", this->graph_state.capacity() * sizeof(EdgeState), this->graph_state.capacity() * sizeof(EdgeState)});
+	usage.push_back({"agent lists", list_bytes, list_bytes});
+	usage.push_back({"changed edges", this->changed_edges.capacity() * sizeof(uint64_t), this->changed_edges.capacity() * sizeof(uint64_t)});
+	usage.push_back({"emulation buffers", 0, this->peak_buffer_bytes});
+
+	return usage;
+}
+
+
+
+template <typename Real>
+uint64_t const rwe::RWSpace<Real>::getPeakAgentCount(void) const
+{
+	return this->peak_agent_count;
+}
+
+
+
+template <typename Real>
+std::vector<uint64_t> const rwe::RWSpace<Real>::getAgentListCapacities(void) const
+{
+	std::vector<uint64_t> capacities(this->graph_state.size());
+
+	for (uint64_t edge_i = 0; edge_i < this->graph_state.size(); ++edge_i)
+		capacities[edge_i] = this->graph_state[edge_i].agents.capacity();
+
+	return capacities;
+}
+
+
+
+
+
 // Modifiers
 
 
 
 
 
-void rwe::RWSpace::reset(void)
+template <typename Real>
+void rwe::RWSpace<Real>::reset(void)
 {
 	// 1. Process the RWSpace object accordingly
 	switch (this->wander_state)
@@ -87,9 +298,22 @@ void rwe::RWSpace::reset(void)
 		case active:
 			throw std::logic_error("Active RWSpace object cannot be reset. Invalidate it, if you want to interrupt the emulation.");
 		case invalid:
-			this->graph_state = GraphState(graph.edges.size());
-			for (uint32_t vertex_1 = 0; vertex_1 < this->graph_state.size(); ++vertex_1)
-				this->graph_state[vertex_1] = NeighbourhoodState(graph.edges[vertex_1].adjacents.size(), EdgeState{AgentInstanceList(), false});
+			// 1.1. Recompile the graph if its structure has changed, otherwise only patch the changed lengths
+			if (this->is_snapshot_valid)
+				for (uint64_t edge_i = 0; edge_i < this->changed_edges.size(); ++edge_i)
+					this->compiled_graph.updateLength(this->changed_edges[edge_i], this->graph.edge_columns.lengths[this->changed_edges[edge_i]]);
+			else
+				this->compiled_graph = CompiledGraph<Real>(this->graph, this->vertex_order, (this->compiled_graph.getVertexCount() > 0) ? (this->compiled_graph.getRootVertex()) : (0));
+			this->changed_edges.clear();
+			this->is_snapshot_valid = true;
+
+			// 1.2. Clear states of edges without releasing memory allocated for agents
+			this->graph_state.resize(this->compiled_graph.getEdgeCount());
+			for (uint64_t edge_i = 0; edge_i < this->graph_state.size(); ++edge_i)
+			{
+				this->graph_state[edge_i].agents.clear();
+				this->graph_state[edge_i].is_saturated = false;
+			}
 			break;
 		case dead:
 			throw std::logic_error("RWSpace object is dead.");
@@ -103,23 +327,29 @@ void rwe::RWSpace::reset(void)
 
 
 
-long double const rwe::RWSpace::run_saturation(uint32_t const start_vertex, long double const epsilon, long double const time_delta, bool const use_skip_forward)
+template <typename Real>
+long double const rwe::RWSpace<Real>::run_saturation(uint32_t const start_vertex, Real const epsilon, Real const time_delta, bool const use_skip_forward)
 {
-	auto                                agent_comparator    = [](AgentInstance const &agent, long double const position){return agent.position < position;};
+	auto                                agent_comparator    = [](AgentInstance const &agent, Real const position){return agent.position < position;};
 	long double                         runtime             = 0.0L;
 	bool                                is_saturated        = false;
 	std::priority_queue<long double, std::vector<long double>, std::greater<long double>>    skip_forward_timestamps;
 
-	uint32_t const                      threads_count           = std::thread::hardware_concurrency();
-	uint32_t const                      free_threads_count      = 3;
-	bool const                          use_concurrency         = (threads_count > free_threads_count);
-	uint64_t const                      concurrency_threshold   = 50;
-	uint64_t                            min_agent_count         = std::numeric_limits<uint64_t>::max();
-	
 	EdgeUpdateResult                    update_results;
-	EdgeUpdateResult                    curr_results;
-	std::vector<EdgeUpdateResult>       threads_curr_results((use_concurrency) ? (threads_count - free_threads_count) : (0));
-	std::vector<std::thread>            threads;
+	std::vector<uint64_t>               hit_edges;
+	StepWorkers                         workers;
+
+	CompiledGraph<Real> const          &compiled_graph          = this->compiled_graph;
+	uint32_t                            start_vertex_index      = compiled_graph.getVertexIndex(start_vertex);
+	long double                         latest_arrival          = 0.0L;
+	uint64_t                            iteration_count         = 0;
+	uint64_t                            max_departure_count     = 0;
+	uint64_t                            agent_count             = 0;
+	uint64_t                            peak_agent_count        = 0;
+	uint64_t                            peak_event_count        = 0;
+	ActiveEdgeList                      active_edges;
+	ActiveEdgeList                      new_edges;
+	std::vector<bool>                   is_active;
 
 	// 1.1. Check if wander state is "dead"
 	if (this->wander_state == WanderState::dead)
@@ -128,138 +358,140 @@ long double const rwe::RWSpace::run_saturation(uint32_t const start_vertex, long
 	if (this->wander_state != WanderState::ready)
 		throw std::logic_error("RWSpace object needs to be reset before running the emulation.");
 	// 1.3. Check if <start_vertex> is valid
-	if (!this->graph.checkVertex(start_vertex))
+	if (start_vertex_index == compiled_graph.getVertexCount())
 		throw std::invalid_argument("Vetrex " + std::to_string(start_vertex) + " does not exist in the specified graph.");
+	// 1.4. Rebuild the snapshot around <start_vertex>, if the order of vertices depends on it
+	if ((compiled_graph.getVertexOrder() == bfs_order) && (compiled_graph.getRootVertex() != start_vertex))
+	{
+		this->compiled_graph = CompiledGraph<Real>(this->graph, bfs_order, start_vertex);
+		start_vertex_index = compiled_graph.getVertexIndex(start_vertex);
+	}
+	// 1.5. Check if <time_delta> is not lost in rounding errors of positions
+	if ((compiled_graph.getEdgeCount() > 0) && (time_delta <= *std::max_element(compiled_graph.lengths.begin(), compiled_graph.lengths.end()) * std::numeric_limits<Real>::epsilon()))
+		throw std::domain_error("Time delta is too small for the chosen precision.");
+	// 1.6. Check if every edge can be reached from <start_vertex>; no edge receives agents earlier than it is reached
+	//      first, so the emulation can not saturate before the latest of these moments and there is no need to check
+	//      saturation until then
+	if (compiled_graph.getEdgeCount() > 0)
+	{
+		std::vector<long double> const arrival_times = compiled_graph.getArrivalTimes(start_vertex_index);
+		latest_arrival = *std::max_element(arrival_times.begin(), arrival_times.end());
+		if (latest_arrival == std::numeric_limits<long double>::infinity())
+			throw std::domain_error("Some edges can not be reached from vertex " + std::to_string(start_vertex) + ", so the emulation would never saturate.");
+		latest_arrival -= time_delta / 2;
+	}
 	
-	// 2. Update wander state
+	// 2. Start the workers and update wander state; if the workers can not be started, the space stays "ready"
+	workers.start(this->thread_count);
 	this->wander_state = WanderState::active;
 	
-	// 3. Place a single AgentInstance on each edge incident to the <start_vertex>
-	for (uint32_t vertex_1_i = 0; vertex_1_i < this->graph_state.size(); ++vertex_1_i)
-		for (uint32_t vertex_2_i = 0; vertex_2_i < this->graph_state[vertex_1_i].size(); ++vertex_2_i)
+	// 3. Place a single AgentInstance on each edge incident to the <start_vertex>; only edges which have ever held
+	//    agents are updated hereafter, the others stay dormant
+	is_active.assign(compiled_graph.getEdgeCount(), false);
+	for (uint32_t vertex_1 = 0; vertex_1 < compiled_graph.getVertexCount(); ++vertex_1)
+		for (uint64_t edge_i = compiled_graph.offsets[vertex_1]; edge_i < compiled_graph.offsets[vertex_1 + 1]; ++edge_i)
 		{
-			MetricGraph::VertexView curr_vertex = this->graph.edges[vertex_1_i];
-			if (curr_vertex.id == start_vertex)
+			if (vertex_1 == start_vertex_index)
 			{
-				this->graph_state[vertex_1_i][vertex_2_i].agents.push_back({0.0L, true});
+				this->graph_state[edge_i].agents.push_back({Real(0), true});
+				++agent_count;
 				if (use_skip_forward)
-					skip_forward_timestamps.push(curr_vertex.lengths[vertex_2_i]);
+					skip_forward_timestamps.push(compiled_graph.lengths[edge_i]);
+				this->activateEdge(edge_i, is_active, new_edges);
 			}
-			if ((curr_vertex.adjacents[vertex_2_i] == start_vertex) && (curr_vertex.is_directed[vertex_2_i] == false))
+			if ((compiled_graph.targets[edge_i] == start_vertex_index) && (!compiled_graph.isDirected(edge_i)))
 			{
-				this->graph_state[vertex_1_i][vertex_2_i].agents.push_back({curr_vertex.lengths[vertex_2_i], false});
+				this->graph_state[edge_i].agents.push_back({compiled_graph.lengths[edge_i], false});
+				++agent_count;
 				if (use_skip_forward)
-					skip_forward_timestamps.push(curr_vertex.lengths[vertex_2_i]);
+					skip_forward_timestamps.push(compiled_graph.lengths[edge_i]);
+				this->activateEdge(edge_i, is_active, new_edges);
 			}
 		}
-	min_agent_count = 1;
+	this->mergeNewEdges(active_edges, new_edges);
+	peak_agent_count = agent_count;
+
+	// 4. An agent hitting a vertex is replaced with one agent per departure of this vertex (except the edge it came
+	//    from), so if no vertex has more than one departure, the number of agents never grows; each edge of length
+	//    l needs at least floor(l / (2 * epsilon)) + 1 agents to be saturated
+	for (uint32_t vertex_1 = 0; vertex_1 < compiled_graph.getVertexCount(); ++vertex_1)
+		max_departure_count = std::max(max_departure_count, compiled_graph.departure_offsets[vertex_1 + 1] - compiled_graph.departure_offsets[vertex_1]);
+	if (max_departure_count <= 1)
+	{
+		long double     required_agent_count    = 0.0L;
+		uint64_t        present_agent_count     = 0;
+
+		for (uint64_t edge_i = 0; edge_i < this->graph_state.size(); ++edge_i)
+		{
+			required_agent_count += floor(compiled_graph.lengths[edge_i] / (2 * epsilon)) + 1;
+			present_agent_count += this->graph_state[edge_i].agents.size();
+		}
+		if (present_agent_count < required_agent_count)
+		{
+			this->wander_state = WanderState::invalid;
+			throw std::domain_error("Agents can not multiply in this graph and there are too few of them, so the emulation would never saturate.");
+		}
+	}
 	
-	// 4. Run simulation
-	// 4.1. Use "skip forward", if it is allowed
+	// 5. Run simulation
+	// 5.1. Use "skip forward", if it is allowed
 	while (use_skip_forward)
 	{
+		// On iterations 1, 2, 4, 8, ..., make sure that agents can still reach every edge
+		++iteration_count;
+		if ((iteration_count & (iteration_count - 1)) == 0)
+			this->checkSaturability();
 		is_saturated = true;
-		min_agent_count = std::numeric_limits<uint64_t>::max();
 
 		// Check if current state satisfies the necessary condition
-		for (uint32_t vertex_1 = 0; vertex_1 < this->graph_state.size(); ++vertex_1)
-			for (uint32_t vertex_2 = 0; vertex_2 < this->graph_state[vertex_1].size(); ++vertex_2)
-			{
-				is_saturated &= (this->graph_state[vertex_1][vertex_2].agents.size() >= floor(this->graph.edges[vertex_1].lengths[vertex_2] / (2 * epsilon) + 1));
-				min_agent_count = std::min(min_agent_count, this->graph_state[vertex_1][vertex_2].agents.size());
-			}
+		if (runtime < latest_arrival)
+			is_saturated = false;
+		else
+			for (uint64_t edge_i = 0; edge_i < this->graph_state.size(); ++edge_i)
+				is_saturated &= (this->graph_state[edge_i].agents.size() >= floor(compiled_graph.lengths[edge_i] / (2 * epsilon) + 1));
 		if (is_saturated)
 			break;
+
+		// Every edge some agent has hit a vertex of gets its next event after the time needed to traverse it
+		this->updateActiveEdges(active_edges, epsilon, skip_forward_timestamps.top() - runtime, workers, update_results, hit_edges);
+		for (uint64_t hit_i = 0; hit_i < hit_edges.size(); ++hit_i)
+			skip_forward_timestamps.push(skip_forward_timestamps.top() + compiled_graph.lengths[hit_edges[hit_i]]);
+		hit_edges.clear();
 		
-		if (true || (!use_concurrency) || (min_agent_count < concurrency_threshold))
-			for (uint32_t vertex_1 = 0; vertex_1 < this->graph_state.size(); ++vertex_1)
-				for (uint32_t vertex_2 = 0; vertex_2 < this->graph_state[vertex_1].size(); ++vertex_2)
-				{
-					this->updateEdgeState(vertex_1, vertex_2, epsilon, skip_forward_timestamps.top() - runtime, curr_results);
-					if (curr_results.collision_occured)
-					{
-						update_results.target_edges.insert(update_results.target_edges.end(), curr_results.target_edges.begin(), curr_results.target_edges.end());
-						update_results.init_positions.insert(update_results.init_positions.end(), curr_results.init_positions.begin(), curr_results.init_positions.end());
-						update_results.init_directions.insert(update_results.init_directions.end(), curr_results.init_directions.begin(), curr_results.init_directions.end());
-						
-						skip_forward_timestamps.push(skip_forward_timestamps.top() + this->graph.edges[vertex_1].lengths[vertex_2]);
-					}
-					/*std::cout << this->graph.edges[vertex_1].id << ' ' << this->graph.edges[vertex_1].adjacents[vertex_2] << '\n';
-					for (uint32_t i = 0; i < this->graph_state[vertex_1][vertex_2].agents.size(); ++i)
-						std::cout << this->graph_state[vertex_1][vertex_2].agents[i].position << ' ';
-					std::cout << "\n---------------------------\n";*/
-				}
-		else
-		{
-			for (uint32_t vertex_1 = 0; vertex_1 < this->graph_state.size(); ++vertex_1)
-				for (uint32_t vertex_2 = 0; vertex_2 < this->graph_state[vertex_1].size(); ++vertex_2)
-				{
-					if (threads.size() < threads_count - free_threads_count)
-						threads.emplace_back(&RWSpace::updateEdgeState, this, vertex_1, vertex_2, epsilon, skip_forward_timestamps.top() - runtime, std::ref(threads_curr_results[threads.size()]));
-					else
-					{
-						for (uint32_t thread_i = 0; thread_i < threads.size(); ++thread_i)
-						{
-							threads[thread_i].join();
-							if (threads_curr_results[thread_i].collision_occured)
-							{
-								update_results.target_edges.insert(update_results.target_edges.end(), threads_curr_results[thread_i].target_edges.begin(), threads_curr_results[thread_i].target_edges.end());
-								update_results.init_positions.insert(update_results.init_positions.end(), threads_curr_results[thread_i].init_positions.begin(), threads_curr_results[thread_i].init_positions.end());
-								update_results.init_directions.insert(update_results.init_directions.end(), threads_curr_results[thread_i].init_directions.begin(), threads_curr_results[thread_i].init_directions.end());
-								
-								skip_forward_timestamps.push(skip_forward_timestamps.top() + this->graph.edges[threads_curr_results[thread_i].updated_edge.first].lengths[threads_curr_results[thread_i].updated_edge.second]);
-							}
-							// DEBUG
-							/*std::cout << this->graph.edges[threads_curr_results[thread_i].updated_edge.first].id << ' ' << this->graph.edges[threads_curr_results[thread_i].updated_edge.first].adjacents[threads_curr_results[thread_i].updated_edge.second] << '\n';
-							for (uint32_t i = 0; i < this->graph_state[threads_curr_results[thread_i].updated_edge.first][threads_curr_results[thread_i].updated_edge.second].agents.size(); ++i)
-								std::cout << this->graph_state[threads_curr_results[thread_i].updated_edge.first][threads_curr_results[thread_i].updated_edge.second].agents[i].position << ' ';
-							std::cout << "\n---------------------------\n";*/
-						}
-						threads.clear();
-						threads.emplace_back(&RWSpace::updateEdgeState, this, vertex_1, vertex_2, epsilon, skip_forward_timestamps.top() - runtime, std::ref(threads_curr_results[threads.size()]));
-					}
-				}
-			for (uint32_t thread_i = 0; thread_i < threads.size(); ++thread_i)
-			{
-				threads[thread_i].join();
-				if (threads_curr_results[thread_i].collision_occured)
-				{
-					update_results.target_edges.insert(update_results.target_edges.end(), threads_curr_results[thread_i].target_edges.begin(), threads_curr_results[thread_i].target_edges.end());
-					update_results.init_positions.insert(update_results.init_positions.end(), threads_curr_results[thread_i].init_positions.begin(), threads_curr_results[thread_i].init_positions.end());
-					update_results.init_directions.insert(update_results.init_directions.end(), threads_curr_results[thread_i].init_directions.begin(), threads_curr_results[thread_i].init_directions.end());
-					
-					skip_forward_timestamps.push(skip_forward_timestamps.top() + this->graph.edges[threads_curr_results[thread_i].updated_edge.first].lengths[threads_curr_results[thread_i].updated_edge.second]);
-				}
-			}
-			threads.clear();
-		}
-		
-		while (!update_results.target_edges.empty())
+		for (uint64_t result_i = 0; result_i < update_results.target_edges.size(); ++result_i)
 		{
-			MetricGraph::Edge const &curr_edge = update_results.target_edges.front();
-			auto agent_insert_position = std::lower_bound(this->graph_state[curr_edge.first][curr_edge.second].agents.begin(), this->graph_state[curr_edge.first][curr_edge.second].agents.end(), update_results.init_positions.front(), agent_comparator);
+			uint64_t const          curr_edge       = update_results.target_edges[result_i];
+			Real const              curr_position   = update_results.init_positions[result_i];
+			bool const              curr_direction  = update_results.init_directions[result_i];
+			auto agent_insert_position = std::lower_bound(this->graph_state[curr_edge].agents.begin(), this->graph_state[curr_edge].agents.end(), curr_position, agent_comparator);
 			
 			bool check_uniqueness_front = true, check_uniqueness_end = true;
-			if (agent_insert_position != this->graph_state[curr_edge.first][curr_edge.second].agents.begin())
-				check_uniqueness_front = ((std::abs((agent_insert_position - 1)->position - update_results.init_positions.front()) > time_delta / 10) || ((agent_insert_position - 1)->direction != update_results.init_directions.front()));
-			if (agent_insert_position != this->graph_state[curr_edge.first][curr_edge.second].agents.end())
-				check_uniqueness_end = ((std::abs(agent_insert_position->position - update_results.init_positions.front()) > time_delta / 10) || (agent_insert_position->direction != update_results.init_directions.front()));
+			if (agent_insert_position != this->graph_state[curr_edge].agents.begin())
+				check_uniqueness_front = ((std::abs((agent_insert_position - 1)->position - curr_position) > time_delta / 10) || ((agent_insert_position - 1)->direction != curr_direction));
+			if (agent_insert_position != this->graph_state[curr_edge].agents.end())
+				check_uniqueness_end = ((std::abs(agent_insert_position->position - curr_position) > time_delta / 10) || (agent_insert_position->direction != curr_direction));
 			if (check_uniqueness_front && check_uniqueness_end)
 			{
-				this->graph_state[curr_edge.first][curr_edge.second].agents.insert(agent_insert_position, AgentInstance{update_results.init_positions.front(), update_results.init_directions.front()});
-				//min_agent_count = std::max(this->graph_state[curr_edge.first][curr_edge.second].agents.size(), min_agent_count);
+				this->graph_state[curr_edge].agents.insert(agent_insert_position, AgentInstance{curr_position, curr_direction});
+				this->activateEdge(curr_edge, is_active, new_edges);
+				++agent_count;
+				//min_agent_count = std::max(this->graph_state[curr_edge].agents.size(), min_agent_count);
 
-				skip_forward_timestamps.push(skip_forward_timestamps.top() + this->graph.edges[curr_edge.first].lengths[curr_edge.second]);
+				skip_forward_timestamps.push(skip_forward_timestamps.top() + compiled_graph.lengths[curr_edge]);
 			}
-
-			update_results.target_edges.pop_front();
-			update_results.init_positions.pop_front();
-			update_results.init_directions.pop_front();
 		}
+		update_results.target_edges.clear();
+		update_results.init_positions.clear();
+		update_results.init_directions.clear();
+		this->mergeNewEdges(active_edges, new_edges);
+		agent_count -= update_results.removed_agent_count;
+		update_results.removed_agent_count = 0;
+		peak_agent_count = std::max(peak_agent_count, agent_count);
 
 		// DEBUG
 		//std::cout << "Runtime ended: " << runtime << '\n';
 
+		peak_event_count = std::max<uint64_t>(peak_event_count, skip_forward_timestamps.size());
 		while ((!skip_forward_timestamps.empty()) && (skip_forward_timestamps.top() - runtime < time_delta))
 			skip_forward_timestamps.pop();
 		if (!skip_forward_timestamps.empty())
@@ -273,125 +505,107 @@ long double const rwe::RWSpace::run_saturation(uint32_t const start_vertex, long
 		// DEBUG
 		//std::cout << "\n================================\n";
 	}
-	// 4.2. Precise emulation
+	// 5.2. Precise emulation
 	is_saturated = false;
 	while (!is_saturated)
 	{
-		is_saturated = true;
+		// On iterations 1, 2, 4, 8, ..., make sure that agents can still reach every edge
+		++iteration_count;
+		if ((iteration_count & (iteration_count - 1)) == 0)
+			this->checkSaturability();
+
+		// Dormant edges are never saturated
+		is_saturated = (active_edges.size() == compiled_graph.getEdgeCount());
+		is_saturated &= this->updateActiveEdges(active_edges, epsilon, time_delta, workers, update_results, hit_edges);
+		hit_edges.clear();
 		
-		if (true || (!use_concurrency) || (min_agent_count < concurrency_threshold))
+		for (uint64_t result_i = 0; result_i < update_results.target_edges.size(); ++result_i)
 		{
-			min_agent_count = std::numeric_limits<uint64_t>::max();
-
-			for (uint32_t vertex_1 = 0; vertex_1 < this->graph_state.size(); ++vertex_1)
-				for (uint32_t vertex_2 = 0; vertex_2 < this->graph_state[vertex_1].size(); ++vertex_2)
-				{
-					this->updateEdgeState(vertex_1, vertex_2, epsilon, time_delta, curr_results);
-					update_results.target_edges.insert(update_results.target_edges.end(), curr_results.target_edges.begin(), curr_results.target_edges.end());
-					update_results.init_positions.insert(update_results.init_positions.end(), curr_results.init_positions.begin(), curr_results.init_positions.end());
-					update_results.init_directions.insert(update_results.init_directions.end(), curr_results.init_directions.begin(), curr_results.init_directions.end());
-					is_saturated &= this->graph_state[vertex_1][vertex_2].is_saturated;
-					min_agent_count = std::min(min_agent_count, this->graph_state[vertex_1][vertex_2].agents.size());
-					/*std::cout << this->graph.edges[vertex_1].id << ' ' << this->graph.edges[vertex_1].adjacents[vertex_2] << '\n';
-					for (uint32_t i = 0; i < this->graph_state[vertex_1][vertex_2].agents.size(); ++i)
-						std::cout << this->graph_state[vertex_1][vertex_2].agents[i].position << ' ';
-					std::cout << "\n---------------------------\n";*/
-				}
-		}
-		else
-		{
-			for (uint32_t vertex_1 = 0; vertex_1 < this->graph_state.size(); ++vertex_1)
-				for (uint32_t vertex_2 = 0; vertex_2 < this->graph_state[vertex_1].size(); ++vertex_2)
-				{
-					if (threads.size() < threads_count - free_threads_count)
-						threads.emplace_back(&RWSpace::updateEdgeState, this, vertex_1, vertex_2, epsilon, time_delta, std::ref(threads_curr_results[threads.size()]));
-					else
-					{
-						for (uint32_t thread_i = 0; thread_i < threads.size(); ++thread_i)
-						{
-							threads[thread_i].join();
-							//if (threads_curr_results[thread_i].collision_occured)
-							//{
-								update_results.target_edges.insert(update_results.target_edges.end(), threads_curr_results[thread_i].target_edges.begin(), threads_curr_results[thread_i].target_edges.end());
-								update_results.init_positions.insert(update_results.init_positions.end(), threads_curr_results[thread_i].init_positions.begin(), threads_curr_results[thread_i].init_positions.end());
-								update_results.init_directions.insert(update_results.init_directions.end(), threads_curr_results[thread_i].init_directions.begin(), threads_curr_results[thread_i].init_directions.end());
-							//}
-							is_saturated &= this->graph_state[threads_curr_results[thread_i].updated_edge.first][threads_curr_results[thread_i].updated_edge.second].is_saturated;
-							// DEBUG
-							/*std::cout << this->graph.edges[threads_curr_results[thread_i].updated_edge.first].id << ' ' << this->graph.edges[threads_curr_results[thread_i].updated_edge.first].adjacents[threads_curr_results[thread_i].updated_edge.second] << '\n';
-							for (uint32_t i = 0; i < this->graph_state[threads_curr_results[thread_i].updated_edge.first][threads_curr_results[thread_i].updated_edge.second].agents.size(); ++i)
-								std::cout << this->graph_state[threads_curr_results[thread_i].updated_edge.first][threads_curr_results[thread_i].updated_edge.second].agents[i].position << ' ';
-							std::cout << "\n---------------------------\n";*/
-						}
-						threads.clear();
-						threads.emplace_back(&RWSpace::updateEdgeState, this, vertex_1, vertex_2, epsilon, time_delta, std::ref(threads_curr_results[threads.size()]));
-					}
-				}
-			for (uint32_t thread_i = 0; thread_i < threads.size(); ++thread_i)
-			{
-				threads[thread_i].join();
-				//if (threads_curr_results[thread_i].collision_occured)
-				//{
-					update_results.target_edges.insert(update_results.target_edges.end(), threads_curr_results[thread_i].target_edges.begin(), threads_curr_results[thread_i].target_edges.end());
-					update_results.init_positions.insert(update_results.init_positions.end(), threads_curr_results[thread_i].init_positions.begin(), threads_curr_results[thread_i].init_positions.end());
-					update_results.init_directions.insert(update_results.init_directions.end(), threads_curr_results[thread_i].init_directions.begin(), threads_curr_results[thread_i].init_directions.end());
-				//}
-				is_saturated &= this->graph_state[threads_curr_results[thread_i].updated_edge.first][threads_curr_results[thread_i].updated_edge.second].is_saturated;
-				// DEBUG
-				/*std::cout << this->graph.edges[threads_curr_results[thread_i].updated_edge.first].id << ' ' << this->graph.edges[threads_curr_results[thread_i].updated_edge.first].adjacents[threads_curr_results[thread_i].updated_edge.second] << '\n';
-				for (uint32_t i = 0; i < this->graph_state[threads_curr_results[thread_i].updated_edge.first][threads_curr_results[thread_i].updated_edge.second].agents.size(); ++i)
-					std::cout << this->graph_state[threads_curr_results[thread_i].updated_edge.first][threads_curr_results[thread_i].updated_edge.second].agents[i].position << ' ';
-				std::cout << '\n' << this->graph_state[threads_curr_results[thread_i].updated_edge.first][threads_curr_results[thread_i].updated_edge.second].is_saturated << '\n';
-				std::cout << "---------------------------\n";*/
-			}
-			threads.clear();
-		}
-		
-		while (!update_results.target_edges.empty())
-		{
-			MetricGraph::Edge const &curr_edge = update_results.target_edges.front();
-			auto agent_insert_position = std::lower_bound(this->graph_state[curr_edge.first][curr_edge.second].agents.begin(), this->graph_state[curr_edge.first][curr_edge.second].agents.end(), update_results.init_positions.front(), agent_comparator);
+			uint64_t const          curr_edge       = update_results.target_edges[result_i];
+			Real const              curr_position   = update_results.init_positions[result_i];
+			bool const              curr_direction  = update_results.init_directions[result_i];
+			auto agent_insert_position = std::lower_bound(this->graph_state[curr_edge].agents.begin(), this->graph_state[curr_edge].agents.end(), curr_position, agent_comparator);
 			
 			bool check_uniqueness_front = true, check_uniqueness_end = true;
-			if (agent_insert_position != this->graph_state[curr_edge.first][curr_edge.second].agents.begin())
-				check_uniqueness_front = ((std::abs((agent_insert_position - 1)->position - update_results.init_positions.front()) > time_delta / 10) || ((agent_insert_position - 1)->direction != update_results.init_directions.front()));
-			if (agent_insert_position != this->graph_state[curr_edge.first][curr_edge.second].agents.end())
-				check_uniqueness_end = ((std::abs(agent_insert_position->position - update_results.init_positions.front()) > time_delta / 10) || (agent_insert_position->direction != update_results.init_directions.front()));
+			if (agent_insert_position != this->graph_state[curr_edge].agents.begin())
+				check_uniqueness_front = ((std::abs((agent_insert_position - 1)->position - curr_position) > time_delta / 10) || ((agent_insert_position - 1)->direction != curr_direction));
+			if (agent_insert_position != this->graph_state[curr_edge].agents.end())
+				check_uniqueness_end = ((std::abs(agent_insert_position->position - curr_position) > time_delta / 10) || (agent_insert_position->direction != curr_direction));
 			if (check_uniqueness_front && check_uniqueness_end)
 			{
-				this->graph_state[curr_edge.first][curr_edge.second].agents.insert(agent_insert_position, AgentInstance{update_results.init_positions.front(), update_results.init_directions.front()});
-				//min_agent_count = std::max(this->graph_state[curr_edge.first][curr_edge.second].agents.size(), min_agent_count);
+				this->graph_state[curr_edge].agents.insert(agent_insert_position, AgentInstance{curr_position, curr_direction});
+				this->activateEdge(curr_edge, is_active, new_edges);
+				++agent_count;
+				//min_agent_count = std::max(this->graph_state[curr_edge].agents.size(), min_agent_count);
 			}
-			
-			update_results.target_edges.pop_front();
-			update_results.init_positions.pop_front();
-			update_results.init_directions.pop_front();
 		}
+		update_results.target_edges.clear();
+		update_results.init_positions.clear();
+		update_results.init_directions.clear();
+		this->mergeNewEdges(active_edges, new_edges);
+		agent_count -= update_results.removed_agent_count;
+		update_results.removed_agent_count = 0;
+		peak_agent_count = std::max(peak_agent_count, agent_count);
 
 		runtime += time_delta;
 
 		//std::cout << "Runtime ended: " << runtime << "\n================================\n";
 	}
 
-	// 5. Update wander state
+	// 6. Update wander state and remember how much memory the buffers took (they never shrink during the run)
 	this->wander_state = WanderState::invalid;
+	this->peak_agent_count = peak_agent_count;
+	this->peak_buffer_bytes = (active_edges.capacity() + new_edges.capacity()) * sizeof(typename ActiveEdgeList::value_type) + is_active.capacity() / 8 + peak_event_count * sizeof(long double);
+	for (uint32_t chunk_i = 0; chunk_i < this->thread_count; ++chunk_i)
+	{
+		EdgeUpdateResult const         &chunk_results       = (chunk_i == 0) ? (update_results) : (workers.getBuffers(chunk_i).results);
+		EdgeUpdateResult const         &edge_results        = workers.getBuffers(chunk_i).edge_results;
+		std::vector<uint64_t> const    &chunk_hit_edges     = (chunk_i == 0) ? (hit_edges) : (workers.getBuffers(chunk_i).hit_edges);
+
+		this->peak_buffer_bytes += (chunk_results.target_edges.capacity() + chunk_hit_edges.capacity()) * sizeof(uint64_t) + chunk_results.init_positions.capacity() * sizeof(Real) + chunk_results.init_directions.capacity() / 8;
+		this->peak_buffer_bytes += edge_results.target_edges.capacity() * sizeof(uint64_t) + edge_results.init_positions.capacity() * sizeof(Real) + edge_results.init_directions.capacity() / 8;
+	}
 
 	return runtime;
 }
 
 
 
-void rwe::RWSpace::invalidate(void)
+template <typename Real>
+void rwe::RWSpace<Real>::invalidate(void)
 {
 	if (this->wander_state != WanderState::dead)
+	{
 		this->wander_state = WanderState::invalid;
+		this->is_snapshot_valid = false;
+		this->changed_edges.clear();
+	}
+
+	return;
+}
+
+
+
+template <typename Real>
+void rwe::RWSpace<Real>::invalidateEdge(uint64_t const edge)
+{
+	if (this->wander_state == WanderState::dead)
+		return;
+
+	// 1. Once every edge might have changed, it is cheaper to recompile the whole graph
+	this->wander_state = WanderState::invalid;
+	if ((this->is_snapshot_valid) && (this->changed_edges.size() < this->compiled_graph.getEdgeCount()))
+		this->changed_edges.push_back(edge);
+	else
+		this->invalidate();
 
 	return;
 }
 
 
 
-void rwe::RWSpace::kill(void)
+template <typename Real>
+void rwe::RWSpace<Real>::kill(void)
 {
 	this->wander_state = WanderState::dead;
 
@@ -400,7 +614,85 @@ void rwe::RWSpace::kill(void)
 
 
 
-void rwe::RWSpace::updateEdgeState(uint32_t const vertex_1, uint32_t const vertex_2, long double const epsilon, long double const time_delta, EdgeUpdateResult &result)
+template <typename Real>
+void rwe::RWSpace<Real>::setVertexOrder(VertexOrder const vertex_order)
+{
+	if (this->vertex_order == vertex_order)
+		return;
+
+	this->vertex_order = vertex_order;
+	this->invalidate();
+
+	return;
+}
+
+
+
+template <typename Real>
+void rwe::RWSpace<Real>::setThreadCount(uint32_t const thread_count)
+{
+	this->thread_count = (thread_count > 0) ? (thread_count) : (1);
+
+	return;
+}
+
+
+
+template <typename Real>
+void rwe::RWSpace<Real>::checkSaturability(void)
+{
+	CompiledGraph<Real> const  &compiled_graph     = this->compiled_graph;
+	std::vector<uint32_t>       sources(compiled_graph.getEdgeCount());
+	std::vector<bool>           is_reached(compiled_graph.getVertexCount(), false);
+	std::vector<bool>           is_enterable(compiled_graph.getEdgeCount(), false);
+	std::vector<uint32_t>       reached;
+
+	// 1. Each agent is bound to reach the end point of its edge it moves towards
+	for (uint32_t vertex_1 = 0; vertex_1 < compiled_graph.getVertexCount(); ++vertex_1)
+		for (uint64_t edge_i = compiled_graph.offsets[vertex_1]; edge_i < compiled_graph.offsets[vertex_1 + 1]; ++edge_i)
+		{
+			sources[edge_i] = vertex_1;
+			for (uint64_t agent_i = 0; agent_i < this->graph_state[edge_i].agents.size(); ++agent_i)
+			{
+				uint32_t const hit_vertex = (this->graph_state[edge_i].agents[agent_i].direction) ? (compiled_graph.targets[edge_i]) : (vertex_1);
+				if (!is_reached[hit_vertex])
+				{
+					is_reached[hit_vertex] = true;
+					reached.push_back(hit_vertex);
+				}
+			}
+		}
+
+	// 2. Agents hitting a vertex enter all its departures and move on to their other end points
+	for (uint32_t head = 0; head < reached.size(); ++head)
+		for (uint64_t departure_i = compiled_graph.departure_offsets[reached[head]]; departure_i < compiled_graph.departure_offsets[reached[head] + 1]; ++departure_i)
+		{
+			typename CompiledGraph<Real>::Departure const  &curr_departure  = compiled_graph.departures[departure_i];
+			uint32_t const                                  next_vertex     = (curr_departure.direction) ? (compiled_graph.targets[curr_departure.edge]) : (sources[curr_departure.edge]);
+
+			is_enterable[curr_departure.edge] = true;
+			if (!is_reached[next_vertex])
+			{
+				is_reached[next_vertex] = true;
+				reached.push_back(next_vertex);
+			}
+		}
+
+	// 3. An edge which holds no agents and will never be entered again can not be saturated
+	for (uint64_t edge_i = 0; edge_i < compiled_graph.getEdgeCount(); ++edge_i)
+		if ((this->graph_state[edge_i].agents.empty()) && (!is_enterable[edge_i]))
+		{
+			this->wander_state = WanderState::invalid;
+			throw std::domain_error("Agents can not reach some edges any more, so the emulation would never saturate.");
+		}
+
+	return;
+}
+
+
+
+template <typename Real>
+void rwe::RWSpace<Real>::updateEdgeState(uint32_t const vertex_1, uint64_t const edge, Real const epsilon, Real const time_delta, EdgeUpdateResult &result)
 {
 	// 1.1. Check if wander state is "dead"
 	if (this->wander_state == WanderState::dead)
@@ -409,16 +701,17 @@ void rwe::RWSpace::updateEdgeState(uint32_t const vertex_1, uint32_t const verte
 	if (this->wander_state != WanderState::active)
 		throw std::logic_error("RWSpace object needs to be reset before running the emulation.");
 	
-	AgentInstanceList       &agents             = this->graph_state[vertex_1][vertex_2].agents;
-	long double const        length             = this->graph.edges[vertex_1].lengths[vertex_2];
-	bool const               is_directed        = this->graph.edges[vertex_1].is_directed[vertex_2];
+	CompiledGraph<Real> const   &compiled_graph     = this->compiled_graph;
+	AgentInstanceList           &agents             = this->graph_state[edge].agents;
+	Real const                   length             = compiled_graph.lengths[edge];
+	bool const               is_directed        = compiled_graph.isDirected(edge);
 	bool                     is_saturated       = true;
 	uint32_t                 agent_j;
 
 	//std::set<AgentInstance>  updated_agents;
 
 	result.collision_occured = false;
-	result.updated_edge = std::make_pair(vertex_1, vertex_2);
+	result.updated_edge = edge;
 	result.init_directions.clear();
 	result.init_positions.clear();
 	result.target_edges.clear();
@@ -431,20 +724,20 @@ void rwe::RWSpace::updateEdgeState(uint32_t const vertex_1, uint32_t const verte
 		// 2.1. If agent hit the vertex of the graph
 		if ((agents[agent_i].position >= length) || (agents[agent_i].position <= 0))
 		{
-			uint32_t const                  hit_vertex          = (agents[agent_i].position <= 0) ? (this->graph.edges[vertex_1].id) : (this->graph.edges[vertex_1].adjacents[vertex_2]);
-			long double const               delta_distance      = (agents[agent_i].position <= 0) ? (-agents[agent_i].position) : (std::fmod(agents[agent_i].position, length));
-			std::deque<MetricGraph::Edge>   curr_departures     = this->graph.getDepartingEdges(hit_vertex);
+			uint32_t const                      hit_vertex          = (agents[agent_i].position <= 0) ? (vertex_1) : (compiled_graph.targets[edge]);
+			Real const                          delta_distance      = (agents[agent_i].position <= 0) ? (-agents[agent_i].position) : (std::fmod(agents[agent_i].position, length));
 
 			result.collision_occured = true;
-			while (!curr_departures.empty())
+			for (uint64_t departure_i = compiled_graph.departure_offsets[hit_vertex]; departure_i < compiled_graph.departure_offsets[hit_vertex + 1]; ++departure_i)
 			{
-				if ((curr_departures.front().first != vertex_1) || (curr_departures.front().second != vertex_2))
+				typename CompiledGraph<Real>::Departure const &curr_departure = compiled_graph.departures[departure_i];
+
+				if (curr_departure.edge != edge)
 				{
-					result.init_positions.push_back((this->graph.edges[curr_departures.front().first].id == hit_vertex) ? (delta_distance) : (this->graph.edges[curr_departures.front().first].lengths[curr_departures.front().second] - delta_distance));
-					result.init_directions.push_back(this->graph.edges[curr_departures.front().first].id == hit_vertex);
-					result.target_edges.push_back(curr_departures.front());
+					result.init_positions.push_back((curr_departure.direction) ? (curr_departure.position + delta_distance) : (curr_departure.position - delta_distance));
+					result.init_directions.push_back(curr_departure.direction);
+					result.target_edges.push_back(curr_departure.edge);
 				}
-				curr_departures.pop_front();
 			}
 
 			if (is_directed)
@@ -476,7 +769,125 @@ void rwe::RWSpace::updateEdgeState(uint32_t const vertex_1, uint32_t const verte
 	else
 		is_saturated = false;*/
 	is_saturated &= (agents.size() > 0) && (agents[0].position < epsilon) && (length - agents.back().position < epsilon);
-	this->graph_state[vertex_1][vertex_2].is_saturated = is_saturated;
+	this->graph_state[edge].is_saturated = is_saturated;
 
 	return;
 }
+
+
+
+template <typename Real>
+bool const rwe::RWSpace<Real>::updateEdgeRange(ActiveEdgeList const &active_edges, uint64_t const first, uint64_t const last, Real const epsilon, Real const time_delta, EdgeUpdateResult &update_results, std::vector<uint64_t> &hit_edges, EdgeUpdateResult &curr_results)
+{
+	bool                is_saturated        = true;
+
+	// 1. Update edges one by one, appending agents they emit to the results in the order of edges; <curr_results> is
+	//    cleared by each update, so its memory is reused for all edges and steps
+	for (uint64_t active_i = first; active_i < last; ++active_i)
+	{
+		uint32_t const  vertex_1    = active_edges[active_i].second;
+		uint64_t const  edge_i      = active_edges[active_i].first;
+		uint64_t const  agent_count = this->graph_state[edge_i].agents.size();
+
+		this->updateEdgeState(vertex_1, edge_i, epsilon, time_delta, curr_results);
+		update_results.removed_agent_count += agent_count - this->graph_state[edge_i].agents.size();
+		if (curr_results.collision_occured)
+		{
+			update_results.target_edges.insert(update_results.target_edges.end(), curr_results.target_edges.begin(), curr_results.target_edges.end());
+			update_results.init_positions.insert(update_results.init_positions.end(), curr_results.init_positions.begin(), curr_results.init_positions.end());
+			update_results.init_directions.insert(update_results.init_directions.end(), curr_results.init_directions.begin(), curr_results.init_directions.end());
+			hit_edges.push_back(edge_i);
+		}
+		is_saturated &= this->graph_state[edge_i].is_saturated;
+	}
+
+	return is_saturated;
+}
+
+
+
+template <typename Real>
+void rwe::RWSpace<Real>::activateEdge(uint64_t const edge, std::vector<bool> &is_active, ActiveEdgeList &new_edges) const
+{
+	CompiledGraph<Real> const  &compiled_graph     = this->compiled_graph;
+
+	// 1. Queue <edge> together with its origin, unless it has already been activated
+	if (!is_active[edge])
+	{
+		is_active[edge] = true;
+		new_edges.emplace_back(edge, std::upper_bound(compiled_graph.offsets.begin(), compiled_graph.offsets.end(), edge) - compiled_graph.offsets.begin() - 1);
+	}
+
+	return;
+}
+
+
+
+template <typename Real>
+void rwe::RWSpace<Real>::mergeNewEdges(ActiveEdgeList &active_edges, ActiveEdgeList &new_edges) const
+{
+	// 1. Keep active edges sorted, so that they are updated in the order of the compiled graph
+	std::sort(new_edges.begin(), new_edges.end());
+	active_edges.insert(active_edges.end(), new_edges.begin(), new_edges.end());
+	std::inplace_merge(active_edges.begin(), active_edges.end() - new_edges.size(), active_edges.end());
+	new_edges.clear();
+
+	return;
+}
+
+
+
+template <typename Real>
+bool const rwe::RWSpace<Real>::updateActiveEdges(ActiveEdgeList const &active_edges, Real const epsilon, Real const time_delta, StepWorkers &workers, EdgeUpdateResult &update_results, std::vector<uint64_t> &hit_edges)
+{
+	uint64_t const  concurrency_threshold   = 256;
+	uint64_t const  chunk_count             = std::max<uint64_t>(std::min<uint64_t>(this->thread_count, active_edges.size() / concurrency_threshold), 1);
+	bool            is_saturated            = true;
+
+	// 1. Update chunks of active edges; chunk 0 is updated by the calling thread, the others by the workers
+	if (chunk_count == 1)
+		return this->updateEdgeRange(active_edges, 0, active_edges.size(), epsilon, time_delta, update_results, hit_edges, workers.getBuffers(0).edge_results);
+	workers.run(chunk_count, [this, &active_edges, &update_results, &hit_edges, &workers, chunk_count, epsilon, time_delta](uint32_t const chunk_i)
+	            {
+	                typename StepWorkers::ChunkBuffers &buffers             = workers.getBuffers(chunk_i);
+	                EdgeUpdateResult                   &chunk_results       = (chunk_i == 0) ? (update_results) : (buffers.results);
+	                std::vector<uint64_t>              &chunk_hit_edges     = (chunk_i == 0) ? (hit_edges) : (buffers.hit_edges);
+
+	                buffers.is_saturated = this->updateEdgeRange(active_edges, active_edges.size() * chunk_i / chunk_count, active_edges.size() * (chunk_i + 1) / chunk_count, epsilon, time_delta, chunk_results, chunk_hit_edges, buffers.edge_results);
+	            });
+
+	// 2. Merge results in the order of chunks
+	is_saturated = workers.getBuffers(0).is_saturated;
+	for (uint32_t chunk_i = 1; chunk_i < chunk_count; ++chunk_i)
+	{
+		typename StepWorkers::ChunkBuffers &buffers = workers.getBuffers(chunk_i);
+
+		update_results.target_edges.insert(update_results.target_edges.end(), buffers.results.target_edges.begin(), buffers.results.target_edges.end());
+		update_results.init_positions.insert(update_results.init_positions.end(), buffers.results.init_positions.begin(), buffers.results.init_positions.end());
+		update_results.init_directions.insert(update_results.init_directions.end(), buffers.results.init_directions.begin(), buffers.results.init_directions.end());
+		hit_edges.insert(hit_edges.end(), buffers.hit_edges.begin(), buffers.hit_edges.end());
+		update_results.removed_agent_count += buffers.results.removed_agent_count;
+		buffers.results.target_edges.clear();
+		buffers.results.init_positions.clear();
+		buffers.results.init_directions.clear();
+		buffers.hit_edges.clear();
+		buffers.results.removed_agent_count = 0;
+		is_saturated &= buffers.is_saturated;
+	}
+
+	return is_saturated;
+}
+
+
+
+
+
+// Explicit instantiations
+
+
+
+
+
+template class rwe::RWSpace<float>;
+template class rwe::RWSpace<double>;
+template class rwe::RWSpace<long double>;
@@ -13,6 +13,8 @@
 
 
 #include "../metric_graph/metric_graph.hpp"     // needed for "MetricGraph"
+#include "../compiled_graph/compiled_graph.hpp" // needed for "CompiledGraph"
+#include <utility>                              // needed for "pair"
 //#include <set>                                  // needed for "set"
 
 
@@ -33,6 +35,10 @@ namespace rwe
 	 * RW-space is a collection of all possible continuous-time random walks over some
 	 * graph represented by MetricGraph object.
 	 * 
+	 * Emulation never reads the MetricGraph object directly. Instead, each time the emulator
+	 * is reset from the \c invalid state, a read-only CompiledGraph snapshot of the graph is
+	 * built and all further work is done with it.
+	 * 
 	 * Each RWSpace object at each moment of time is in one of the following states:
 	 * * \c ready : RWSpace object is ready to start emulation;
 	 * * \c active : RWSpace object is in process of emulation;
@@ -40,7 +46,25 @@ namespace rwe
 	 * * \c dead : underlying MetricGraph object has been deleted.
 	 * 
 	 * \image html RWSpace_states.png
+	 * 
+	 * All lengths and positions of agent instances are stored as values of type \c Real, while
+	 * the emulation time itself is always accumulated in <tt>long double</tt>. Each time step
+	 * of length \f$\Delta t\f$ moves each agent instance with a single rounding, so after
+	 * \f$k\f$ steps the position of an agent instance on an edge of length \f$l\f$ deviates
+	 * from the exact one by at most \f$k u l\f$, where \f$u\f$ is the unit roundoff of
+	 * \c Real (see MetricGraph). The saturation moment found by the emulator shifts by at most
+	 * the same value, i.e., by
+	 * \f[
+	 *     \frac{T}{\Delta t} \cdot u \cdot \max_{e \in E} l(e),
+	 * \f]
+	 * where \f$T\f$ is the saturation time. For example, with \f$T = 10\f$,
+	 * \f$\Delta t = 10^{-6}\f$ and unit lengths the bound is about \f$10^{-9}\f$ for \c double
+	 * and \f$0.6\f$ for \c float, so \c float is only suitable for coarse time steps.
+	 * 
+	 * \tparam  Real    Type of lengths and positions; \c float, \c double and <tt>long double</tt>
+	 *                  are supported.
 	 */
+	template <typename Real>
 	class RWSpace
 	{
 
@@ -62,7 +86,7 @@ namespace rwe
 		 * 
 		 * \note Right after the end of construction the new RWSpace object will be in the \c ready state.
 		 */
-		explicit RWSpace    (MetricGraph &graph);
+		explicit RWSpace    (MetricGraph<Real> &graph);
 
 		/**
 		 * Default destructor
@@ -89,6 +113,46 @@ namespace rwe
 
 
 
+		/// \name Accessors
+		///@{
+
+		/**
+		 * Get memory footprint
+		 * 
+		 * Breaks down the bytes held by the emulator: arrays of the CompiledGraph snapshot,
+		 * states of edges, lists of agent instances (by their capacities), the list of changed
+		 * edges and buffers used during emulation (lists of edges holding agents, queues of
+		 * events, agent instances emitted at each step).
+		 * 
+		 * Buffers are released at the end of each run, so only their peak over the last run of
+		 * \ref run_saturation that has reached saturation is reported. Lists of agent instances
+		 * never release memory until the snapshot is rebuilt, so their peaks equal current
+		 * values.
+		 * 
+		 * \return Memory footprint of the emulator.
+		 */
+		MemoryUsage const           getMemoryUsage          (void)  const;
+
+		/**
+		 * Get peak number of agent instances
+		 * 
+		 * \return The largest number of agent instances alive at once during the last run of
+		 * \ref run_saturation that has reached saturation (0 before the first one).
+		 */
+		uint64_t const              getPeakAgentCount       (void)  const;
+
+		/**
+		 * Get capacities of lists of agent instances
+		 * 
+		 * \return \c std::vector of numbers of agent instances each edge can hold without
+		 * reallocation, in the order of edge indices of the CompiledGraph snapshot.
+		 */
+		std::vector<uint64_t> const getAgentListCapacities  (void)  const;
+
+		///@}
+
+
+
 		/// \name Modifiers
 		///@{
 
@@ -97,6 +161,12 @@ namespace rwe
 		 * 
 		 * Transfers the emulator into the \c ready state.
 		 * 
+		 * The CompiledGraph snapshot is only rebuilt if edges of the underlying graph have been
+		 * added or have changed their directions since the last reset (or if the emulator has
+		 * been invalidated explicitly). If only lengths of some edges have changed, just these
+		 * edges are updated in the snapshot. In both cases, states of edges are cleared in place,
+		 * so that memory allocated for agent instances by previous emulations is reused.
+		 * 
 		 * \note The RWSpace object needs to be in the \c invalid state in order to be reset.
 		 * 
 		 * \throw logic_error if the RWSpace object is in either \c active or \c dead states
@@ -114,7 +184,17 @@ namespace rwe
 		 * RW-space is said to be \f$\varepsilon\f$<b>-saturated</b> at time moment \f$t_0\f$, if agents
 		 * form an \f$\varepsilon\f$-net on each edge of the graph at \f$t_0\f$.
 		 * 
-		 * No explicit checks of existence of the \f$\varepsilon\f$-saturation moments are made.
+		 * Runs which provably never saturate are rejected:
+		 * * before the emulation starts, if some edge can not be reached from the start vertex,
+		 * or if no vertex has more than one departure (so the number of agent instances never
+		 * grows) and there are fewer agent instances than the \f$\sum_{e \in E}
+		 * (\lfloor l(e) / 2\varepsilon \rfloor + 1)\f$ ones needed to form the nets;
+		 * * during the emulation, if some edge holds no agent instances and none of them can ever
+		 * enter it again (e.g., all of them have left a part of a directed graph they can not
+		 * return to). This is checked on iterations \f$1,2,4,8,...\f$, so that the check takes a
+		 * negligible share of the emulation time.
+		 * 
+		 * Other runs are not guaranteed to saturate.
 		 * 
 		 * \param   start_vertex        Vertex where the initial agent instance will be spawned.
 		 * \param   epsilon             Parameter \f$\varepsilon\f$ of \f$\varepsilon\f$-saturation.
@@ -134,15 +214,21 @@ namespace rwe
 		 * \throw logic_error if the RWSpace object is either in \c active, or \c invalid, or \c dead
 		 * states at the moment of function call.
 		 * \throw invalid_argument if initial vertex does not exist in the graph.
-		 * \throw runtime_error if CPU concurrency has been enabled, however, it is not supported
-		 * by the platform.
+		 * \throw domain_error if time step of emulation does not exceed the rounding error
+		 * \f$2 u \max_{e \in E} l(e)\f$ of positions, or if the emulation would never saturate
+		 * (see above); in the latter case the RWSpace object is transferred into the \c invalid
+		 * state, unless the run has been rejected before the start.
+		 * \throw runtime_error if several threads have been requested (see \ref setThreadCount),
+		 * however, the platform fails to start them; the threads already started are stopped and
+		 * the RWSpace object stays in the \c ready state.
 		 */
-		long double const   run_saturation  (uint32_t const start_vertex, long double const epsilon, long double const time_delta = 1e-6L, bool const use_skip_forward = true);
+		long double const   run_saturation  (uint32_t const start_vertex, Real const epsilon, Real const time_delta = 1e-6L, bool const use_skip_forward = true);
 
 		/**
 		 * Invalidates the emulator
 		 * 
-		 * Transfers the emulator into the \c invalid state.
+		 * Transfers the emulator into the \c invalid state. The CompiledGraph snapshot will be
+		 * rebuilt by the next \ref reset.
 		 * 
 		 * \note If the RWSpace object is in the \c dead state at the moment of function call, this
 		 * function call will have no effect.
@@ -156,23 +242,74 @@ namespace rwe
 		 */
 		void                kill        (void);
 
+		/**
+		 * Set order of edges in memory
+		 * 
+		 * Chooses how the CompiledGraph snapshot used by the emulator renumbers the vertices
+		 * of the graph. Both edges and their states are laid out in this order, so orders
+		 * which keep adjacent vertices close (\c bfs_order and \c rcm_order) make agent
+		 * instances travel between edges which are close in memory. With \c bfs_order, the
+		 * snapshot is rebuilt around the start vertex of each emulation.
+		 * 
+		 * The order never affects the result of emulation beyond floating-point rounding.
+		 * By default, \c id_order is used.
+		 * 
+		 * \param   vertex_order    Desired order of vertices.
+		 * 
+		 * \note If the order is changed, the RWSpace object is transferred into the \c invalid
+		 * state (unless it is \c dead).
+		 */
+		void                setVertexOrder  (VertexOrder const vertex_order);
+
+		/**
+		 * Set the number of threads
+		 * 
+		 * Chooses how many threads update edges at each step of emulation. Edges holding agent
+		 * instances are split into contiguous chunks, one per thread, and the results of all
+		 * chunks are merged in the order of edges, so the result of emulation does not depend on
+		 * the number of threads. Fewer threads are used while there are too few such edges for
+		 * each thread to have a chunk of reasonable size, since waking them up at each step is
+		 * not free. The threads are started once per emulation and reused at all of its steps.
+		 * 
+		 * By default, a single thread is used.
+		 * 
+		 * \param   thread_count    Desired number of threads; 0 is treated as 1.
+		 */
+		void                setThreadCount  (uint32_t const thread_count);
+
 		///@}
 	private:
+		friend class MetricGraph<Real>;
+
 		using WanderState           = enum WanderStateEnum {ready, active, invalid, dead};
-		using AgentInstance         = struct AgentInstanceStruct {long double position; bool direction : 1; bool inline operator<(AgentInstanceStruct const &other) const;};
+		using AgentInstance         = struct AgentInstanceStruct {Real position; bool direction : 1; bool inline operator<(AgentInstanceStruct const &other) const;};
 		using AgentInstanceList     = std::vector<AgentInstance>;
 		//using AgentInstanceList     = std::set<AgentInstance>;
 		using EdgeState             = struct {AgentInstanceList agents; bool is_saturated : 1;};
-		using NeighbourhoodState    = std::vector<EdgeState>;
-		using GraphState            = std::vector<NeighbourhoodState>;
-		using EdgeUpdateResult      = struct {bool collision_occured = false; MetricGraph::Edge updated_edge; std::deque<MetricGraph::Edge> target_edges; std::deque<long double> init_positions; std::deque<bool> init_directions;};
-
-		MetricGraph         &graph;
-		GraphState           graph_state;
-		WanderState          wander_state;
+		using GraphState            = std::vector<EdgeState>;
+		using EdgeUpdateResult      = struct {bool collision_occured = false; uint64_t updated_edge; std::vector<uint64_t> target_edges; std::vector<Real> init_positions; std::vector<bool> init_directions; uint64_t removed_agent_count = 0;};
+		using ActiveEdgeList        = std::vector<std::pair<uint64_t, uint32_t>>;
+		class StepWorkers;
+
+		MetricGraph<Real>           &graph;
+		CompiledGraph<Real>          compiled_graph;
+		VertexOrder                  vertex_order;
+		uint32_t                     thread_count;
+		GraphState                   graph_state;
+		std::vector<uint64_t>        changed_edges;
+		bool                         is_snapshot_valid;
+		WanderState                  wander_state;
+		uint64_t                     peak_agent_count;
+		uint64_t                     peak_buffer_bytes;
 
 		// Modifiers
-		void updateEdgeState(uint32_t vertex_1, uint32_t vertex_2, long double const epsilon, long double const time_delta, EdgeUpdateResult &result);
+		void invalidateEdge(uint64_t const edge);
+		void checkSaturability(void);
+		void updateEdgeState(uint32_t vertex_1, uint64_t edge, Real const epsilon, Real const time_delta, EdgeUpdateResult &result);
+		bool const updateEdgeRange(ActiveEdgeList const &active_edges, uint64_t const first, uint64_t const last, Real const epsilon, Real const time_delta, EdgeUpdateResult &update_results, std::vector<uint64_t> &hit_edges, EdgeUpdateResult &curr_results);
+		void activateEdge(uint64_t const edge, std::vector<bool> &is_active, ActiveEdgeList &new_edges) const;
+		void mergeNewEdges(ActiveEdgeList &active_edges, ActiveEdgeList &new_edges) const;
+		bool const updateActiveEdges(ActiveEdgeList const &active_edges, Real const epsilon, Real const time_delta, StepWorkers &workers, EdgeUpdateResult &update_results, std::vector<uint64_t> &hit_edges);
 	};
 
 
@@ -0,0 +1,360 @@
+/**
+ * \file
+ *       rweg.cpp
+ *
+ * \author
+ *       Andrei Eliseev (JointPoints), 2021
+ */
+#include "rweg.hpp"
+
+#include <stdexcept>    // needed for exceptions
+#include <algorithm>    // needed for "binary_search", "min"
+#include <cstring>      // needed for "memcpy", "memcmp"
+#include <limits>       // needed for "numeric_limits"
+#include <vector>       // needed for "vector"
+
+
+
+
+
+namespace
+{
+	char const          rweg_signature[8]       = {'\x89', 'R', 'W', 'E', 'G', '\r', '\n', '\x1A'};
+	uint32_t const      rweg_version            = 2;
+	uint32_t const      rweg_byte_order         = 0x01020304;
+	uint32_t const      rweg_swapped_byte_order = 0x04030201;
+	uint64_t const      rweg_alignment          = 64;
+	uint64_t const      fnv_offset_basis        = 14695981039346656037ULL;
+	uint64_t const      fnv_prime               = 1099511628211ULL;
+
+	static_assert(sizeof(rwe::RWEGHeader) == 64, "Header of rweg files must occupy exactly 64 bytes.");
+	static_assert(std::numeric_limits<double>::is_iec559, "Lengths in rweg files are stored as IEEE 754 binary64 numbers.");
+}
+
+
+
+
+
+// Constructors and destructors
+
+
+
+
+
+rwe::RWEGFile::RWEGFile(void) :
+	file(), header(), section_offsets()
+{
+	// Intended to be empty
+}
+
+
+
+rwe::RWEGFile::RWEGFile(std::string const file_name, bool const validate) :
+	RWEGFile(MappedFile(file_name), validate)
+{
+	// Intended to be empty
+}
+
+
+
+rwe::RWEGFile::RWEGFile(MappedFile &&file, bool const validate) :
+	file(std::move(file)), header(), section_offsets()
+{
+	if (!this->file.isOpen())
+		return;
+	this->checkHeader();
+	if (validate)
+		this->checkSections();
+}
+
+
+
+
+
+// Access
+
+
+
+
+
+bool const rwe::RWEGFile::isOpen(void) const
+{
+	return this->file.isOpen();
+}
+
+
+
+uint32_t const rwe::RWEGFile::getVertexCount(void) const
+{
+	return this->header.vertex_count;
+}
+
+
+
+uint64_t const rwe::RWEGFile::getEdgeCount(void) const
+{
+	return this->header.edge_count;
+}
+
+
+
+uint32_t const * rwe::RWEGFile::getVertexIDs(void) const
+{
+	return reinterpret_cast<uint32_t const *>(this->file.getData() + this->section_offsets[0]);
+}
+
+
+
+uint64_t const * rwe::RWEGFile::getOffsets(void) const
+{
+	return reinterpret_cast<uint64_t const *>(this->file.getData() + this->section_offsets[1]);
+}
+
+
+
+uint32_t const * rwe::RWEGFile::getTargets(void) const
+{
+	return reinterpret_cast<uint32_t const *>(this->file.getData() + this->section_offsets[2]);
+}
+
+
+
+double const * rwe::RWEGFile::getLengths(void) const
+{
+	return reinterpret_cast<double const *>(this->file.getData() + this->section_offsets[3]);
+}
+
+
+
+uint64_t const * rwe::RWEGFile::getDirections(void) const
+{
+	return reinterpret_cast<uint64_t const *>(this->file.getData() + this->section_offsets[4]);
+}
+
+
+
+bool const rwe::RWEGFile::isDirected(uint64_t const edge) const
+{
+	return (this->getDirections()[edge / 64] >> (edge % 64)) & 1;
+}
+
+
+
+
+
+// Checks
+
+
+
+
+
+void rwe::RWEGFile::checkHeader(void)
+{
+	// 1. The header has to be present and carry the signature, the version and the byte order of this platform
+	if (this->file.getSize() < sizeof(RWEGHeader))
+		throw std::runtime_error("The file is too short to be an rweg file of version 2.");
+	std::memcpy(&this->header, this->file.getData(), sizeof(RWEGHeader));
+	if (std::memcmp(this->header.signature, rweg_signature, sizeof(rweg_signature)) != 0)
+		throw std::runtime_error("The file is not an rweg file of version 2.");
+	if (this->header.version != rweg_version)
+		throw std::runtime_error("Version " + std::to_string(this->header.version) + " of rweg format is not supported.");
+	if (this->header.byte_order == rweg_swapped_byte_order)
+		throw std::runtime_error("The rweg file was written on a platform with the opposite byte order.");
+	if ((this->header.byte_order != rweg_byte_order) || (this->header.header_size != sizeof(RWEGHeader)) || (this->header.alignment != rweg_alignment))
+		throw std::runtime_error("The header of the rweg file is corrupted.");
+
+	// 2. Sizes of sections have to agree with the size of the file, the latter bounds the counts and prevents overflows
+	if ((this->header.vertex_count > std::numeric_limits<uint32_t>::max()) || (this->header.edge_count > this->file.getSize()))
+		throw std::runtime_error("The header of the rweg file is corrupted.");
+	computeLayout(this->header.vertex_count, this->header.edge_count, this->section_offsets);
+	if ((this->header.file_size != this->section_offsets[5]) || (this->file.getSize() != this->section_offsets[5]))
+		throw std::runtime_error("The rweg file is truncated or has trailing data.");
+
+	return;
+}
+
+
+
+void rwe::RWEGFile::checkSections(void) const
+{
+	// 1. The contents have to match the checksum
+	if (hashBytes(fnv_offset_basis, this->file.getData() + sizeof(RWEGHeader), this->file.getSize() - sizeof(RWEGHeader), this->file.getSize() - sizeof(RWEGHeader)) != this->header.checksum)
+		throw std::runtime_error("The checksum of the rweg file does not match its contents.");
+
+	// 2. The sections have to describe a metric graph
+	checkStructure(this->getVertexCount(), this->getEdgeCount(), this->getVertexIDs(), this->getOffsets(), this->getTargets(), this->getLengths(), this->getDirections());
+
+	return;
+}
+
+
+
+void rwe::RWEGFile::checkStructure(uint32_t const vertex_count, uint64_t const edge_count, uint32_t const *vertex_ids, uint64_t const *offsets, uint32_t const *targets, double const *lengths, uint64_t const *directions)
+{
+	std::vector<bool>       is_reached(vertex_count, false);
+	uint64_t                reached_count   = 0;
+	auto const              reach           = [&is_reached, &reached_count](uint32_t const vertex_index)
+	                                          {
+	                                              reached_count += !is_reached[vertex_index];
+	                                              is_reached[vertex_index] = true;
+	                                          };
+	auto const              is_directed     = [directions](uint64_t const edge)
+	                                          {
+	                                              return ((directions[edge / 64] >> (edge % 64)) & 1) != 0;
+	                                          };
+
+	// 1. Vertex IDs have to be ascending, and rows have to cover all edges
+	for (uint32_t vertex_1 = 1; vertex_1 < vertex_count; ++vertex_1)
+		if (vertex_ids[vertex_1 - 1] >= vertex_ids[vertex_1])
+			throw std::runtime_error("Vertices of the rweg file are not sorted by their IDs.");
+	if ((offsets[0] != 0) || (offsets[vertex_count] != edge_count))
+		throw std::runtime_error("Offsets of rows of the rweg file are corrupted.");
+
+	// 2. Each row has to be sorted by targets, and each edge has to be stored the same way as in MetricGraph
+	for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+	{
+		if ((offsets[vertex_1 + 1] < offsets[vertex_1]) || (offsets[vertex_1 + 1] > edge_count))
+			throw std::runtime_error("Offsets of rows of the rweg file are corrupted.");
+		for (uint64_t edge = offsets[vertex_1]; edge < offsets[vertex_1 + 1]; ++edge)
+		{
+			uint32_t const vertex_2 = targets[edge];
+
+			if ((vertex_2 >= vertex_count) || ((edge > offsets[vertex_1]) && (targets[edge - 1] >= vertex_2)))
+				throw std::runtime_error("Targets of edges of the rweg file are corrupted.");
+			if ((!(lengths[edge] > 0.0)) || (lengths[edge] == std::numeric_limits<double>::infinity()))
+				throw std::runtime_error("Lengths of edges of the rweg file must be positive finite numbers.");
+			if ((!is_directed(edge)) && (vertex_2 < vertex_1))
+				throw std::runtime_error("An undirected edge of the rweg file is not stored under its end point with the lower ID.");
+			if ((is_directed(edge)) && (vertex_2 != vertex_1) && (offsets[vertex_2] <= offsets[vertex_2 + 1]) && (offsets[vertex_2 + 1] <= edge_count) && (std::binary_search(targets + offsets[vertex_2], targets + offsets[vertex_2 + 1], vertex_1)))
+				throw std::runtime_error("A directed edge of the rweg file has its opposite counterpart stored separately.");
+			reach(vertex_1);
+			reach(vertex_2);
+		}
+	}
+
+	// 3. Every vertex has to be an end point of some edge
+	if (reached_count != vertex_count)
+		throw std::runtime_error("The rweg file contains isolated vertices.");
+
+	return;
+}
+
+
+
+
+
+// Save/load
+
+
+
+
+
+bool const rwe::RWEGFile::checkSignature(char const *data, uint64_t const size)
+{
+	return (data != nullptr) && (size >= sizeof(rweg_signature)) && (std::memcmp(data, rweg_signature, sizeof(rweg_signature)) == 0);
+}
+
+
+
+uint64_t const rwe::RWEGFile::computeChecksum(char const *bytes, uint64_t const byte_count)
+{
+	return hashBytes(fnv_offset_basis, bytes, byte_count, (byte_count + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t));
+}
+
+
+
+void rwe::RWEGFile::write(std::ostream &out_stream, uint32_t const vertex_count, uint64_t const edge_count, uint32_t const *vertex_ids, uint64_t const *offsets, uint32_t const *targets, double const *lengths, uint64_t const *directions)
+{
+	char const             *sections[5]     = {reinterpret_cast<char const *>(vertex_ids), reinterpret_cast<char const *>(offsets), reinterpret_cast<char const *>(targets), reinterpret_cast<char const *>(lengths), reinterpret_cast<char const *>(directions)};
+	uint64_t const          section_sizes[5]= {vertex_count * sizeof(uint32_t), (vertex_count + uint64_t(1)) * sizeof(uint64_t), edge_count * sizeof(uint32_t), edge_count * sizeof(double), (edge_count + 63) / 64 * sizeof(uint64_t)};
+	char const              padding[rweg_alignment] = {};
+	uint64_t                checksum        = fnv_offset_basis;
+	uint64_t                section_offsets[6];
+
+	// 1. The checksum needs one pass over all sections
+	computeLayout(vertex_count, edge_count, section_offsets);
+	for (uint8_t section_i = 0; section_i < 5; ++section_i)
+		checksum = hashBytes(checksum, sections[section_i], section_sizes[section_i], section_offsets[section_i + 1] - section_offsets[section_i]);
+
+	// 2. Write the header and the sections padded with zeros
+	writeHeader(out_stream, vertex_count, edge_count, checksum);
+	for (uint8_t section_i = 0; section_i < 5; ++section_i)
+	{
+		out_stream.write(sections[section_i], section_sizes[section_i]);
+		out_stream.write(padding, section_offsets[section_i + 1] - section_offsets[section_i] - section_sizes[section_i]);
+	}
+
+	return;
+}
+
+
+
+
+
+void rwe::RWEGFile::writeHeader(std::ostream &out_stream, uint32_t const vertex_count, uint64_t const edge_count, uint64_t const checksum)
+{
+	RWEGHeader              header          = {};
+	uint64_t                section_offsets[6];
+
+	computeLayout(vertex_count, edge_count, section_offsets);
+	std::memcpy(header.signature, rweg_signature, sizeof(rweg_signature));
+	header.version = rweg_version;
+	header.byte_order = rweg_byte_order;
+	header.header_size = sizeof(RWEGHeader);
+	header.alignment = rweg_alignment;
+	header.vertex_count = vertex_count;
+	header.edge_count = edge_count;
+	header.file_size = section_offsets[5];
+	header.checksum = checksum;
+	out_stream.write(reinterpret_cast<char const *>(&header), sizeof(RWEGHeader));
+
+	return;
+}
+
+
+
+
+
+// Layout
+
+
+
+
+
+void rwe::RWEGFile::computeLayout(uint64_t const vertex_count, uint64_t const edge_count, uint64_t section_offsets[6])
+{
+	uint64_t const section_sizes[5] = {vertex_count * sizeof(uint32_t), (vertex_count + 1) * sizeof(uint64_t), edge_count * sizeof(uint32_t), edge_count * sizeof(double), (edge_count + 63) / 64 * sizeof(uint64_t)};
+
+	// 1. Each section starts at the first multiple of the alignment after the previous one
+	section_offsets[0] = sizeof(RWEGHeader);
+	for (uint8_t section_i = 0; section_i < 5; ++section_i)
+		section_offsets[section_i + 1] = (section_offsets[section_i] + section_sizes[section_i] + rweg_alignment - 1) / rweg_alignment * rweg_alignment;
+
+	return;
+}
+
+
+
+uint64_t const rwe::RWEGFile::hashBytes(uint64_t hash, char const *bytes, uint64_t const byte_count, uint64_t const padded_count)
+{
+	uint64_t word = 0;
+
+	// 1. Full words of the data
+	for (uint64_t byte_i = 0; byte_i + sizeof(word) <= byte_count; byte_i += sizeof(word))
+	{
+		std::memcpy(&word, bytes + byte_i, sizeof(word));
+		hash = (hash ^ word) * fnv_prime;
+	}
+
+	// 2. The last incomplete word is completed with zeros, and so are the words of padding
+	word = 0;
+	if (byte_count % sizeof(word) != 0)
+	{
+		std::memcpy(&word, bytes + byte_count / sizeof(word) * sizeof(word), byte_count % sizeof(word));
+		hash = (hash ^ word) * fnv_prime;
+	}
+	for (uint64_t word_i = (byte_count + sizeof(word) - 1) / sizeof(word); word_i < padded_count / sizeof(word); ++word_i)
+		hash *= fnv_prime;
+
+	return hash;
+}
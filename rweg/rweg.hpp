@@ -0,0 +1,320 @@
+/**
+ * \file
+ *       rweg.hpp
+ *
+ * \author
+ *       Andrei Eliseev (JointPoints), 2021
+ */
+#ifndef RWE__RWEG_HPP__
+#define RWE__RWEG_HPP__
+
+
+
+
+
+#include "../mapped_file/mapped_file.hpp"       // needed for "MappedFile"
+#include <string>                               // needed for "string"
+#include <iostream>                             // needed for "ostream"
+#include <cstdint>                              // needed for "int*_t" and "uint*_t" types
+
+
+
+
+
+namespace rwe
+{
+
+
+
+
+
+	/**
+	 * \brief Header of an \c rweg file of version 2
+	 *
+	 * * \c signature : bytes <tt>89 52 57 45 47 0D 0A 1A</tt> (<tt>\\x89RWEG\\r\\n\\x1A</tt>);
+	 * * \c version : version of the format, 2;
+	 * * \c byte_order : number \c 0x01020304 in the byte order of the platform which wrote the
+	 * file;
+	 * * \c header_size : size of the header in bytes, 64;
+	 * * \c alignment : alignment of sections in bytes, 64;
+	 * * \c vertex_count and \c edge_count : \f$|V|\f$ and \f$|E|\f$;
+	 * * \c file_size : size of the whole file in bytes;
+	 * * \c checksum : checksum of everything that follows the header (see RWEGFile);
+	 * * \c reserved : zero.
+	 */
+	using RWEGHeader        = struct RWEGHeaderStruct {char signature[8]; uint32_t version; uint32_t byte_order; uint32_t header_size; uint32_t alignment; uint64_t vertex_count; uint64_t edge_count; uint64_t file_size; uint64_t checksum; uint64_t reserved;};
+
+
+
+
+
+	/**
+	 * \class RWEGFile
+	 * \brief A read-only view of an \c rweg file of version 2
+	 *
+	 * Version 1 of the \c rweg format is a headerless sequence of edge records, each consisting
+	 * of two 32-bit vertex IDs, a <tt>long double</tt> length and a \c bool direction in the
+	 * native representation of the platform. Such files depend on the size and padding of
+	 * <tt>long double</tt> and have to be replayed edge by edge on load.
+	 *
+	 * Version 2 stores the graph in the same CSR (compressed sparse row) form as
+	 * CompiledGraph with \c id_order uses, so that it can be used right from a memory mapping.
+	 * A file consists of the 64-byte header (see rwe::RWEGHeader) followed by five sections,
+	 * each starting at an offset which is a multiple of 64 and padded with zeros up to the next
+	 * such offset:
+	 *
+	 * 1. IDs of vertices, \f$|V|\f$ 32-bit unsigned integers in the ascending order; the
+	 * position of a vertex in this section is its <b>dense index</b>;
+	 * 2. offsets of rows, \f$|V|+1\f$ 64-bit unsigned integers, so that edges stored under the
+	 * vertex with dense index \f$i\f$ occupy positions from <tt>offsets[i]</tt> to
+	 * <tt>offsets[i + 1] - 1</tt> of the following sections;
+	 * 3. dense indices of targets, \f$|E|\f$ 32-bit unsigned integers, ascending within each row;
+	 * 4. lengths, \f$|E|\f$ IEEE 754 binary64 numbers;
+	 * 5. directions, \f$\lceil |E| / 64 \rceil\f$ 64-bit words, bit \f$k \bmod 64\f$ of word
+	 * \f$\lfloor k / 64 \rfloor\f$ is set iff the \f$k\f$-th edge is directed.
+	 *
+	 * Edges are stored the same way as in MetricGraph: directed edges \f$v \rightarrow w\f$
+	 * under \f$v\f$, undirected edges \f$v-w\f$ under \f$\min\{v,w\}\f$. Every vertex is an end
+	 * point of at least one edge. All numbers are written in the byte order of the platform;
+	 * files written with the opposite byte order are rejected. The checksum is the 64-bit
+	 * FNV-1a hash of the part of the file after the header taken as a sequence of 64-bit words.
+	 *
+	 * The view maps the file into memory (see MappedFile) and exposes its sections as arrays
+	 * without copying them. The mapping, and hence all pointers obtained from the view, live as
+	 * long as the view does.
+	 */
+	class RWEGFile
+	{
+
+
+
+	public:
+
+
+
+		/// \name Constructors and destructors
+		///@{
+
+		/**
+		 * Default constructor
+		 *
+		 * Constructs a view which is not associated with any file.
+		 */
+		RWEGFile                    (void);
+
+		/**
+		 * Opening constructor
+		 *
+		 * Maps the specified file into memory and checks its header. If the file does not exist,
+		 * the view is left closed (see \ref isOpen).
+		 *
+		 * \param   file_name   Name of an \c rweg file.
+		 * \param   validate    If \c true, the checksum and the structure of all sections are
+		 *                      verified as well, which requires a pass over the whole file.
+		 *
+		 * \throw runtime_error if the file is not a valid \c rweg file of version 2.
+		 */
+		explicit RWEGFile           (std::string const file_name, bool const validate = true);
+
+		/**
+		 * Adopting constructor
+		 *
+		 * Takes over an existing mapping of a file and checks its header.
+		 *
+		 * \param   file        Mapping of an \c rweg file; it is left closed.
+		 * \param   validate    The same as in the opening constructor.
+		 *
+		 * \throw runtime_error if the file is not a valid \c rweg file of version 2.
+		 */
+		explicit RWEGFile           (MappedFile &&file, bool const validate = true);
+
+		// Prevent implicit creation of copy-constructor and the copy assignment operator
+		RWEGFile                    (RWEGFile &)        = delete;
+		RWEGFile &      operator =  (RWEGFile &)        = delete;
+
+		///@}
+
+
+
+		/// \name Accessors
+		///@{
+
+		/**
+		 * Check if a file is open
+		 *
+		 * \return \c true, if a file is open, \c false otherwise.
+		 */
+		bool const          isOpen          (void)                  const;
+
+		/**
+		 * Get the number of vertices
+		 *
+		 * \return \f$|V|\f$.
+		 */
+		uint32_t const      getVertexCount  (void)                  const;
+
+		/**
+		 * Get the number of edges
+		 *
+		 * \return \f$|E|\f$.
+		 */
+		uint64_t const      getEdgeCount    (void)                  const;
+
+		/**
+		 * Get IDs of vertices
+		 *
+		 * \return Pointer to the first element of section 1.
+		 */
+		uint32_t const *    getVertexIDs    (void)                  const;
+
+		/**
+		 * Get offsets of rows
+		 *
+		 * \return Pointer to the first element of section 2.
+		 */
+		uint64_t const *    getOffsets      (void)                  const;
+
+		/**
+		 * Get targets of edges
+		 *
+		 * \return Pointer to the first element of section 3.
+		 */
+		uint32_t const *    getTargets      (void)                  const;
+
+		/**
+		 * Get lengths of edges
+		 *
+		 * \return Pointer to the first element of section 4.
+		 */
+		double const *      getLengths      (void)                  const;
+
+		/**
+		 * Get directions of edges
+		 *
+		 * \return Pointer to the first word of section 5.
+		 */
+		uint64_t const *    getDirections   (void)                  const;
+
+		/**
+		 * Check if an edge is directed
+		 *
+		 * \param   edge    Position of the edge in sections 3-5.
+		 *
+		 * \return \c true, if the edge is directed, \c false otherwise.
+		 */
+		bool const          isDirected      (uint64_t const edge)   const;
+
+		///@}
+
+
+
+		/// \name Save/load
+		///@{
+
+		/**
+		 * Check the signature
+		 *
+		 * \param   data    Pointer to the beginning of a file.
+		 * \param   size    Size of the file in bytes.
+		 *
+		 * \return \c true, if the file begins with the signature of version 2 (see
+		 * rwe::RWEGHeader), \c false otherwise.
+		 */
+		static bool const   checkSignature  (char const *data, uint64_t const size);
+
+		/**
+		 * Check the structure of a graph
+		 *
+		 * Checks that the arrays meet all requirements listed above for the sections of a file,
+		 * so that graphs obtained in any other way (e.g., decoded from an \c rwegz file, see
+		 * RWEGZFile) can be trusted the same way as validated \c rweg files.
+		 *
+		 * \param   vertex_count    \f$|V|\f$.
+		 * \param   edge_count      \f$|E|\f$.
+		 * \param   vertex_ids      Contents of section 1.
+		 * \param   offsets         Contents of section 2.
+		 * \param   targets         Contents of section 3.
+		 * \param   lengths         Contents of section 4.
+		 * \param   directions      Contents of section 5.
+		 *
+		 * \throw runtime_error if any requirement is violated.
+		 */
+		static void         checkStructure  (uint32_t const vertex_count, uint64_t const edge_count, uint32_t const *vertex_ids, uint64_t const *offsets, uint32_t const *targets, double const *lengths, uint64_t const *directions);
+
+		/**
+		 * Compute a checksum
+		 *
+		 * \param   bytes       Pointer to the data.
+		 * \param   byte_count  Size of the data in bytes.
+		 *
+		 * \return The 64-bit FNV-1a hash of the data taken as a sequence of 64-bit words, the last
+		 * incomplete word being completed with zeros.
+		 */
+		static uint64_t const   computeChecksum (char const *bytes, uint64_t const byte_count);
+
+		/**
+		 * Compute offsets of sections
+		 *
+		 * \param   vertex_count        \f$|V|\f$.
+		 * \param   edge_count          \f$|E|\f$.
+		 * \param   section_offsets     Receives the offsets of all five sections in bytes followed
+		 *                              by the size of the whole file.
+		 */
+		static void         computeLayout   (uint64_t const vertex_count, uint64_t const edge_count, uint64_t section_offsets[6]);
+
+		/**
+		 * Write the header of an \c rweg file of version 2
+		 *
+		 * Allows to write sections by any other means (e.g., piece by piece at the offsets given
+		 * by \ref computeLayout) and only sign the file once its checksum is known.
+		 *
+		 * \param   out_stream      A binary stream positioned at the beginning of the file.
+		 * \param   vertex_count    \f$|V|\f$.
+		 * \param   edge_count      \f$|E|\f$.
+		 * \param   checksum        Checksum of everything that follows the header (see
+		 *                          \ref computeChecksum).
+		 */
+		static void         writeHeader     (std::ostream &out_stream, uint32_t const vertex_count, uint64_t const edge_count, uint64_t const checksum);
+
+		/**
+		 * Write an \c rweg file of version 2
+		 *
+		 * Writes the header and all sections (see above) to the specified stream. The arrays
+		 * must satisfy all requirements listed above.
+		 *
+		 * \param   out_stream      A binary stream to write to.
+		 * \param   vertex_count    \f$|V|\f$.
+		 * \param   edge_count      \f$|E|\f$.
+		 * \param   vertex_ids      Contents of section 1.
+		 * \param   offsets         Contents of section 2.
+		 * \param   targets         Contents of section 3.
+		 * \param   lengths         Contents of section 4.
+		 * \param   directions      Contents of section 5.
+		 */
+		static void         write           (std::ostream &out_stream, uint32_t const vertex_count, uint64_t const edge_count, uint32_t const *vertex_ids, uint64_t const *offsets, uint32_t const *targets, double const *lengths, uint64_t const *directions);
+
+		///@}
+	private:
+		MappedFile          file;
+		RWEGHeader          header;
+		uint64_t            section_offsets[6];
+
+		// Checks
+		void                checkHeader     (void);
+		void                checkSections   (void)                  const;
+
+		// Layout
+		static uint64_t const   hashBytes   (uint64_t hash, char const *bytes, uint64_t const byte_count, uint64_t const padded_count);
+	};
+
+
+
+
+
+} // rwe
+
+
+
+
+
+#endif // RWE__RWEG_HPP__
@@ -0,0 +1,552 @@
+/**
+ * \file
+ *       rwegz.cpp
+ *
+ * \author
+ *       Andrei Eliseev (JointPoints), 2021
+ */
+#include "rwegz.hpp"
+#include "../rweg/rweg.hpp"
+
+#include <stdexcept>    // needed for exceptions
+#include <algorithm>    // needed for "sort", "lower_bound", "all_of", "min", "max"
+#include <cstring>      // needed for "memcpy", "memcmp"
+#include <limits>       // needed for "numeric_limits"
+#include <vector>       // needed for "vector"
+#include <utility>      // needed for "pair"
+#include <thread>       // needed for "thread"
+#include <exception>    // needed for "exception_ptr", "current_exception", "rethrow_exception"
+
+
+
+
+
+namespace
+{
+	char const          rwegz_signature[8]          = {'\x89', 'R', 'W', 'G', 'Z', '\r', '\n', '\x1A'};
+	uint32_t const      rwegz_version               = 1;
+	uint32_t const      rwegz_byte_order            = 0x01020304;
+	uint32_t const      rwegz_swapped_byte_order    = 0x04030201;
+	uint64_t const      max_block_edge_count        = 1 << 16;
+	uint64_t const      max_block_vertex_count      = 1 << 16;
+
+	enum LengthCodings : uint32_t
+	{
+		DICTIONARY_CODING   = 0,
+		FLOAT_CODING        = 1,
+		DOUBLE_CODING       = 2
+	};
+
+	static_assert(sizeof(rwe::RWEGZHeader) == 64, "Header of rwegz files must occupy exactly 64 bytes.");
+	static_assert(sizeof(rwe::RWEGZBlock) == 48, "Records of the block index of rwegz files must occupy exactly 48 bytes.");
+	static_assert(std::numeric_limits<float>::is_iec559, "Lengths in rwegz files may be stored as IEEE 754 binary32 numbers.");
+	static_assert(std::numeric_limits<double>::is_iec559, "Lengths in rwegz files may be stored as IEEE 754 binary64 numbers.");
+
+	void inline putVarint(std::string &buffer, uint64_t value)
+	{
+		for (; value >= 0x80; value >>= 7)
+			buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+		buffer.push_back(static_cast<char>(value));
+	}
+
+	uint32_t inline getVarintSize(uint64_t value)
+	{
+		uint32_t size = 1;
+
+		for (; value >= 0x80; value >>= 7)
+			++size;
+		return size;
+	}
+
+	bool inline getVarint(char const *&position, char const *end, uint64_t &value)
+	{
+		uint64_t result = 0;
+
+		// Most numbers are single bytes, so they are taken right away
+		if ((position != end) && (static_cast<uint8_t>(*position) < 0x80))
+		{
+			value = static_cast<uint8_t>(*(position++));
+			return true;
+		}
+		for (uint32_t shift = 0; (position != end) && (shift < 64); shift += 7)
+		{
+			uint8_t const byte = static_cast<uint8_t>(*(position++));
+
+			result |= uint64_t(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+			{
+				value = result;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	uint64_t inline encodeZigzag(int64_t const value)
+	{
+		return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(-static_cast<int64_t>(value < 0));
+	}
+
+	int64_t inline decodeZigzag(uint64_t const value)
+	{
+		return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+	}
+}
+
+
+
+
+
+// Constructors and destructors
+
+
+
+
+
+rwe::RWEGZFile::RWEGZFile(void) :
+	file(), header()
+{
+	// Intended to be empty
+}
+
+
+
+rwe::RWEGZFile::RWEGZFile(std::string const file_name) :
+	RWEGZFile(MappedFile(file_name))
+{
+	// Intended to be empty
+}
+
+
+
+rwe::RWEGZFile::RWEGZFile(MappedFile &&file) :
+	file(std::move(file)), header()
+{
+	if (!this->file.isOpen())
+		return;
+	this->checkHeader();
+}
+
+
+
+
+
+// Access
+
+
+
+
+
+bool const rwe::RWEGZFile::isOpen(void) const
+{
+	return this->file.isOpen();
+}
+
+
+
+uint32_t const rwe::RWEGZFile::getVertexCount(void) const
+{
+	return this->header.vertex_count;
+}
+
+
+
+uint64_t const rwe::RWEGZFile::getEdgeCount(void) const
+{
+	return this->header.edge_count;
+}
+
+
+
+uint64_t const rwe::RWEGZFile::getBlockCount(void) const
+{
+	return this->header.block_count;
+}
+
+
+
+
+
+// Checks
+
+
+
+
+
+void rwe::RWEGZFile::checkHeader(void)
+{
+	RWEGZBlock const   *blocks          = nullptr;
+	double const       *dictionary      = nullptr;
+	uint64_t            directory_size  = 0;
+	uint64_t            next_vertex     = 0;
+	uint64_t            next_edge       = 0;
+	uint64_t            next_offset     = 0;
+
+	// 1. The header has to be present and carry the signature, the version and the byte order of this platform
+	if (this->file.getSize() < sizeof(RWEGZHeader))
+		throw std::runtime_error("The file is too short to be an rwegz file.");
+	std::memcpy(&this->header, this->file.getData(), sizeof(RWEGZHeader));
+	if (std::memcmp(this->header.signature, rwegz_signature, sizeof(rwegz_signature)) != 0)
+		throw std::runtime_error("The file is not an rwegz file.");
+	if (this->header.version != rwegz_version)
+		throw std::runtime_error("Version " + std::to_string(this->header.version) + " of rwegz format is not supported.");
+	if (this->header.byte_order == rwegz_swapped_byte_order)
+		throw std::runtime_error("The rwegz file was written on a platform with the opposite byte order.");
+	if ((this->header.byte_order != rwegz_byte_order) || (this->header.header_size != sizeof(RWEGZHeader)) || (this->header.length_coding > DOUBLE_CODING))
+		throw std::runtime_error("The header of the rwegz file is corrupted.");
+
+	// 2. The dictionary and the block index have to fit into the file, the latter bounds the counts and prevents overflows
+	if ((this->header.vertex_count > std::numeric_limits<uint32_t>::max()) || (this->header.dictionary_size > this->file.getSize() / sizeof(double)) || (this->header.block_count > this->file.getSize() / sizeof(RWEGZBlock)))
+		throw std::runtime_error("The header of the rwegz file is corrupted.");
+	if ((this->header.length_coding != DICTIONARY_CODING) && (this->header.dictionary_size != 0))
+		throw std::runtime_error("The header of the rwegz file is corrupted.");
+	directory_size = this->header.dictionary_size * sizeof(double) + this->header.block_count * sizeof(RWEGZBlock);
+	if (sizeof(RWEGZHeader) + directory_size > this->file.getSize())
+		throw std::runtime_error("The rwegz file is truncated.");
+	if (RWEGFile::computeChecksum(this->file.getData() + sizeof(RWEGZHeader), directory_size) != this->header.checksum)
+		throw std::runtime_error("The checksum of the rwegz file does not match its dictionary and block index.");
+
+	// 3. Lengths in the dictionary have to be positive finite numbers
+	dictionary = this->getDictionary();
+	for (uint64_t length_i = 0; length_i < this->header.dictionary_size; ++length_i)
+		if ((!(dictionary[length_i] > 0.0)) || (dictionary[length_i] == std::numeric_limits<double>::infinity()))
+			throw std::runtime_error("Lengths of edges of the rwegz file must be positive finite numbers.");
+
+	// 4. Blocks have to follow each other and cover all rows, edges and the rest of the file; every row and every edge
+	//    takes at least two bytes, which bounds the counts of each block
+	blocks = this->getBlocks();
+	next_offset = sizeof(RWEGZHeader) + directory_size;
+	for (uint64_t block_i = 0; block_i < this->header.block_count; ++block_i)
+	{
+		RWEGZBlock const &block = blocks[block_i];
+
+		if ((block.first_vertex != next_vertex) || (block.first_edge != next_edge) || (block.offset != next_offset) || (block.size > this->file.getSize() - next_offset) || (block.vertex_count > block.size / 2) || (block.edge_count > block.size / 2))
+			throw std::runtime_error("The block index of the rwegz file is corrupted.");
+		next_vertex += block.vertex_count;
+		next_edge += block.edge_count;
+		next_offset += block.size;
+	}
+	if ((next_vertex != this->header.vertex_count) || (next_edge != this->header.edge_count))
+		throw std::runtime_error("The block index of the rwegz file is corrupted.");
+	if (next_offset != this->file.getSize())
+		throw std::runtime_error("The rwegz file is truncated or has trailing data.");
+
+	return;
+}
+
+
+
+
+
+// Save/load
+
+
+
+
+
+void rwe::RWEGZFile::decode(uint32_t *vertex_ids, uint64_t *offsets, uint32_t *targets, double *lengths, uint64_t *directions, bool const validate) const
+{
+	uint32_t const                      vertex_count    = this->getVertexCount();
+	uint64_t const                      edge_count      = this->getEdgeCount();
+	uint64_t const                      block_count     = this->getBlockCount();
+	uint32_t const                      length_coding   = this->header.length_coding;
+	uint64_t const                      dictionary_size = this->header.dictionary_size;
+	double const                       *dictionary      = this->getDictionary();
+	RWEGZBlock const                   *blocks          = this->getBlocks();
+	char const                         *data            = this->file.getData();
+	uint32_t const                      thread_count    = std::max<uint64_t>(std::min<uint64_t>(std::thread::hardware_concurrency(), block_count), 1);
+	std::vector<std::vector<std::pair<uint64_t, uint64_t>>>     boundary_words(thread_count);
+	std::vector<std::exception_ptr>     errors(thread_count);
+	std::vector<std::thread>            threads;
+	auto const                          decode_blocks   = [=, &boundary_words, &errors](uint32_t const thread_i)
+	                                                      {
+	                                                          uint64_t const  first_block     = block_count * thread_i / thread_count;
+	                                                          uint64_t const  last_block      = block_count * (thread_i + 1) / thread_count;
+	                                                          uint64_t const  first_edge      = (first_block < block_count) ? (blocks[first_block].first_edge) : (edge_count);
+	                                                          uint64_t const  last_edge       = (last_block < block_count) ? (blocks[last_block].first_edge) : (edge_count);
+	                                                          uint64_t        word_i          = first_edge / 64;
+	                                                          uint64_t        word            = 0;
+	                                                          auto const      flush_word      = [&]()
+	                                                                                            {
+	                                                                                                if ((word_i * 64 >= first_edge) && (word_i * 64 + 64 <= last_edge))
+	                                                                                                    directions[word_i] = word;
+	                                                                                                else
+	                                                                                                    boundary_words[thread_i].emplace_back(word_i, word);
+	                                                                                            };
+
+	                                                          try
+	                                                          {
+	                                                              for (uint64_t block_i = first_block; block_i < last_block; ++block_i)
+	                                                              {
+	                                                                  RWEGZBlock const   &block           = blocks[block_i];
+	                                                                  char const         *position        = data + block.offset;
+	                                                                  char const         *block_end       = position + block.size;
+	                                                                  uint64_t const      last_vertex     = uint64_t(block.first_vertex) + block.vertex_count;
+	                                                                  uint64_t const      block_last_edge = block.first_edge + block.edge_count;
+	                                                                  uint64_t            edge            = block.first_edge;
+
+	                                                                  if (RWEGFile::computeChecksum(position, block.size) != block.checksum)
+	                                                                      throw std::runtime_error("The checksum of a block of the rwegz file does not match its contents.");
+	                                                                  for (uint64_t vertex_1 = block.first_vertex; vertex_1 < last_vertex; ++vertex_1)
+	                                                                  {
+	                                                                      uint64_t const  id_base     = (vertex_1 == block.first_vertex) ? (0) : (uint64_t(vertex_ids[vertex_1 - 1]) + 1);
+	                                                                      uint64_t        id          = 0;
+	                                                                      uint64_t        degree      = 0;
+
+	                                                                      if ((!getVarint(position, block_end, id)) || (!getVarint(position, block_end, degree)) || (degree > block_last_edge - edge))
+	                                                                          throw std::runtime_error("A block of the rwegz file is corrupted.");
+	                                                                      if ((id_base > std::numeric_limits<uint32_t>::max()) || (id > std::numeric_limits<uint32_t>::max() - id_base))
+	                                                                          throw std::runtime_error("IDs of vertices of the rwegz file are corrupted.");
+	                                                                      vertex_ids[vertex_1] = id_base + id;
+	                                                                      for (uint64_t const row_begin = edge, row_end = edge + degree; edge < row_end; ++edge)
+	                                                                      {
+	                                                                          uint64_t        key         = 0;
+	                                                                          uint64_t        length_i    = 0;
+	                                                                          int64_t         target      = 0;
+	                                                                          float           float_length(0.0f);
+
+	                                                                          // Targets are restored from the keys, the first edge of a row is relative to the row itself
+	                                                                          if (!getVarint(position, block_end, key))
+	                                                                              throw std::runtime_error("A block of the rwegz file is corrupted.");
+	                                                                          target = (edge == row_begin) ? (int64_t(vertex_1) + decodeZigzag(key >> 1)) : (int64_t(targets[edge - 1]) + int64_t(key >> 1) + 1);
+	                                                                          if ((target < 0) || (target >= vertex_count))
+	                                                                              throw std::runtime_error("Targets of edges of the rwegz file are corrupted.");
+	                                                                          targets[edge] = target;
+	                                                                          if (edge / 64 != word_i)
+	                                                                          {
+	                                                                              flush_word();
+	                                                                              word_i = edge / 64;
+	                                                                              word = 0;
+	                                                                          }
+	                                                                          word |= (key & 1) << (edge % 64);
+
+	                                                                          // Lengths follow the keys
+	                                                                          switch (length_coding)
+	                                                                          {
+	                                                                          case DICTIONARY_CODING:
+	                                                                              if ((!getVarint(position, block_end, length_i)) || (length_i >= dictionary_size))
+	                                                                                  throw std::runtime_error("A block of the rwegz file is corrupted.");
+	                                                                              lengths[edge] = dictionary[length_i];
+	                                                                              break;
+	                                                                          case FLOAT_CODING:
+	                                                                              if (block_end - position < static_cast<int64_t>(sizeof(float)))
+	                                                                                  throw std::runtime_error("A block of the rwegz file is corrupted.");
+	                                                                              std::memcpy(&float_length, position, sizeof(float));
+	                                                                              lengths[edge] = float_length;
+	                                                                              position += sizeof(float);
+	                                                                              break;
+	                                                                          default:
+	                                                                              if (block_end - position < static_cast<int64_t>(sizeof(double)))
+	                                                                                  throw std::runtime_error("A block of the rwegz file is corrupted.");
+	                                                                              std::memcpy(lengths + edge, position, sizeof(double));
+	                                                                              position += sizeof(double);
+	                                                                              break;
+	                                                                          }
+	                                                                      }
+	                                                                      offsets[vertex_1 + 1] = edge;
+	                                                                  }
+	                                                                  if ((position != block_end) || (edge != block_last_edge))
+	                                                                      throw std::runtime_error("A block of the rwegz file is corrupted.");
+	                                                              }
+	                                                              if (last_edge > first_edge)
+	                                                                  flush_word();
+	                                                          }
+	                                                          catch (...)
+	                                                          {
+	                                                              errors[thread_i] = std::current_exception();
+	                                                          }
+	                                                      };
+
+	// 1. Each run of blocks is decoded by its own thread
+	offsets[0] = 0;
+	for (uint32_t thread_i = 1; thread_i < thread_count; ++thread_i)
+		threads.emplace_back(decode_blocks, thread_i);
+	decode_blocks(0);
+	for (uint32_t thread_i = 0; thread_i < threads.size(); ++thread_i)
+		threads[thread_i].join();
+	for (uint32_t thread_i = 0; thread_i < thread_count; ++thread_i)
+		if (errors[thread_i])
+			std::rethrow_exception(errors[thread_i]);
+
+	// 2. Words of directions shared by neighbouring runs are only assembled now
+	for (uint32_t thread_i = 0; thread_i < thread_count; ++thread_i)
+		for (uint32_t word_i = 0; word_i < boundary_words[thread_i].size(); ++word_i)
+			directions[boundary_words[thread_i][word_i].first] = 0;
+	for (uint32_t thread_i = 0; thread_i < thread_count; ++thread_i)
+		for (uint32_t word_i = 0; word_i < boundary_words[thread_i].size(); ++word_i)
+			directions[boundary_words[thread_i][word_i].first] |= boundary_words[thread_i][word_i].second;
+
+	// 3. Checksums only guard against damage, the structure of the graph is checked separately
+	if (validate)
+		RWEGFile::checkStructure(vertex_count, edge_count, vertex_ids, offsets, targets, lengths, directions);
+
+	return;
+}
+
+
+
+bool const rwe::RWEGZFile::checkSignature(char const *data, uint64_t const size)
+{
+	return (data != nullptr) && (size >= sizeof(rwegz_signature)) && (std::memcmp(data, rwegz_signature, sizeof(rwegz_signature)) == 0);
+}
+
+
+
+void rwe::RWEGZFile::write(std::ostream &out_stream, uint32_t const vertex_count, uint64_t const edge_count, uint32_t const *vertex_ids, uint64_t const *offsets, uint32_t const *targets, double const *lengths, uint64_t const *directions)
+{
+	std::vector<double>                 sorted_lengths;
+	std::vector<double>                 distinct_lengths;
+	std::vector<std::pair<uint64_t, uint64_t>>  frequencies;
+	std::vector<uint64_t>               length_indices;
+	std::vector<double>                 dictionary;
+	uint64_t                            dictionary_bytes    = 0;
+	bool const                          is_float_exact      = std::all_of(lengths, lengths + edge_count, [](double const length) {return static_cast<double>(static_cast<float>(length)) == length;});
+	std::vector<RWEGZBlock>             blocks;
+	std::vector<std::string>            block_data;
+	std::string                         directory;
+	RWEGZHeader                         header              = {};
+	uint32_t                            thread_count        = 1;
+	std::vector<std::exception_ptr>     errors;
+	std::vector<std::thread>            threads;
+	auto const                          encode_blocks       = [&](uint32_t const thread_i)
+	                                                          {
+	                                                              uint64_t const  first_block = blocks.size() * thread_i / thread_count;
+	                                                              uint64_t const  last_block  = blocks.size() * (thread_i + 1) / thread_count;
+
+	                                                              try
+	                                                              {
+	                                                                  for (uint64_t block_i = first_block; block_i < last_block; ++block_i)
+	                                                                  {
+	                                                                      RWEGZBlock     &block       = blocks[block_i];
+	                                                                      std::string    &buffer      = block_data[block_i];
+	                                                                      uint64_t const  last_vertex = uint64_t(block.first_vertex) + block.vertex_count;
+
+	                                                                      buffer.reserve(2 * block.vertex_count + 6 * block.edge_count);
+	                                                                      for (uint64_t vertex_1 = block.first_vertex; vertex_1 < last_vertex; ++vertex_1)
+	                                                                      {
+	                                                                          putVarint(buffer, (vertex_1 == block.first_vertex) ? (vertex_ids[vertex_1]) : (vertex_ids[vertex_1] - vertex_ids[vertex_1 - 1] - 1));
+	                                                                          putVarint(buffer, offsets[vertex_1 + 1] - offsets[vertex_1]);
+	                                                                          for (uint64_t edge = offsets[vertex_1]; edge < offsets[vertex_1 + 1]; ++edge)
+	                                                                          {
+	                                                                              uint64_t const  key             = (edge == offsets[vertex_1]) ? (encodeZigzag(int64_t(targets[edge]) - int64_t(vertex_1))) : (targets[edge] - targets[edge - 1] - 1);
+	                                                                              float const     float_length    = static_cast<float>(lengths[edge]);
+
+	                                                                              putVarint(buffer, (key << 1) | ((directions[edge / 64] >> (edge % 64)) & 1));
+	                                                                              if (header.length_coding == DICTIONARY_CODING)
+	                                                                                  putVarint(buffer, length_indices[std::lower_bound(distinct_lengths.begin(), distinct_lengths.end(), lengths[edge]) - distinct_lengths.begin()]);
+	                                                                              else if (header.length_coding == FLOAT_CODING)
+	                                                                                  buffer.append(reinterpret_cast<char const *>(&float_length), sizeof(float));
+	                                                                              else
+	                                                                                  buffer.append(reinterpret_cast<char const *>(lengths + edge), sizeof(double));
+	                                                                          }
+	                                                                      }
+	                                                                      block.size = buffer.size();
+	                                                                      block.checksum = RWEGFile::computeChecksum(buffer.data(), buffer.size());
+	                                                                  }
+	                                                              }
+	                                                              catch (...)
+	                                                              {
+	                                                                  errors[thread_i] = std::current_exception();
+	                                                              }
+	                                                          };
+
+	// 1. Distinct lengths are indexed in the descending order of their frequencies, so that frequent lengths get short indices
+	sorted_lengths.assign(lengths, lengths + edge_count);
+	std::sort(sorted_lengths.begin(), sorted_lengths.end());
+	for (uint64_t edge = 0; edge < edge_count; ++edge)
+	{
+		if ((edge == 0) || (sorted_lengths[edge] != sorted_lengths[edge - 1]))
+		{
+			frequencies.emplace_back(0, distinct_lengths.size());
+			distinct_lengths.push_back(sorted_lengths[edge]);
+		}
+		++frequencies.back().first;
+	}
+	sorted_lengths = std::vector<double>();
+	std::sort(frequencies.begin(), frequencies.end(), [](std::pair<uint64_t, uint64_t> const &a, std::pair<uint64_t, uint64_t> const &b) {return (a.first > b.first) || ((a.first == b.first) && (a.second < b.second));});
+	length_indices.resize(distinct_lengths.size());
+	dictionary_bytes = distinct_lengths.size() * sizeof(double);
+	for (uint64_t length_i = 0; length_i < frequencies.size(); ++length_i)
+	{
+		length_indices[frequencies[length_i].second] = length_i;
+		dictionary_bytes += frequencies[length_i].first * getVarintSize(length_i);
+	}
+
+	// 2. The coding which takes the least space is chosen
+	header.length_coding = DOUBLE_CODING;
+	if (is_float_exact)
+		header.length_coding = FLOAT_CODING;
+	if (dictionary_bytes < edge_count * ((header.length_coding == FLOAT_CODING) ? (sizeof(float)) : (sizeof(double))))
+	{
+		header.length_coding = DICTIONARY_CODING;
+		for (uint64_t length_i = 0; length_i < frequencies.size(); ++length_i)
+			dictionary.push_back(distinct_lengths[frequencies[length_i].second]);
+	}
+
+	// 3. Rows are grouped into blocks
+	for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+	{
+		if ((blocks.empty()) || (blocks.back().edge_count >= max_block_edge_count) || (blocks.back().vertex_count >= max_block_vertex_count))
+			blocks.push_back({vertex_1, 0, offsets[vertex_1], 0, 0, 0, 0});
+		++blocks.back().vertex_count;
+		blocks.back().edge_count += offsets[vertex_1 + 1] - offsets[vertex_1];
+	}
+
+	// 4. Runs of blocks are encoded by separate threads
+	block_data.resize(blocks.size());
+	thread_count = std::max<uint64_t>(std::min<uint64_t>(std::thread::hardware_concurrency(), blocks.size()), 1);
+	errors.resize(thread_count);
+	for (uint32_t thread_i = 1; thread_i < thread_count; ++thread_i)
+		threads.emplace_back(encode_blocks, thread_i);
+	encode_blocks(0);
+	for (uint32_t thread_i = 0; thread_i < threads.size(); ++thread_i)
+		threads[thread_i].join();
+	for (uint32_t thread_i = 0; thread_i < thread_count; ++thread_i)
+		if (errors[thread_i])
+			std::rethrow_exception(errors[thread_i]);
+
+	// 5. Blocks are placed right after the dictionary and the index
+	for (uint64_t block_i = 0, offset = sizeof(RWEGZHeader) + dictionary.size() * sizeof(double) + blocks.size() * sizeof(RWEGZBlock); block_i < blocks.size(); offset += blocks[block_i++].size)
+		blocks[block_i].offset = offset;
+	directory.append(reinterpret_cast<char const *>(dictionary.data()), dictionary.size() * sizeof(double));
+	directory.append(reinterpret_cast<char const *>(blocks.data()), blocks.size() * sizeof(RWEGZBlock));
+
+	// 6. Fill the header and write everything
+	std::memcpy(header.signature, rwegz_signature, sizeof(rwegz_signature));
+	header.version = rwegz_version;
+	header.byte_order = rwegz_byte_order;
+	header.header_size = sizeof(RWEGZHeader);
+	header.vertex_count = vertex_count;
+	header.edge_count = edge_count;
+	header.dictionary_size = dictionary.size();
+	header.block_count = blocks.size();
+	header.checksum = RWEGFile::computeChecksum(directory.data(), directory.size());
+	out_stream.write(reinterpret_cast<char const *>(&header), sizeof(RWEGZHeader));
+	out_stream.write(directory.data(), directory.size());
+	for (uint64_t block_i = 0; block_i < blocks.size(); ++block_i)
+		out_stream.write(block_data[block_i].data(), block_data[block_i].size());
+
+	return;
+}
+
+
+
+
+
+// Layout
+
+
+
+
+
+double const * rwe::RWEGZFile::getDictionary(void) const
+{
+	return reinterpret_cast<double const *>(this->file.getData() + sizeof(RWEGZHeader));
+}
+
+
+
+rwe::RWEGZBlock const * rwe::RWEGZFile::getBlocks(void) const
+{
+	return reinterpret_cast<RWEGZBlock const *>(this->file.getData() + sizeof(RWEGZHeader) + this->header.dictionary_size * sizeof(double));
+}
@@ -0,0 +1,259 @@
+/**
+ * \file
+ *       rwegz.hpp
+ *
+ * \author
+ *       Andrei Eliseev (JointPoints), 2021
+ */
+#ifndef RWE__RWEGZ_HPP__
+#define RWE__RWEGZ_HPP__
+
+
+
+
+
+#include "../mapped_file/mapped_file.hpp"       // needed for "MappedFile"
+#include <string>                               // needed for "string"
+#include <iostream>                             // needed for "ostream"
+#include <cstdint>                              // needed for "int*_t" and "uint*_t" types
+
+
+
+
+
+namespace rwe
+{
+
+
+
+
+
+	/**
+	 * \brief Header of an \c rwegz file
+	 *
+	 * * \c signature : bytes <tt>89 52 57 47 5A 0D 0A 1A</tt> (<tt>\\x89RWGZ\\r\\n\\x1A</tt>);
+	 * * \c version : version of the format, 1;
+	 * * \c byte_order : number \c 0x01020304 in the byte order of the platform which wrote the
+	 * file;
+	 * * \c header_size : size of the header in bytes, 64;
+	 * * \c length_coding : how lengths are stored, 0 for the dictionary, 1 for IEEE 754
+	 * binary32 numbers, 2 for IEEE 754 binary64 numbers;
+	 * * \c vertex_count and \c edge_count : \f$|V|\f$ and \f$|E|\f$;
+	 * * \c dictionary_size : number of lengths in the dictionary, 0 unless \c length_coding is 0;
+	 * * \c block_count : number of blocks;
+	 * * \c checksum : checksum of the dictionary and the block index (see RWEGZFile).
+	 */
+	using RWEGZHeader       = struct RWEGZHeaderStruct {char signature[8]; uint32_t version; uint32_t byte_order; uint32_t header_size; uint32_t length_coding; uint64_t vertex_count; uint64_t edge_count; uint64_t dictionary_size; uint64_t block_count; uint64_t checksum;};
+
+	/**
+	 * \brief Record of the block index of an \c rwegz file
+	 *
+	 * * \c first_vertex and \c vertex_count : dense indices of the rows stored in the block;
+	 * * \c first_edge and \c edge_count : positions of the edges stored in the block;
+	 * * \c offset and \c size : position of the block in the file and its size in bytes;
+	 * * \c checksum : checksum of the block.
+	 */
+	using RWEGZBlock        = struct RWEGZBlockStruct {uint32_t first_vertex; uint32_t vertex_count; uint64_t first_edge; uint64_t edge_count; uint64_t offset; uint64_t size; uint64_t checksum;};
+
+
+
+
+
+	/**
+	 * \class RWEGZFile
+	 * \brief A read-only view of an \c rwegz file
+	 *
+	 * The \c rwegz format is a compressed counterpart of version 2 of the \c rweg format (see
+	 * RWEGFile) meant for archiving graphs and loading them over slow storage. It stores the
+	 * same five sections, but encodes them row by row. A file consists of the 64-byte header
+	 * (see rwe::RWEGZHeader) followed by
+	 *
+	 * 1. the dictionary, \c dictionary_size IEEE 754 binary64 numbers;
+	 * 2. the block index, \c block_count records (see rwe::RWEGZBlock);
+	 * 3. the blocks themselves, one after another.
+	 *
+	 * Each block holds a run of whole rows with about \f$2^{16}\f$ edges in total. Every row is
+	 * written as a sequence of unsigned LEB128 numbers (<b>varints</b>):
+	 *
+	 * * the ID of the vertex, minus the ID of the previous vertex of the block plus one (the first
+	 * vertex of a block is written as is);
+	 * * the number of edges in the row;
+	 * * for each edge, \f$2k + d\f$, where \f$d\f$ is 1 iff the edge is directed, and \f$k\f$ is
+	 * the difference between its target and the target of the previous edge of the row minus
+	 * one, or, for the first edge of the row, the difference between its target and the row
+	 * itself mapped to an unsigned number by zigzag coding (\f$0,-1,1,-2,...\f$ become
+	 * \f$0,1,2,3,...\f$); the key is followed by the length of the edge, which is either a
+	 * varint index in the dictionary or a raw binary32 or binary64 number.
+	 *
+	 * The writer chooses the coding of lengths which takes the least space: graphs with a few
+	 * distinct lengths get the dictionary sorted by frequency, graphs with lengths which are
+	 * exactly representable as \c float get 4 bytes per length. The dictionary, the index and
+	 * each block carry their own checksum, which is the same 64-bit FNV-1a hash as the one of
+	 * RWEGFile. All fixed-size numbers are written in the byte order of the platform; files
+	 * written with the opposite byte order are rejected.
+	 *
+	 * The view maps the file into memory (see MappedFile) and checks the header, the
+	 * dictionary and the index; blocks are only read by \ref decode.
+	 */
+	class RWEGZFile
+	{
+
+
+
+	public:
+
+
+
+		/// \name Constructors and destructors
+		///@{
+
+		/**
+		 * Default constructor
+		 *
+		 * Constructs a view which is not associated with any file.
+		 */
+		RWEGZFile                   (void);
+
+		/**
+		 * Opening constructor
+		 *
+		 * Maps the specified file into memory and checks its header, dictionary and block index.
+		 * If the file does not exist, the view is left closed (see \ref isOpen).
+		 *
+		 * \param   file_name   Name of an \c rwegz file.
+		 *
+		 * \throw runtime_error if the file is not a valid \c rwegz file.
+		 */
+		explicit RWEGZFile          (std::string const file_name);
+
+		/**
+		 * Adopting constructor
+		 *
+		 * Takes over an existing mapping of a file and checks its header, dictionary and block
+		 * index.
+		 *
+		 * \param   file        Mapping of an \c rwegz file; it is left closed.
+		 *
+		 * \throw runtime_error if the file is not a valid \c rwegz file.
+		 */
+		explicit RWEGZFile          (MappedFile &&file);
+
+		// Prevent implicit creation of copy-constructor and the copy assignment operator
+		RWEGZFile                   (RWEGZFile &)       = delete;
+		RWEGZFile &     operator =  (RWEGZFile &)       = delete;
+
+		///@}
+
+
+
+		/// \name Accessors
+		///@{
+
+		/**
+		 * Check if a file is open
+		 *
+		 * \return \c true, if a file is open, \c false otherwise.
+		 */
+		bool const          isOpen          (void)                  const;
+
+		/**
+		 * Get the number of vertices
+		 *
+		 * \return \f$|V|\f$.
+		 */
+		uint32_t const      getVertexCount  (void)                  const;
+
+		/**
+		 * Get the number of edges
+		 *
+		 * \return \f$|E|\f$.
+		 */
+		uint64_t const      getEdgeCount    (void)                  const;
+
+		/**
+		 * Get the number of blocks
+		 *
+		 * \return Number of blocks.
+		 */
+		uint64_t const      getBlockCount   (void)                  const;
+
+		///@}
+
+
+
+		/// \name Save/load
+		///@{
+
+		/**
+		 * Decode the graph
+		 *
+		 * Decodes all blocks into the sections of version 2 of the \c rweg format (see RWEGFile).
+		 * Blocks are split into contiguous runs which are decoded on all hardware threads right
+		 * into the specified arrays, and the checksum of each block is verified right before it
+		 * is decoded.
+		 *
+		 * \param   vertex_ids      Section 1, \f$|V|\f$ elements.
+		 * \param   offsets         Section 2, \f$|V|+1\f$ elements.
+		 * \param   targets         Section 3, \f$|E|\f$ elements.
+		 * \param   lengths         Section 4, \f$|E|\f$ elements.
+		 * \param   directions      Section 5, \f$\lceil |E| / 64 \rceil\f$ elements.
+		 * \param   validate        If \c true, the decoded sections are checked by
+		 *                          RWEGFile::checkStructure as well.
+		 *
+		 * \throw runtime_error if a block is corrupted.
+		 */
+		void                decode          (uint32_t *vertex_ids, uint64_t *offsets, uint32_t *targets, double *lengths, uint64_t *directions, bool const validate = true) const;
+
+		/**
+		 * Check the signature
+		 *
+		 * \param   data    Pointer to the beginning of a file.
+		 * \param   size    Size of the file in bytes.
+		 *
+		 * \return \c true, if the file begins with the signature of \c rwegz files (see
+		 * rwe::RWEGZHeader), \c false otherwise.
+		 */
+		static bool const   checkSignature  (char const *data, uint64_t const size);
+
+		/**
+		 * Write an \c rwegz file
+		 *
+		 * Encodes the sections of version 2 of the \c rweg format (see RWEGFile) and writes them
+		 * to the specified stream. The arrays must satisfy all requirements of that format.
+		 * Blocks are encoded on all hardware threads.
+		 *
+		 * \param   out_stream      A binary stream to write to.
+		 * \param   vertex_count    \f$|V|\f$.
+		 * \param   edge_count      \f$|E|\f$.
+		 * \param   vertex_ids      Section 1.
+		 * \param   offsets         Section 2.
+		 * \param   targets         Section 3.
+		 * \param   lengths         Section 4.
+		 * \param   directions      Section 5.
+		 */
+		static void         write           (std::ostream &out_stream, uint32_t const vertex_count, uint64_t const edge_count, uint32_t const *vertex_ids, uint64_t const *offsets, uint32_t const *targets, double const *lengths, uint64_t const *directions);
+
+		///@}
+	private:
+		MappedFile          file;
+		RWEGZHeader         header;
+
+		// Checks
+		void                checkHeader     (void);
+
+		// Layout
+		double const *      getDictionary   (void)                  const;
+		RWEGZBlock const *  getBlocks       (void)                  const;
+	};
+
+
+
+
+
+} // rwe
+
+
+
+
+
+#endif // RWE__RWEGZ_HPP__
@@ -0,0 +1,363 @@
+/**
+ * \file
+ *       symmetry.cpp
+ *
+ * \author
+ *       Andrei Eliseev (JointPoints), 2021
+ */
+#include "symmetry.hpp"
+
+#include <algorithm>    // needed for "lower_bound", "binary_search", "sort", "unique", "lexicographical_compare", "max"
+#include <numeric>      // needed for "iota"
+#include <tuple>        // needed for "tuple"
+
+
+
+
+
+// Constructors and destructors
+
+
+
+
+
+template <typename Real>
+rwe::VertexOrbits<Real>::VertexOrbits(void) :
+	vertex_ids(), representatives(), orbit_count(0)
+{
+	// Intended to be empty
+}
+
+
+
+template <typename Real>
+rwe::VertexOrbits<Real>::VertexOrbits(MetricGraph<Real> const &graph, std::vector<uint32_t> const &vertices, uint64_t const search_budget) :
+	vertex_ids(graph.getVertexList()), representatives(), orbit_count(0)
+{
+	uint32_t const                                      vertex_count        = this->vertex_ids.size();
+	auto const                                          dense_index         = [this](uint32_t const vertex){return std::distance(this->vertex_ids.begin(), std::lower_bound(this->vertex_ids.begin(), this->vertex_ids.end(), vertex));};
+	std::vector<std::tuple<uint32_t, Real, uint32_t>>   raw_arcs;
+	std::vector<Real>                                   lengths;
+	std::vector<uint64_t>                               arc_offsets(vertex_count + 1, 0);
+	std::vector<Arc>                                    arcs;
+	Colouring                                           colours(2 * vertex_count, 0);
+	uint32_t                                            colour_count        = 0;
+	std::vector<uint32_t>                               parents(vertex_count);
+	std::vector<uint32_t>                               candidates;
+	std::vector<std::vector<uint32_t>>                  cell_representatives;
+	std::vector<uint32_t>                               permutation(vertex_count);
+	auto const                                          find_root           = [&parents](uint32_t vertex)
+	                                                                          {
+	                                                                              while (parents[vertex] != vertex)
+	                                                                                  vertex = parents[vertex] = parents[parents[vertex]];
+	                                                                              return vertex;
+	                                                                          };
+
+	// 1. Describe each vertex with the list of its arcs: outgoing (0), incoming (1) and undirected (2)
+	//    edges together with their lengths and opposite end points
+	for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+	{
+		uint32_t const              vertex              = this->vertex_ids[vertex_1];
+		std::vector<uint32_t> const out_neighbours      = graph.getOutNeighbours(vertex);
+		std::vector<uint32_t> const in_neighbours       = graph.getInNeighbours(vertex);
+		std::vector<uint32_t> const undirected          = graph.getUndirectedNeighbours(vertex);
+
+		for (uint32_t neighbour_i = 0; neighbour_i < out_neighbours.size(); ++neighbour_i)
+		{
+			bool const is_undirected = std::binary_search(undirected.begin(), undirected.end(), out_neighbours[neighbour_i]);
+			raw_arcs.emplace_back((is_undirected) ? (2) : (0), graph.getEdgeLength(vertex, out_neighbours[neighbour_i]), dense_index(out_neighbours[neighbour_i]));
+		}
+		for (uint32_t neighbour_i = 0; neighbour_i < in_neighbours.size(); ++neighbour_i)
+			if (!std::binary_search(undirected.begin(), undirected.end(), in_neighbours[neighbour_i]))
+				raw_arcs.emplace_back(1, graph.getEdgeLength(in_neighbours[neighbour_i], vertex), dense_index(in_neighbours[neighbour_i]));
+		arc_offsets[vertex_1 + 1] = raw_arcs.size();
+	}
+
+	// 2. Replace lengths with their ranks, so that each arc is labelled with a single integer
+	for (uint64_t arc_i = 0; arc_i < raw_arcs.size(); ++arc_i)
+		lengths.push_back(std::get<1>(raw_arcs[arc_i]));
+	std::sort(lengths.begin(), lengths.end());
+	lengths.erase(std::unique(lengths.begin(), lengths.end()), lengths.end());
+	arcs.reserve(raw_arcs.size());
+	for (uint64_t arc_i = 0; arc_i < raw_arcs.size(); ++arc_i)
+	{
+		uint64_t const length_rank = std::distance(lengths.begin(), std::lower_bound(lengths.begin(), lengths.end(), std::get<1>(raw_arcs[arc_i])));
+		arcs.emplace_back(3 * length_rank + std::get<0>(raw_arcs[arc_i]), std::get<2>(raw_arcs[arc_i]));
+	}
+	raw_arcs.clear();
+	raw_arcs.shrink_to_fit();
+
+	// 3. Split vertices into cells; both copies of the graph used by the search get the same colours
+	colour_count = VertexOrbits<Real>::refine(arc_offsets, arcs, colours);
+	cell_representatives.resize(colour_count);
+
+	// 4. Try to map each candidate onto the representatives of the orbits found so far in its cell
+	std::iota(parents.begin(), parents.end(), 0);
+	for (uint32_t vertex_i = 0; vertex_i < vertices.size(); ++vertex_i)
+		if (graph.checkVertex(vertices[vertex_i]))
+			candidates.push_back(dense_index(vertices[vertex_i]));
+	if (vertices.empty())
+	{
+		candidates.resize(vertex_count);
+		std::iota(candidates.begin(), candidates.end(), 0);
+	}
+	std::sort(candidates.begin(), candidates.end());
+	candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+	for (uint32_t candidate_i = 0; candidate_i < candidates.size(); ++candidate_i)
+	{
+		uint32_t const          vertex_1        = candidates[candidate_i];
+		std::vector<uint32_t>  &cell            = cell_representatives[colours[vertex_1]];
+		bool                    is_mapped       = false;
+
+		for (uint32_t cell_i = 0; (cell_i < cell.size()) && (!is_mapped); ++cell_i)
+		{
+			uint32_t const  vertex_2    = cell[cell_i];
+			Colouring       individual  = colours;
+			uint64_t        budget      = search_budget;
+
+			// 4.1. Some automorphism found earlier may have already mapped these vertices
+			if (find_root(vertex_1) == find_root(vertex_2))
+			{
+				is_mapped = true;
+				break;
+			}
+
+			// 4.2. Search for an automorphism which maps <vertex_2> onto <vertex_1>, merge all its orbits
+			individual[vertex_2] = individual[vertex_count + vertex_1] = colour_count;
+			if (VertexOrbits<Real>::search(arc_offsets, arcs, individual, budget, permutation))
+			{
+				for (uint32_t vertex_3 = 0; vertex_3 < vertex_count; ++vertex_3)
+					parents[find_root(vertex_3)] = find_root(permutation[vertex_3]);
+				is_mapped = true;
+			}
+		}
+		if (!is_mapped)
+			cell.push_back(vertex_1);
+	}
+
+	// 5. Each orbit is represented by its lowest ID, dense indices follow the order of IDs
+	this->representatives.assign(vertex_count, vertex_count);
+	for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+	{
+		uint32_t const root = find_root(vertex_1);
+
+		if (this->representatives[root] == vertex_count)
+		{
+			this->representatives[root] = vertex_1;
+			++this->orbit_count;
+		}
+		this->representatives[vertex_1] = this->representatives[root];
+	}
+}
+
+
+
+
+
+// Access
+
+
+
+
+
+template <typename Real>
+uint32_t const rwe::VertexOrbits<Real>::getOrbitCount(void) const
+{
+	return this->orbit_count;
+}
+
+
+
+template <typename Real>
+uint32_t const rwe::VertexOrbits<Real>::getRepresentative(uint32_t const vertex) const
+{
+	auto vertex_lower_bound = std::lower_bound(this->vertex_ids.begin(), this->vertex_ids.end(), vertex);
+
+	if ((vertex_lower_bound != this->vertex_ids.end()) && (*vertex_lower_bound == vertex))
+		return this->vertex_ids[this->representatives[std::distance(this->vertex_ids.begin(), vertex_lower_bound)]];
+
+	return vertex;
+}
+
+
+
+template <typename Real>
+std::vector<uint32_t> const rwe::VertexOrbits<Real>::getOrbit(uint32_t const vertex) const
+{
+	auto                    vertex_lower_bound  = std::lower_bound(this->vertex_ids.begin(), this->vertex_ids.end(), vertex);
+	std::vector<uint32_t>   answer;
+
+	if ((vertex_lower_bound == this->vertex_ids.end()) || (*vertex_lower_bound != vertex))
+		return answer;
+
+	uint32_t const representative = this->representatives[std::distance(this->vertex_ids.begin(), vertex_lower_bound)];
+
+	for (uint32_t vertex_1 = representative; vertex_1 < this->vertex_ids.size(); ++vertex_1)
+		if (this->representatives[vertex_1] == representative)
+			answer.push_back(this->vertex_ids[vertex_1]);
+
+	return answer;
+}
+
+
+
+
+
+// Search
+
+
+
+
+
+template <typename Real>
+uint32_t const rwe::VertexOrbits<Real>::refine(std::vector<uint64_t> const &arc_offsets, std::vector<Arc> const &arcs, Colouring &colours)
+{
+	uint32_t const          vertex_count    = arc_offsets.size() - 1;
+	uint32_t                colour_count    = 0;
+	std::vector<Arc>        signatures(2 * arcs.size());
+	std::vector<uint32_t>   order(colours.size());
+
+	// Vertex <x> of the second copy of the graph is stored at <x + vertex_count>
+	auto const signature_begin  = [&](uint32_t const node){return signatures.begin() + ((node < vertex_count) ? (arc_offsets[node]) : (arcs.size() + arc_offsets[node - vertex_count]));};
+	auto const signature_end    = [&](uint32_t const node){return signatures.begin() + ((node < vertex_count) ? (arc_offsets[node + 1]) : (arcs.size() + arc_offsets[node - vertex_count + 1]));};
+	auto const signature_less   = [&](uint32_t const node_1, uint32_t const node_2)
+	                              {
+	                                  if (colours[node_1] != colours[node_2])
+	                                      return colours[node_1] < colours[node_2];
+	                                  return std::lexicographical_compare(signature_begin(node_1), signature_end(node_1), signature_begin(node_2), signature_end(node_2));
+	                              };
+
+	for (uint32_t node_i = 0; node_i < colours.size(); ++node_i)
+		colour_count = std::max(colour_count, colours[node_i] + 1);
+
+	// 1. Each round splits vertices of the same colour whose arcs lead to different colours, until nothing changes
+	while (true)
+	{
+		uint32_t new_colour_count = 0;
+
+		// 1.1. Signature of a vertex is the sorted list of labels of its arcs paired with colours of their targets
+		for (uint32_t node_i = 0; node_i < colours.size(); ++node_i)
+		{
+			uint32_t const  base        = node_i % vertex_count;
+			uint32_t const  shift       = node_i - base;
+			auto            signature   = signature_begin(node_i);
+
+			for (uint64_t arc_i = arc_offsets[base]; arc_i < arc_offsets[base + 1]; ++arc_i)
+				*(signature++) = Arc(arcs[arc_i].first, colours[shift + arcs[arc_i].second]);
+			std::sort(signature_begin(node_i), signature_end(node_i));
+		}
+
+		// 1.2. Renumber colours in the order of signatures, so that both copies are renumbered consistently
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), signature_less);
+		{
+			Colouring new_colours(colours.size());
+
+			for (uint32_t order_i = 0; order_i < order.size(); ++order_i)
+			{
+				if ((order_i > 0) && (signature_less(order[order_i - 1], order[order_i])))
+					++new_colour_count;
+				new_colours[order[order_i]] = new_colour_count;
+			}
+			colours = std::move(new_colours);
+		}
+		if (++new_colour_count == colour_count)
+			break;
+		colour_count = new_colour_count;
+	}
+
+	return colour_count;
+}
+
+
+
+template <typename Real>
+bool const rwe::VertexOrbits<Real>::search(std::vector<uint64_t> const &arc_offsets, std::vector<Arc> const &arcs, Colouring colours, uint64_t &budget, std::vector<uint32_t> &permutation)
+{
+	uint32_t const          vertex_count    = arc_offsets.size() - 1;
+	std::vector<int64_t>    balances;
+	std::vector<uint32_t>   cell_sizes;
+	uint32_t                colour_count    = 0;
+	uint32_t                branch_colour   = 0;
+
+	// 1. Each branch costs one unit of the budget
+	if (budget == 0)
+		return false;
+	--budget;
+
+	// 2. Each colour must be shared by equally many vertices of both copies
+	colour_count = VertexOrbits<Real>::refine(arc_offsets, arcs, colours);
+	balances.assign(colour_count, 0);
+	cell_sizes.assign(colour_count, 0);
+	for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+	{
+		++balances[colours[vertex_1]];
+		--balances[colours[vertex_count + vertex_1]];
+		++cell_sizes[colours[vertex_1]];
+	}
+	for (uint32_t colour = 0; colour < colour_count; ++colour)
+		if (balances[colour] != 0)
+			return false;
+
+	// 3. Once all colours are unique, the colouring defines a permutation which has to be verified
+	for (uint32_t colour = 0; colour < colour_count; ++colour)
+		if ((cell_sizes[colour] > 1) && ((cell_sizes[branch_colour] <= 1) || (cell_sizes[colour] < cell_sizes[branch_colour])))
+			branch_colour = colour;
+	if ((colour_count == 0) || (cell_sizes[branch_colour] <= 1))
+	{
+		std::vector<uint32_t>   owners(colour_count);
+		std::vector<Arc>        mapped_arcs;
+		std::vector<Arc>        target_arcs;
+
+		for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+			owners[colours[vertex_count + vertex_1]] = vertex_1;
+		for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+			permutation[vertex_1] = owners[colours[vertex_1]];
+		for (uint32_t vertex_1 = 0; vertex_1 < vertex_count; ++vertex_1)
+		{
+			mapped_arcs.clear();
+			target_arcs.clear();
+			for (uint64_t arc_i = arc_offsets[vertex_1]; arc_i < arc_offsets[vertex_1 + 1]; ++arc_i)
+				mapped_arcs.emplace_back(arcs[arc_i].first, permutation[arcs[arc_i].second]);
+			for (uint64_t arc_i = arc_offsets[permutation[vertex_1]]; arc_i < arc_offsets[permutation[vertex_1] + 1]; ++arc_i)
+				target_arcs.push_back(arcs[arc_i]);
+			std::sort(mapped_arcs.begin(), mapped_arcs.end());
+			std::sort(target_arcs.begin(), target_arcs.end());
+			if (mapped_arcs != target_arcs)
+				return false;
+		}
+		return true;
+	}
+
+	// 4. Otherwise, individualise a vertex of the smallest ambiguous cell in the first copy and try to
+	//    map it onto each vertex of the same cell in the second copy
+	uint32_t vertex_1 = 0;
+
+	while (colours[vertex_1] != branch_colour)
+		++vertex_1;
+	for (uint32_t vertex_2 = 0; (vertex_2 < vertex_count) && (budget > 0); ++vertex_2)
+		if (colours[vertex_count + vertex_2] == branch_colour)
+		{
+			Colouring individual = colours;
+
+			individual[vertex_1] = individual[vertex_count + vertex_2] = colour_count;
+			if (VertexOrbits<Real>::search(arc_offsets, arcs, individual, budget, permutation))
+				return true;
+		}
+
+	return false;
+}
+
+
+
+
+
+// Explicit instantiations
+
+
+
+
+
+template class rwe::VertexOrbits<float>;
+template class rwe::VertexOrbits<double>;
+template class rwe::VertexOrbits<long double>;
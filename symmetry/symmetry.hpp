@@ -0,0 +1,149 @@
+/**
+ * \file
+ *       symmetry.hpp
+ *
+ * \author
+ *       Andrei Eliseev (JointPoints), 2021
+ */
+#ifndef RWE__SYMMETRY_HPP__
+#define RWE__SYMMETRY_HPP__
+
+
+
+
+
+#include "../metric_graph/metric_graph.hpp"     // needed for "MetricGraph"
+#include <vector>                               // needed for "vector"
+#include <cstdint>                              // needed for "int*_t" and "uint*_t" types
+#include <utility>                              // needed for "pair"
+
+
+
+
+
+namespace rwe
+{
+
+
+
+
+
+	/**
+	 * \class VertexOrbits
+	 * \brief Orbits of vertices of a metric graph under its automorphisms
+	 *
+	 * An <b>automorphism</b> of a metric graph is a permutation \f$\sigma\f$ of its vertices
+	 * which maps each edge onto an edge of the same length and type, i.e., \f$v \rightarrow w\f$
+	 * onto \f$\sigma(v) \rightarrow \sigma(w)\f$ and \f$v-w\f$ onto \f$\sigma(v)-\sigma(w)\f$.
+	 * Two vertices lie in the same <b>orbit</b> if some automorphism maps one onto the other.
+	 * Random walks started at vertices of the same orbit are mirror images of each other, so
+	 * all their characteristics (e.g., saturation times) coincide.
+	 *
+	 * Orbits are found in two stages:
+	 *
+	 * * colour refinement splits the vertices into cells which can not be mapped onto each other
+	 * (vertices of different cells differ in lengths, types or colours of their edges);
+	 * * for each candidate pair of vertices of the same cell, an automorphism mapping one onto
+	 * the other is searched for by individualisation and refinement, and each found permutation
+	 * is verified edge by edge before its orbits are merged.
+	 *
+	 * Hence, two vertices are only reported to lie in the same orbit if this has been proven.
+	 * The search for each pair visits at most the specified number of branches; if the budget is
+	 * exhausted, the vertices are conservatively left in different orbits. Lengths are compared
+	 * exactly.
+	 *
+	 * \tparam  Real    Type of lengths, the same as the one of the graph.
+	 */
+	template <typename Real>
+	class VertexOrbits
+	{
+
+
+
+	public:
+
+
+
+		/// \name Constructors and destructors
+		///@{
+
+		/**
+		 * Default constructor
+		 *
+		 * Constructs orbits of an empty graph.
+		 */
+		VertexOrbits                (void);
+
+		/**
+		 * Searching constructor
+		 *
+		 * Finds orbits of vertices of the specified metric graph.
+		 *
+		 * \param   graph           A metric graph to search automorphisms of.
+		 * \param   vertices        IDs of vertices whose orbits are of interest; only these vertices
+		 *                          are compared with each other. If empty, all vertices are.
+		 * \param   search_budget   Maximal number of branches of the search for each pair of
+		 *                          vertices.
+		 */
+		explicit VertexOrbits       (MetricGraph<Real> const &graph, std::vector<uint32_t> const &vertices = std::vector<uint32_t>(), uint64_t const search_budget = 256);
+
+		///@}
+
+
+
+		/// \name Accessors
+		///@{
+
+		/**
+		 * Get the number of orbits
+		 *
+		 * \return Number of orbits found among all vertices of the graph.
+		 */
+		uint32_t const                  getOrbitCount       (void)                          const;
+
+		/**
+		 * Get representative of an orbit
+		 *
+		 * \param   vertex  Vertex ID.
+		 *
+		 * \return
+		 * * The lowest ID in the orbit of the vertex, if it is present in the graph;
+		 * * \c vertex itself, otherwise.
+		 */
+		uint32_t const                  getRepresentative   (uint32_t const vertex)         const;
+
+		/**
+		 * Get orbit of a vertex
+		 *
+		 * \param   vertex  Vertex ID.
+		 *
+		 * \return \c std::vector of IDs of vertices in the orbit of the vertex in ascending order
+		 * (empty if the vertex is absent).
+		 */
+		std::vector<uint32_t> const     getOrbit            (uint32_t const vertex)         const;
+
+		///@}
+	private:
+		using Arc               = std::pair<uint64_t, uint32_t>;
+		using Colouring         = std::vector<uint32_t>;
+
+		std::vector<uint32_t>       vertex_ids;
+		std::vector<uint32_t>       representatives;
+		uint32_t                    orbit_count;
+
+		// Search
+		static uint32_t const       refine              (std::vector<uint64_t> const &arc_offsets, std::vector<Arc> const &arcs, Colouring &colours);
+		static bool const           search              (std::vector<uint64_t> const &arc_offsets, std::vector<Arc> const &arcs, Colouring colours, uint64_t &budget, std::vector<uint32_t> &permutation);
+	};
+
+
+
+
+
+} // rwe
+
+
+
+
+
+#endif // RWE__SYMMETRY_HPP__
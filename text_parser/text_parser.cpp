@@ -0,0 +1,336 @@
+/**
+ * \file
+ *       text_parser.cpp
+ *
+ * \author
+ *       Andrei Eliseev (JointPoints), 2021
+ */
+#include "text_parser.hpp"
+
+#include <algorithm>    // needed for "min", "max", "copy", "reverse"
+#include <cerrno>       // needed for "errno"
+#include <cmath>        // needed for "ldexp", "llround"
+#include <cstdio>       // needed for "snprintf"
+#include <cstdlib>      // needed for "strtold"
+#include <limits>       // needed for "numeric_limits"
+#include <string>       // needed for "string"
+#include <thread>       // needed for "thread"
+
+
+
+
+
+namespace
+{
+	bool inline isSpace(char const symbol)
+	{
+		return (symbol == ' ') || (symbol == '\t') || (symbol == '\n') || (symbol == '\v') || (symbol == '\f') || (symbol == '\r');
+	}
+
+	bool inline isDigit(char const symbol)
+	{
+		return (symbol >= '0') && (symbol <= '9');
+	}
+
+	// Powers of ten that are exactly representable as long double, i.e., 10^k with 5^k < 2^digits
+	std::vector<long double> const & exactPowersOfTen(void)
+	{
+		static std::vector<long double> const powers = []()
+		                                               {
+		                                                   std::vector<long double>    powers(1, 1.0L);
+		                                                   long double const           mantissa_limit  = std::ldexp(1.0L, std::numeric_limits<long double>::digits);
+		                                                   long double                 power_of_five   = 5.0L;
+
+		                                                   for (; power_of_five < mantissa_limit; power_of_five *= 5)
+		                                                       powers.push_back(powers.back() * 10);
+		                                                   return powers;
+		                                               }();
+
+		return powers;
+	}
+}
+
+
+
+
+
+// Parsing
+
+
+
+
+
+bool const rwe::parseInteger(char const *begin, char const *end, int &value)
+{
+	char const     *symbol      = begin;
+	bool            is_negative = false;
+	int64_t         magnitude   = 0;
+	int64_t const   limit       = int64_t(std::numeric_limits<int>::max()) + 1;
+
+	// 1. Leading spaces and the sign
+	while ((symbol != end) && (isSpace(*symbol)))
+		++symbol;
+	if ((symbol != end) && ((*symbol == '+') || (*symbol == '-')))
+		is_negative = (*(symbol++) == '-');
+	if ((symbol == end) || (!isDigit(*symbol)))
+		return false;
+
+	// 2. Digits, the magnitude is capped right after it leaves the range of int
+	for (; (symbol != end) && (isDigit(*symbol)); ++symbol)
+		magnitude = std::min(magnitude * 10 + (*symbol - '0'), limit + 1);
+	if (magnitude > ((is_negative) ? (limit) : (limit - 1)))
+		return false;
+
+	value = (is_negative) ? (-magnitude) : (magnitude);
+	return true;
+}
+
+
+
+bool const rwe::parseUnsigned(char const *begin, char const *end, uint64_t &value)
+{
+	uint64_t            result      = 0;
+	uint64_t const      limit       = std::numeric_limits<uint64_t>::max();
+
+	if (begin == end)
+		return false;
+	for (char const *symbol = begin; symbol != end; ++symbol)
+	{
+		if ((!isDigit(*symbol)) || (result > (limit - (*symbol - '0')) / 10))
+			return false;
+		result = result * 10 + (*symbol - '0');
+	}
+
+	value = result;
+	return true;
+}
+
+
+
+bool const rwe::parseReal(char const *begin, char const *end, long double &value)
+{
+	uint32_t const      max_digits          = 18;
+	uint64_t const      max_exact_mantissa  = (std::numeric_limits<long double>::digits >= 64) ? (std::numeric_limits<uint64_t>::max()) : ((uint64_t(1) << std::numeric_limits<long double>::digits) - 1);
+	int32_t const       max_exponent        = 10000;
+	char const         *symbol              = begin;
+	bool                is_negative         = false;
+	uint64_t            mantissa            = 0;
+	uint32_t            digit_count         = 0;
+	uint32_t            significant_count   = 0;
+	int32_t             exponent            = 0;
+	char                short_buffer[129];
+	std::string         long_buffer;
+	char const         *text                = nullptr;
+	char               *text_end            = nullptr;
+	long double         result              = 0.0L;
+
+	// 1. Try the plain decimal form: [sign] digits [. digits] [(e|E) [sign] digits]
+	while ((symbol != end) && (isSpace(*symbol)))
+		++symbol;
+	if ((symbol != end) && ((*symbol == '+') || (*symbol == '-')))
+		is_negative = (*(symbol++) == '-');
+	for (bool is_fraction = false; symbol != end; ++symbol)
+	{
+		if ((*symbol == '.') && (!is_fraction))
+		{
+			is_fraction = true;
+			continue;
+		}
+		if (!isDigit(*symbol))
+			break;
+		++digit_count;
+		if ((significant_count > 0) || (*symbol != '0'))
+			++significant_count;
+		if (significant_count > max_digits)
+			break;
+		mantissa = mantissa * 10 + (*symbol - '0');
+		exponent -= is_fraction;
+	}
+	if ((digit_count > 0) && (significant_count <= max_digits) && (symbol != end) && ((*symbol == 'e') || (*symbol == 'E')))
+	{
+		char const     *exponent_symbol     = symbol + 1;
+		bool            is_exponent_negative= false;
+		int32_t         explicit_exponent   = 0;
+
+		if ((exponent_symbol != end) && ((*exponent_symbol == '+') || (*exponent_symbol == '-')))
+			is_exponent_negative = (*(exponent_symbol++) == '-');
+		if ((exponent_symbol != end) && (isDigit(*exponent_symbol)))
+		{
+			for (; (exponent_symbol != end) && (isDigit(*exponent_symbol)); ++exponent_symbol)
+				explicit_exponent = std::min(explicit_exponent * 10 + (*exponent_symbol - '0'), max_exponent);
+			exponent += (is_exponent_negative) ? (-explicit_exponent) : (explicit_exponent);
+			symbol = exponent_symbol;
+		}
+	}
+
+	// 2. If the whole text has been read, the mantissa and the power of ten are exact and only the result is rounded
+	if ((symbol == end) && (digit_count > 0) && (significant_count <= max_digits) && (mantissa <= max_exact_mantissa))
+	{
+		std::vector<long double> const &powers = exactPowersOfTen();
+
+		if (mantissa == 0)
+		{
+			value = (is_negative) ? (-0.0L) : (0.0L);
+			return true;
+		}
+		if ((exponent >= 0) && (uint32_t(exponent) < powers.size()))
+		{
+			value = (is_negative) ? (-(mantissa * powers[exponent])) : (mantissa * powers[exponent]);
+			return true;
+		}
+		if ((exponent < 0) && (uint32_t(-exponent) < powers.size()))
+		{
+			value = (is_negative) ? (-(mantissa / powers[-exponent])) : (mantissa / powers[-exponent]);
+			return true;
+		}
+	}
+
+	// 3. Everything else is left to the standard library, which needs a null-terminated copy of the text
+	if (end - begin < 129)
+	{
+		*std::copy(begin, end, short_buffer) = '\0';
+		text = short_buffer;
+	}
+	else
+	{
+		long_buffer.assign(begin, end);
+		text = long_buffer.c_str();
+	}
+	errno = 0;
+	result = std::strtold(text, &text_end);
+	if ((text_end == text) || (errno == ERANGE))
+		return false;
+
+	value = result;
+	return true;
+}
+
+
+
+
+
+// Splitting
+
+
+
+
+
+std::vector<char const *> const rwe::splitText(char const *begin, char const *end, uint64_t const min_chunk_size, std::function<bool (char const *)> const &is_boundary)
+{
+	uint64_t const              text_size       = end - begin;
+	uint32_t const              chunk_count     = std::max<uint64_t>(std::min<uint64_t>(std::thread::hardware_concurrency(), text_size / std::max<uint64_t>(min_chunk_size, 1)), 1);
+	std::vector<char const *>   chunk_begins(1, begin);
+
+	// 1. Move each even split point forward to the nearest boundary, chunks which become empty are dropped
+	for (uint32_t chunk_i = 1; chunk_i < chunk_count; ++chunk_i)
+	{
+		char const *chunk_begin = std::max(begin + text_size * chunk_i / chunk_count, chunk_begins.back() + 1);
+
+		while ((chunk_begin < end) && (!is_boundary(chunk_begin)))
+			++chunk_begin;
+		if (chunk_begin >= end)
+			break;
+		chunk_begins.push_back(chunk_begin);
+	}
+	chunk_begins.push_back(end);
+
+	return chunk_begins;
+}
+
+
+
+
+
+
+// Formatting
+
+
+
+
+
+char * rwe::formatInteger(char *buffer, uint64_t const value)
+{
+	char           *position    = buffer;
+	uint64_t        rest        = value;
+
+	// 1. Digits are written from the least significant one and then put in order
+	do
+	{
+		*(position++) = '0' + rest % 10;
+		rest /= 10;
+	}
+	while (rest > 0);
+	std::reverse(buffer, position);
+
+	return position;
+}
+
+
+
+template <typename Real>
+char * rwe::formatReal(char *buffer, Real const value)
+{
+	long double const                   absolute_value  = (value < 0) ? (-static_cast<long double>(value)) : (static_cast<long double>(value));
+	long double const                   max_mantissa    = 1e18L;
+	std::vector<long double> const     &powers          = exactPowersOfTen();
+	uint32_t const                      max_fraction    = std::min<uint32_t>(std::numeric_limits<uint64_t>::digits10, powers.size() - 1);
+	uint32_t                            low_precision   = 1;
+	uint32_t                            high_precision  = std::numeric_limits<Real>::max_digits10;
+	long double                         parsed_value    = 0.0L;
+	int                                 length          = 0;
+
+	// 1. Most lengths are short decimal fractions; the fewest fraction digits which reproduce the value are looked for
+	//    directly, and the check repeats the computation of the fast path of "parseReal"; the integer part is written
+	//    in full, so this is only the shortest form if it does not exceed the precision of "Real"; the number of fraction
+	//    digits is limited, so that the scale of the fraction fits into "uint64_t"
+	if ((absolute_value >= 1e-4L) && (absolute_value < powers[std::min<uint32_t>(std::numeric_limits<Real>::digits10, powers.size() - 1)]))
+	{
+		uint64_t scale = 1;
+
+		for (uint32_t fraction_digits = 0; (fraction_digits <= max_fraction) && (absolute_value * powers[fraction_digits] < max_mantissa); ++fraction_digits, scale *= 10)
+		{
+			uint64_t const  mantissa    = std::llround(absolute_value * powers[fraction_digits]);
+			char           *position    = buffer;
+
+			if (static_cast<Real>(mantissa / powers[fraction_digits]) != static_cast<Real>(absolute_value))
+				continue;
+			if (value < 0)
+				*(position++) = '-';
+			position = formatInteger(position, mantissa / scale);
+			if (fraction_digits > 0)
+			{
+				*position = '.';
+				position += fraction_digits + 1;
+				for (uint64_t fraction = mantissa % scale, digit_i = 0; digit_i < fraction_digits; ++digit_i, fraction /= 10)
+					*(position - 1 - digit_i) = '0' + fraction % 10;
+			}
+			return position;
+		}
+	}
+
+	// 2. Otherwise, if some precision reproduces the value, any greater precision does as well, so the least one is
+	//    found by bisection
+	while (low_precision < high_precision)
+	{
+		uint32_t const precision = (low_precision + high_precision) / 2;
+
+		length = std::snprintf(buffer, max_number_length, "%.*Lg", static_cast<int>(precision), static_cast<long double>(value));
+		if ((parseReal(buffer, buffer + length, parsed_value)) && (static_cast<Real>(parsed_value) == value))
+			high_precision = precision;
+		else
+			low_precision = precision + 1;
+	}
+
+	// 3. Write the number with the precision found
+	length = std::snprintf(buffer, max_number_length, "%.*Lg", static_cast<int>(low_precision), static_cast<long double>(value));
+
+	return buffer + length;
+}
+
+
+
+
+
+template char * rwe::formatReal<float>(char *buffer, float const value);
+template char * rwe::formatReal<double>(char *buffer, double const value);
+template char * rwe::formatReal<long double>(char *buffer, long double const value);
@@ -0,0 +1,144 @@
+/**
+ * \file
+ *       text_parser.hpp
+ *
+ * \author
+ *       Andrei Eliseev (JointPoints), 2021
+ */
+#ifndef RWE__TEXT_PARSER_HPP__
+#define RWE__TEXT_PARSER_HPP__
+
+
+
+
+
+#include <vector>           // needed for "vector"
+#include <functional>       // needed for "function"
+#include <cstdint>          // needed for "int*_t" and "uint*_t" types
+
+
+
+
+
+namespace rwe
+{
+
+
+
+
+
+	/**
+	 * \brief Parse an integer
+	 *
+	 * Parses the text the same way as \c std::stoi does, i.e., skips leading spaces, reads an
+	 * optional sign and decimal digits and ignores everything after them, but neither
+	 * allocates memory nor throws exceptions.
+	 *
+	 * \param   begin   Pointer to the first character of the text.
+	 * \param   end     Pointer past the last character of the text.
+	 * \param   value   Parsed value; left unchanged on failure.
+	 *
+	 * \return \c true, if the text begins with an integer which fits into \c int, \c false
+	 * otherwise (in which case \c std::stoi would throw an exception).
+	 */
+	bool const  parseInteger    (char const *begin, char const *end, int &value);
+
+	/**
+	 * \brief Parse an unsigned integer strictly
+	 *
+	 * Unlike \ref parseInteger, the whole text must consist of decimal digits, so that neither
+	 * spaces, nor signs, nor trailing characters are allowed.
+	 *
+	 * \param   begin   Pointer to the first character of the text.
+	 * \param   end     Pointer past the last character of the text.
+	 * \param   value   Parsed value; left unchanged on failure.
+	 *
+	 * \return \c true, if the text is a non-empty sequence of digits and the number fits into
+	 * \c uint64_t, \c false otherwise.
+	 */
+	bool const  parseUnsigned   (char const *begin, char const *end, uint64_t &value);
+
+	/**
+	 * \brief Parse a real number
+	 *
+	 * Parses the text the same way as \c std::stold does, but throws no exceptions and only
+	 * allocates memory for texts longer than 128 characters. Plain decimal numbers with at
+	 * most 18 significant digits and small exponents are converted directly with a single
+	 * rounding, which yields the same correctly rounded result; everything else (hexadecimal
+	 * numbers, infinities, trailing characters, etc.) is handed over to \c std::strtold.
+	 *
+	 * \param   begin   Pointer to the first character of the text.
+	 * \param   end     Pointer past the last character of the text.
+	 * \param   value   Parsed value; left unchanged on failure.
+	 *
+	 * \return \c true, if the text begins with a number representable as <tt>long double</tt>,
+	 * \c false otherwise (in which case \c std::stold would throw an exception).
+	 */
+	bool const  parseReal       (char const *begin, char const *end, long double &value);
+
+	/**
+	 * \brief Split text into chunks
+	 *
+	 * Splits the text into at most as many chunks as there are hardware threads, so that each
+	 * chunk is at least of the specified size and begins at a record boundary. Boundaries are
+	 * searched forward from the points which split the text evenly.
+	 *
+	 * \param   begin           Pointer to the first character of the text.
+	 * \param   end             Pointer past the last character of the text.
+	 * \param   min_chunk_size  Minimal size of a chunk in characters.
+	 * \param   is_boundary     Predicate which takes a pointer to a character within the text
+	 *                          and tells whether a record may begin there.
+	 *
+	 * \return Pointers to the beginnings of all chunks followed by \c end; chunks are never
+	 * empty.
+	 */
+	std::vector<char const *> const splitText(char const *begin, char const *end, uint64_t const min_chunk_size, std::function<bool (char const *)> const &is_boundary);
+
+	/**
+	 * \brief Maximal length of a formatted number
+	 *
+	 * Number of characters which is enough for any number written by \ref formatInteger or
+	 * \ref formatReal.
+	 */
+	uint32_t const  max_number_length   = 32;
+
+	/**
+	 * \brief Format an integer
+	 *
+	 * Writes the decimal representation of the number without a terminating null character.
+	 *
+	 * \param   buffer  Pointer to at least rwe::max_number_length characters.
+	 * \param   value   The number to write.
+	 *
+	 * \return Pointer past the last written character.
+	 */
+	char *      formatInteger   (char *buffer, uint64_t const value);
+
+	/**
+	 * \brief Format a real number
+	 *
+	 * Writes the shortest decimal representation of the number which \ref parseReal reads back
+	 * as exactly the same value of type \c Real, without a terminating null character. Numbers
+	 * from \f$10^{-4}\f$ to \f$10^d\f$, where \f$d\f$ is the number of decimal digits
+	 * \c Real can represent, are written in fixed notation if at most 18 significant digits are
+	 * needed, all other numbers in the \c %g style.
+	 *
+	 * \param   buffer  Pointer to at least rwe::max_number_length characters.
+	 * \param   value   The number to write.
+	 *
+	 * \return Pointer past the last written character.
+	 */
+	template <typename Real>
+	char *      formatReal      (char *buffer, Real const value);
+
+
+
+
+
+} // rwe
+
+
+
+
+
+#endif // RWE__TEXT_PARSER_HPP__
@@ -0,0 +1,57 @@
+/**
+ * \file
+ *       cmd_edgelist2rweg.hpp
+ *
+ * \author
+ *       Andrei Eliseev (JointPoints), 2021
+ */
+#ifndef RWE__UI_CMD_EDGELIST2RWEG_HPP__
+#define RWE__UI_CMD_EDGELIST2RWEG_HPP__
+
+
+
+
+
+#include "../ui_common.hpp"
+#include "../../metric_graph/metric_graph.hpp"
+#include <vector>       // needed for "vector"
+#include <string>       // needed for "string"
+#include <iostream>     // needed for output
+
+
+
+
+
+void cmd_edgelist2rweg(AppSettings &settings, std::vector<std::string> const &params)
+{
+	rwe::MetricGraph<long double>   graph;
+	std::string                     out_file;
+	std::size_t                     extension_position;
+	std::size_t                     folder_position;
+
+	// 1. Process params
+	if (params.size() == 1)
+		throw std::invalid_argument("Expected infile.");
+	graph.fromEdgeList(params[1]);
+
+	// 2. If there is no out file name, save with the same name without extension
+	if (params.size() == 2)
+	{
+		extension_position = params[1].find_last_of('.');
+		folder_position = params[1].find_last_of("/\\");
+		out_file = ((extension_position != std::string::npos) && ((folder_position == std::string::npos) || (extension_position > folder_position))) ? (params[1].substr(0, extension_position)) : (params[1]);
+		graph.toRWEG(out_file);
+		return;
+	}
+
+	// 3. If there is an out file name, save with the specified name
+	graph.toRWEG(params[2]);
+
+	return;
+}
+
+
+
+
+
+#endif
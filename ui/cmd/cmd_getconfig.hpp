@@ -29,6 +29,12 @@ void cmd_getconfig(AppSettings &settings, std::vector<std::string> const &params
 	std::cout << "\tEpsilon          [ewe]  :\t" << settings.default_epsilon_wander_params.epsilon << '\n';
 	std::cout << "\tTime delta       [ewtd] :\t" << settings.default_epsilon_wander_params.time_delta << '\n';
 	std::cout << "\tUse skip forward [ewsf] :\t" << ((settings.default_epsilon_wander_params.use_skip_forward) ? ("true") : ("false")) << '\n';
+	std::cout << "\tPrecision        [ewp]  :\t" << settings.default_epsilon_wander_params.precision << ( (settings.default_epsilon_wander_params.precision == PRECISION_FLOAT) ? (" (float)") : ( (settings.default_epsilon_wander_params.precision == PRECISION_DOUBLE) ? (" (double)") : (" (long double)") ) ) << '\n';
+	std::cout << "\n--- Emulator parameters ---\n";
+	std::cout << "\tVertex order     [evo]  :\t" << settings.emulator_params.vertex_order << ( (settings.emulator_params.vertex_order == 2) ? (" (reverse Cuthill-McKee)") : ( (settings.emulator_params.vertex_order == 1) ? (" (breadth-first)") : (" (by IDs)") ) ) << '\n';
+	std::cout << "\tGraph reduction  [egr]  :\t" << settings.emulator_params.graph_reduction << ( (settings.emulator_params.graph_reduction == GRAPH_REDUCTION_VALIDATE) ? (" (validate)") : ( (settings.emulator_params.graph_reduction == GRAPH_REDUCTION_ON) ? (" (on)") : (" (off)") ) ) << '\n';
+	std::cout << "\tRun planning     [erp]  :\t" << settings.emulator_params.run_planning << ( (settings.emulator_params.run_planning == RUN_PLANNING_FULL) ? (" (engine, precision and threads)") : ( (settings.emulator_params.run_planning == RUN_PLANNING_THREADS) ? (" (threads)") : (" (off)") ) ) << '\n';
+	std::cout << "\tConversion memory[ecm]  :\t" << settings.emulator_params.conversion_memory << ( (settings.emulator_params.conversion_memory == 0) ? (" (convert in memory)") : (" MiB") ) << '\n';
 	return;
 }
 
@@ -13,10 +13,17 @@
 
 
 #include "../../rw_space/rw_space.hpp"
+#include "../../symmetry/symmetry.hpp"
+#include "../../reduction/reduction.hpp"
+#include "../../planner/planner.hpp"
 #include "../ui_common.hpp"
-#include <chrono>   // needed for "chrono" and "duration_cast"
-#include <fstream>  // needed for "fstream" and "regex_match"
-#include <regex>    // needed for "regex"
+#include <algorithm>        // needed for "max", "max_element", "min_element"
+#include <chrono>           // needed for "chrono" and "duration_cast"
+#include <fstream>          // needed for "fstream" and "regex_match"
+#include <regex>            // needed for "regex"
+#include <string>           // needed for "string"
+#include <thread>           // needed for "hardware_concurrency"
+#include <unordered_map>    // needed for "unordered_map"
 
 
 
@@ -29,31 +36,255 @@ enum ScenarioParseStates
 	GRAPH_BODY_BEGIN,                   // expect a '{' character for a graph block
 	GRAPH_BODY,                         // expect a graph command ("epsilon-saturation") or a '}' character
 	EPSILON_WANDER_BEGIN,               // expect a '{' character for an epsilon-saturation block
-	EPSILON_WANDER_ARG,                 // expect an epsilon-saturation argument ("start-vertex", "epsilon", "time-delta", "use-skip-forward") or a '}' character
+	EPSILON_WANDER_ARG,                 // expect an epsilon-saturation argument ("start-vertex", "epsilon", "time-delta", "use-skip-forward", "precision") or a '}' character
 	EPSILON_WANDER_INT_VALUES_BEGIN,    // expect a ':' character before integer values inside an epsilon-saturation block
 	EPSILON_WANDER_REAL_VALUES_BEGIN,   // expect a ':' character before real values inside an epsilon-saturation block
 	EPSILON_WANDER_BOOL_VALUES_BEGIN,   // expect a ':' character before bool values inside an epsilon-saturation block
+	EPSILON_WANDER_PRECISION_BEGIN,     // expect a ':' character before precision values inside an epsilon-saturation block
 	EPSILON_WANDER_INT_VALUES,          // expect an integer value, an array of integer values, or generator of integer values
 	EPSILON_WANDER_REAL_VALUES,         // expect a real value, an array of real values, or generator of real values
 	EPSILON_WANDER_BOOL_VALUES,         // expect a bool value or an array of bool values
+	EPSILON_WANDER_PRECISION_VALUES,    // expect a precision ("float", "double", "long-double") or an array of them
 };
 
 
 
 
 
+// Emulator for a graph with lengths of type <Real>, together with an emulator for its reduction around the last start vertex
+// and a planner of experiments on the graph
+template <typename Real>
+struct EmulationInstance
+{
+	rwe::MetricGraph<Real>      graph;
+	rwe::RWSpace<Real>          rw_space;
+	rwe::GraphReduction<Real>   reduction;
+	rwe::RWSpace<Real>          reduced_rw_space;
+	rwe::RunPlanner<Real>       planner;
+	bool                        is_loaded;
+	bool                        is_reduced;
+	bool                        is_analysed;
+
+	EmulationInstance(void) : graph(), rw_space(graph), reduction(), reduced_rw_space(reduction.getGraph()), planner(), is_loaded(false), is_reduced(false), is_analysed(false) {}
+};
+
+
+
+
+
+// Emulators for the current graph of a scenario, one per precision
+struct Emulator
+{
+	std::string                         graph_path;
+	EmulationInstance<long double>      long_double_instance;
+	EmulationInstance<double>           double_instance;
+	EmulationInstance<float>            float_instance;
+};
+
+
+
+
+
+// Peak memory footprint of the experiments of an epsilon saturation block
+struct PeakMemory
+{
+	rwe::MemoryUsage                    usage;                  // footprint of the most demanding experiment
+	uint64_t                            bytes;
+	uint64_t                            agent_count;
+	uint64_t                            agent_list_capacity;
+
+	PeakMemory(void) : usage(), bytes(0), agent_count(0), agent_list_capacity(0) {}
+};
+
+
+
+
+
+// Load the current graph with lengths of type <Real>, if it has not been loaded yet
+template <typename Real>
+void loadGraph(EmulationInstance<Real> &instance, std::string const &graph_path)
+{
+	if (instance.is_loaded)
+		return;
+
+	instance.graph = rwe::MetricGraph<Real>();
+	if (graph_path.substr(graph_path.size() - 5) == ".rweg")
+		instance.graph.fromRWEG(graph_path);
+	else if ((graph_path.size() >= 6) && (graph_path.substr(graph_path.size() - 6) == ".rwegz"))
+		instance.graph.fromRWEGZ(graph_path);
+	else
+		instance.graph.fromGEXF(graph_path);
+	instance.is_loaded = true;
+	instance.is_reduced = false;
+	instance.is_analysed = false;
+
+	return;
+}
+
+
+
+// Plan a single epsilon saturation experiment on the graph with lengths of type <Real>
+template <typename Real>
+rwe::RunPlan const planSaturation(EmulationInstance<Real> &instance, long double const epsilon, long double const time_delta)
+{
+	// 1. Collect statistics of the graph (they are kept until another graph comes)
+	if (!instance.is_analysed)
+	{
+		instance.planner = rwe::RunPlanner<Real>(instance.graph);
+		instance.is_analysed = true;
+	}
+
+	return instance.planner.plan(epsilon, time_delta, std::thread::hardware_concurrency());
+}
+
+
+
+// Find representatives of the orbits of start vertices in the graph with lengths of type <Real>; each vertex is its own
+// representative, if there is nothing to share results with
+template <typename Real>
+std::vector<uint32_t> const findRepresentatives(EmulationInstance<Real> const &instance, std::vector<uint32_t> const &start_vertices)
+{
+	std::vector<uint32_t>   representatives     = start_vertices;
+
+	if (start_vertices.size() > 1)
+	{
+		rwe::VertexOrbits<Real> const orbits(instance.graph, start_vertices);
+
+		for (uint32_t start_vertex_i = 0; start_vertex_i < start_vertices.size(); ++start_vertex_i)
+			representatives[start_vertex_i] = orbits.getRepresentative(start_vertices[start_vertex_i]);
+	}
+
+	return representatives;
+}
+
+
+
+// Run a single epsilon saturation experiment with lengths of type <Real>
+template <typename Real>
+long double const runSaturation(EmulationInstance<Real> &instance, uint32_t const start_vertex, long double const epsilon, long double const time_delta, bool const use_skip_forward, uint32_t const thread_count, uint32_t const graph_reduction)
+{
+	long double saturation_time = 0.0L;
+
+	instance.rw_space.setThreadCount(thread_count);
+	instance.reduced_rw_space.setThreadCount(thread_count);
+
+	// 1. Run the experiment on the original graph, unless only the reduced one is needed
+	if (graph_reduction != GRAPH_REDUCTION_ON)
+	{
+		instance.rw_space.reset();
+		saturation_time = instance.rw_space.run_saturation(start_vertex, epsilon, time_delta, use_skip_forward);
+		if (graph_reduction == GRAPH_REDUCTION_OFF)
+			return saturation_time;
+	}
+
+	// 2. Reduce the graph around the start vertex (the reduction is kept until another start vertex or graph comes)
+	if ((!instance.is_reduced) || (instance.reduction.getStartVertex() != start_vertex))
+	{
+		instance.reduction.reduce(instance.graph, start_vertex);
+		instance.is_reduced = true;
+	}
+
+	// 3. Run the experiment on the reduced graph; reduction is exact, so in the validation mode both results must coincide
+	instance.reduced_rw_space.reset();
+	long double const reduced_saturation_time = instance.reduced_rw_space.run_saturation(start_vertex, epsilon, time_delta, use_skip_forward);
+	if ((graph_reduction == GRAPH_REDUCTION_VALIDATE) && (reduced_saturation_time != saturation_time))
+		throw std::domain_error("Graph reduction has changed the saturation time from " + std::to_string(saturation_time) + " to " + std::to_string(reduced_saturation_time) + ".");
+
+	return reduced_saturation_time;
+}
+
+
+
+
+
+// Take the memory footprint of the graph with lengths of type <Real> and of the emulators the last experiment has been run with
+// into account
+template <typename Real>
+void updatePeakMemory(EmulationInstance<Real> &instance, uint32_t const graph_reduction, PeakMemory &peak_memory)
+{
+	rwe::MemoryUsage                usage;
+	uint64_t                        bytes       = 0;
+	auto const                      append      = [&usage](std::string const &prefix, rwe::MemoryUsage const &part_usage)
+	                                              {
+	                                                  for (uint32_t record_i = 0; record_i < part_usage.size(); ++record_i)
+	                                                      usage.push_back({prefix + part_usage[record_i].name, part_usage[record_i].bytes, part_usage[record_i].peak_bytes});
+	                                              };
+	auto const                      add_agents  = [&peak_memory](rwe::RWSpace<Real> const &rw_space)
+	                                              {
+	                                                  std::vector<uint64_t> const capacities = rw_space.getAgentListCapacities();
+
+	                                                  peak_memory.agent_count = std::max(peak_memory.agent_count, rw_space.getPeakAgentCount());
+	                                                  if (capacities.size() > 0)
+	                                                      peak_memory.agent_list_capacity = std::max(peak_memory.agent_list_capacity, *std::max_element(capacities.begin(), capacities.end()));
+	                                              };
+
+	// 1. Collect footprints of the graph and of the emulators the experiment has been run with
+	append("graph ", instance.graph.getMemoryUsage());
+	if (graph_reduction != GRAPH_REDUCTION_ON)
+	{
+		append("emulator ", instance.rw_space.getMemoryUsage());
+		add_agents(instance.rw_space);
+	}
+	if (graph_reduction != GRAPH_REDUCTION_OFF)
+	{
+		append("reduced graph ", instance.reduction.getGraph().getMemoryUsage());
+		append("reduced emulator ", instance.reduced_rw_space.getMemoryUsage());
+		add_agents(instance.reduced_rw_space);
+	}
+
+	// 2. Keep the footprint of the most demanding experiment
+	for (uint32_t record_i = 0; record_i < usage.size(); ++record_i)
+		bytes += usage[record_i].peak_bytes;
+	if (bytes > peak_memory.bytes)
+	{
+		peak_memory.usage = usage;
+		peak_memory.bytes = bytes;
+	}
+
+	return;
+}
+
+
+
+
+
 // Run epsilon wander emulation
 #define EMULATION_ERROR(what)   throw std::domain_error(what);
-void runEpsilonWander(AppSettings const &settings, rwe::RWSpace &rw_space,
+void runEpsilonWander(AppSettings const &settings, Emulator &emulator,
                       std::vector<uint32_t> &epsilon_wander_start_vertex, std::vector<long double> &epsilon_wander_epsilon,
                       std::vector<long double> &epsilon_wander_time_delta, std::vector<bool> &epsilon_wander_use_skip_forward,
-                      uint8_t const verbosity_level)
+                      std::vector<uint32_t> &epsilon_wander_precision, uint8_t const verbosity_level)
 {
+	std::string const precision_names[] = {"long double", "double", "float"};
+
 	// 1. If some parameters were not set by user, set them by default values
 	if (epsilon_wander_start_vertex.size() == 0) epsilon_wander_start_vertex.push_back(settings.default_epsilon_wander_params.start_vertex);
 	if (epsilon_wander_epsilon.size() == 0) epsilon_wander_epsilon.push_back(settings.default_epsilon_wander_params.epsilon);
 	if (epsilon_wander_time_delta.size() == 0) epsilon_wander_time_delta.push_back(settings.default_epsilon_wander_params.time_delta);
 	if (epsilon_wander_use_skip_forward.size() == 0) epsilon_wander_use_skip_forward.push_back(settings.default_epsilon_wander_params.use_skip_forward);
+	if (epsilon_wander_precision.size() == 0) epsilon_wander_precision.push_back(settings.default_epsilon_wander_params.precision);
+	// 1.1. If the algorithm and precision are chosen by the planner, the ones of the scenario are ignored (the first precision
+	//      is only used to collect statistics of the graph)
+	if (settings.emulator_params.run_planning == RUN_PLANNING_FULL)
+	{
+		epsilon_wander_use_skip_forward.resize(1);
+		epsilon_wander_precision.resize(1);
+	}
+
+	// 1.2. Load the graph with each of the requested precisions
+	for (uint32_t precision_i = 0; precision_i < epsilon_wander_precision.size(); ++precision_i)
+		switch (epsilon_wander_precision[precision_i])
+		{
+		case PRECISION_FLOAT:
+			loadGraph(emulator.float_instance, emulator.graph_path);
+			break;
+		case PRECISION_DOUBLE:
+			loadGraph(emulator.double_instance, emulator.graph_path);
+			break;
+		default:
+			loadGraph(emulator.long_double_instance, emulator.graph_path);
+			break;
+		}
 
 	// 2. Print header
 	switch (verbosity_level)
@@ -71,37 +302,121 @@ void runEpsilonWander(AppSettings const &settings, rwe::RWSpace &rw_space,
 		break;
 	}
 
-	// 3. Run emulations
+	// 3. Run emulations; start vertices of the same orbit are mirror images of each other, so only the
+	//    first of them is emulated and the others reuse its results (orbits are found with the highest of
+	//    the loaded precisions and remain orbits after rounding to lower ones, since equal lengths stay equal)
 	auto time_start = std::chrono::high_resolution_clock::now();
+	uint32_t const                                          orbit_precision = *std::min_element(epsilon_wander_precision.begin(), epsilon_wander_precision.end());
+	std::vector<uint32_t>                                   representatives;
+	std::unordered_map<uint32_t, std::vector<long double>>  orbit_results;
+	switch (orbit_precision)
+	{
+	case PRECISION_FLOAT:
+		representatives = findRepresentatives(emulator.float_instance, epsilon_wander_start_vertex);
+		break;
+	case PRECISION_DOUBLE:
+		representatives = findRepresentatives(emulator.double_instance, epsilon_wander_start_vertex);
+		break;
+	default:
+		representatives = findRepresentatives(emulator.long_double_instance, epsilon_wander_start_vertex);
+		break;
+	}
+	PeakMemory                                              peak_memory;
 	for (uint32_t start_vertex_i = 0; start_vertex_i < epsilon_wander_start_vertex.size(); ++start_vertex_i)
 	for (uint32_t epsilon_i = 0; epsilon_i < epsilon_wander_epsilon.size(); ++epsilon_i)
 	for (uint32_t time_delta_i = 0; time_delta_i < epsilon_wander_time_delta.size(); ++time_delta_i)
 	for (uint32_t use_skip_forward_i = 0; use_skip_forward_i < epsilon_wander_use_skip_forward.size(); ++use_skip_forward_i)
+	for (uint32_t precision_i = 0; precision_i < epsilon_wander_precision.size(); ++precision_i)
 	{
-		rw_space.reset();
 		try
 		{
-			long double saturation_time = rw_space.run_saturation(epsilon_wander_start_vertex[start_vertex_i], epsilon_wander_epsilon[epsilon_i], epsilon_wander_time_delta[time_delta_i], epsilon_wander_use_skip_forward[use_skip_forward_i]);
+			std::vector<long double>   &curr_results    = orbit_results[representatives[start_vertex_i]];
+			uint64_t const              experiment_i    = ((uint64_t(epsilon_i) * epsilon_wander_time_delta.size() + time_delta_i) * epsilon_wander_use_skip_forward.size() + use_skip_forward_i) * epsilon_wander_precision.size() + precision_i;
+			long double                 saturation_time = 0.0L;
+			rwe::RunPlan                plan            = {epsilon_wander_use_skip_forward[use_skip_forward_i], static_cast<rwe::Precision>(epsilon_wander_precision[precision_i]), 1, 0.0L, 0.0L, 0.0L};
+
+			// 3.1. Plan the experiment; only the number of threads is taken from the plan, unless the planner is fully trusted
+			if (settings.emulator_params.run_planning != RUN_PLANNING_OFF)
+			{
+				switch (epsilon_wander_precision[0])
+				{
+				case PRECISION_FLOAT:
+					plan = planSaturation(emulator.float_instance, epsilon_wander_epsilon[epsilon_i], epsilon_wander_time_delta[time_delta_i]);
+					break;
+				case PRECISION_DOUBLE:
+					plan = planSaturation(emulator.double_instance, epsilon_wander_epsilon[epsilon_i], epsilon_wander_time_delta[time_delta_i]);
+					break;
+				default:
+					plan = planSaturation(emulator.long_double_instance, epsilon_wander_epsilon[epsilon_i], epsilon_wander_time_delta[time_delta_i]);
+					break;
+				}
+				if (settings.emulator_params.run_planning != RUN_PLANNING_FULL)
+				{
+					plan.use_skip_forward = epsilon_wander_use_skip_forward[use_skip_forward_i];
+					plan.precision = static_cast<rwe::Precision>(epsilon_wander_precision[precision_i]);
+				}
+			}
+
+			// 3.2. Run the experiment, unless it has been run for another start vertex of the same orbit (the planner may choose
+			//      a higher precision than the one orbits have been found with, then the experiment is run anyway)
+			if ((experiment_i < curr_results.size()) && (plan.precision >= orbit_precision))
+				saturation_time = curr_results[experiment_i];
+			else
+			{
+				switch (plan.precision)
+				{
+				case PRECISION_FLOAT:
+					loadGraph(emulator.float_instance, emulator.graph_path);
+					saturation_time = runSaturation(emulator.float_instance, epsilon_wander_start_vertex[start_vertex_i], epsilon_wander_epsilon[epsilon_i], epsilon_wander_time_delta[time_delta_i], plan.use_skip_forward, plan.thread_count, settings.emulator_params.graph_reduction);
+					updatePeakMemory(emulator.float_instance, settings.emulator_params.graph_reduction, peak_memory);
+					break;
+				case PRECISION_DOUBLE:
+					loadGraph(emulator.double_instance, emulator.graph_path);
+					saturation_time = runSaturation(emulator.double_instance, epsilon_wander_start_vertex[start_vertex_i], epsilon_wander_epsilon[epsilon_i], epsilon_wander_time_delta[time_delta_i], plan.use_skip_forward, plan.thread_count, settings.emulator_params.graph_reduction);
+					updatePeakMemory(emulator.double_instance, settings.emulator_params.graph_reduction, peak_memory);
+					break;
+				default:
+					loadGraph(emulator.long_double_instance, emulator.graph_path);
+					saturation_time = runSaturation(emulator.long_double_instance, epsilon_wander_start_vertex[start_vertex_i], epsilon_wander_epsilon[epsilon_i], epsilon_wander_time_delta[time_delta_i], plan.use_skip_forward, plan.thread_count, settings.emulator_params.graph_reduction);
+					updatePeakMemory(emulator.long_double_instance, settings.emulator_params.graph_reduction, peak_memory);
+					break;
+				}
+				if (experiment_i >= curr_results.size())
+					curr_results.push_back(saturation_time);
+			}
+
+			// 3.3. Print the result together with the plan
 			switch (verbosity_level)
 			{
 			// raw output
 			case 0:
-				std::cout << (((epsilon_i | time_delta_i | use_skip_forward_i) > 0) ? (",") : (  (start_vertex_i > 0) ? ("\n") : ("")  )) << saturation_time;
+				std::cout << (((epsilon_i | time_delta_i | use_skip_forward_i | precision_i) > 0) ? (",") : (  (start_vertex_i > 0) ? ("\n") : ("")  )) << saturation_time;
 				break;
 			// default output
 			case 1:
-				std::cout << (((epsilon_i | time_delta_i | use_skip_forward_i) > 0) ? ("") : ("\tStart vertex : " + std::to_string(epsilon_wander_start_vertex[start_vertex_i]) + "\n"));
-				std::cout << "\t\tEpsilon = " << epsilon_wander_epsilon[epsilon_i] << "(time delta = " << epsilon_wander_time_delta[time_delta_i] << ")\t: " << saturation_time << '\n';
+				std::cout << (((epsilon_i | time_delta_i | use_skip_forward_i | precision_i) > 0) ? ("") : ("\tStart vertex : " + std::to_string(epsilon_wander_start_vertex[start_vertex_i]) + "\n"));
+				std::cout << "\t\tEpsilon = " << epsilon_wander_epsilon[epsilon_i] << "(time delta = " << epsilon_wander_time_delta[time_delta_i] << ", precision = " << precision_names[plan.precision] << ")\t: " << saturation_time << '\n';
+				if (settings.emulator_params.run_planning != RUN_PLANNING_OFF)
+					std::cout << "\t\t\tPlan : " << ((plan.use_skip_forward) ? ("skip forward") : ("precise")) << ", " << precision_names[plan.precision] << ", " << plan.thread_count << " thread(s); predicted saturation time " << plan.predicted_time << ", predicted cost " << ((plan.use_skip_forward) ? (plan.skip_forward_cost) : (plan.precise_cost)) << " updates\n";
 				break;
 			// MarkDown output
 			case 2:
-				std::cout << (((epsilon_i | time_delta_i | use_skip_forward_i) > 0) ? ("") : ("\n#### Start vertex : " + std::to_string(epsilon_wander_start_vertex[start_vertex_i]) + "\n\n"));
-				std::cout << (((epsilon_i | time_delta_i | use_skip_forward_i) > 0) ? ("") : ("| Epsilon | Time delta | Saturation time |\n|:-------:|:----------:|:---------------:|\n"));
-				std::cout << "| " << epsilon_wander_epsilon[epsilon_i] << " | " << epsilon_wander_time_delta[time_delta_i] << " | " << saturation_time << " |\n";
+				std::cout << (((epsilon_i | time_delta_i | use_skip_forward_i | precision_i) > 0) ? ("") : ("\n#### Start vertex : " + std::to_string(epsilon_wander_start_vertex[start_vertex_i]) + "\n\n"));
+				if (settings.emulator_params.run_planning == RUN_PLANNING_OFF)
+				{
+					std::cout << (((epsilon_i | time_delta_i | use_skip_forward_i | precision_i) > 0) ? ("") : ("| Epsilon | Time delta | Precision | Saturation time |\n|:-------:|:----------:|:---------:|:---------------:|\n"));
+					std::cout << "| " << epsilon_wander_epsilon[epsilon_i] << " | " << epsilon_wander_time_delta[time_delta_i] << " | " << precision_names[plan.precision] << " | " << saturation_time << " |\n";
+				}
+				else
+				{
+					std::cout << (((epsilon_i | time_delta_i | use_skip_forward_i | precision_i) > 0) ? ("") : ("| Epsilon | Time delta | Precision | Saturation time | Algorithm | Threads | Predicted saturation time | Predicted cost |\n|:-------:|:----------:|:---------:|:---------------:|:---------:|:-------:|:-------------------------:|:--------------:|\n"));
+					std::cout << "| " << epsilon_wander_epsilon[epsilon_i] << " | " << epsilon_wander_time_delta[time_delta_i] << " | " << precision_names[plan.precision] << " | " << saturation_time << " | " << ((plan.use_skip_forward) ? ("skip forward") : ("precise")) << " | " << plan.thread_count << " | " << plan.predicted_time << " | " << ((plan.use_skip_forward) ? (plan.skip_forward_cost) : (plan.precise_cost)) << " |\n";
+				}
 				break;
 			}
 		}
 		catch (std::invalid_argument &e) {if (verbosity_level == 0) std::cout << '\n'; EMULATION_ERROR("The start vertex does not exist.");}
+		catch (std::domain_error &e) {if (verbosity_level == 0) std::cout << '\n'; EMULATION_ERROR(e.what());}
 		catch (std::logic_error &e) {if (verbosity_level == 0) std::cout << '\n'; EMULATION_ERROR("Unknown exception.");}
 		catch (...) {if (verbosity_level == 0) std::cout << '\n'; EMULATION_ERROR("Unknown exception.");}
 	}
@@ -116,15 +431,22 @@ void runEpsilonWander(AppSettings const &settings, rwe::RWSpace &rw_space,
 		break;
 	// default output
 	case 1:
+		std::cout << "Peak memory : " << peak_memory.bytes << " bytes (" << peak_memory.agent_count << " agent instances alive at once, the largest list of them has room for " << peak_memory.agent_list_capacity << ")\n";
+		for (uint32_t record_i = 0; record_i < peak_memory.usage.size(); ++record_i)
+			std::cout << "\t" << peak_memory.usage[record_i].name << " : " << peak_memory.usage[record_i].peak_bytes << " bytes\n";
 		std::cout << "Completed in " << std::chrono::duration_cast<std::chrono::seconds>(time_stop - time_start).count() << " seconds.\n";
 		break;
 	// MarkDown output
 	case 2:
+		std::cout << "\nPeak memory : " << peak_memory.bytes << " bytes (" << peak_memory.agent_count << " agent instances alive at once, the largest list of them has room for " << peak_memory.agent_list_capacity << ")\n\n";
+		std::cout << "| Structure | Peak bytes |\n|:---------:|:----------:|\n";
+		for (uint32_t record_i = 0; record_i < peak_memory.usage.size(); ++record_i)
+			std::cout << "| " << peak_memory.usage[record_i].name << " | " << peak_memory.usage[record_i].peak_bytes << " |\n";
 		std::cout << "\nCompleted in " << std::chrono::duration_cast<std::chrono::seconds>(time_stop - time_start).count() << " seconds.\n";
 		break;
 	}
 
-	epsilon_wander_start_vertex.clear(); epsilon_wander_epsilon.clear(); epsilon_wander_time_delta.clear(); epsilon_wander_use_skip_forward.clear();
+	epsilon_wander_start_vertex.clear(); epsilon_wander_epsilon.clear(); epsilon_wander_time_delta.clear(); epsilon_wander_use_skip_forward.clear(); epsilon_wander_precision.clear();
 
 	return;
 }
@@ -150,13 +472,12 @@ void cmd_run(AppSettings &settings, std::vector<std::string> const &params)
 	std::string                 curr_argument_string;
 	ScenarioParseStates         parser_state = TOP;
 
-	rwe::MetricGraph     graph;
-
-	rwe::RWSpace         rw_space(graph);
+	Emulator                    emulator;
 	std::vector<uint32_t>       epsilon_wander_start_vertex;
 	std::vector<long double>    epsilon_wander_epsilon;
 	std::vector<long double>    epsilon_wander_time_delta;
 	std::vector<bool>           epsilon_wander_use_skip_forward;
+	std::vector<uint32_t>       epsilon_wander_precision;
 
 	std::vector<uint32_t>      *curr_int_params     = nullptr;
 	std::vector<long double>   *curr_real_params    = nullptr;
@@ -164,6 +485,13 @@ void cmd_run(AppSettings &settings, std::vector<std::string> const &params)
 
 	uint8_t                     verbosity_level     = 1;
 
+	emulator.long_double_instance.rw_space.setVertexOrder(static_cast<rwe::VertexOrder>(settings.emulator_params.vertex_order));
+	emulator.double_instance.rw_space.setVertexOrder(static_cast<rwe::VertexOrder>(settings.emulator_params.vertex_order));
+	emulator.float_instance.rw_space.setVertexOrder(static_cast<rwe::VertexOrder>(settings.emulator_params.vertex_order));
+	emulator.long_double_instance.reduced_rw_space.setVertexOrder(static_cast<rwe::VertexOrder>(settings.emulator_params.vertex_order));
+	emulator.double_instance.reduced_rw_space.setVertexOrder(static_cast<rwe::VertexOrder>(settings.emulator_params.vertex_order));
+	emulator.float_instance.reduced_rw_space.setVertexOrder(static_cast<rwe::VertexOrder>(settings.emulator_params.vertex_order));
+
 	// 1. Process params
 	for (uint32_t param_i = 1; param_i < params.size(); ++param_i)
 	{
@@ -285,7 +613,7 @@ void cmd_run(AppSettings &settings, std::vector<std::string> const &params)
 		case GRAPH_FILE:
 			if (tokens[token_i].size() < 5)
 				EMULATION_ERROR("Unsupported file format.");
-			if ((tokens[token_i].substr(tokens[token_i].size() - 5) != ".rweg") && (tokens[token_i].substr(tokens[token_i].size() - 5) != ".gexf"))
+			if ((tokens[token_i].substr(tokens[token_i].size() - 5) != ".rweg") && (tokens[token_i].substr(tokens[token_i].size() - 5) != ".gexf") && ((tokens[token_i].size() < 6) || (tokens[token_i].substr(tokens[token_i].size() - 6) != ".rwegz")))
 				EMULATION_ERROR("Unsupported file format.");
 			in_file.open(tokens[token_i], std::fstream::in);
 			if (!in_file.is_open())
@@ -294,11 +622,10 @@ void cmd_run(AppSettings &settings, std::vector<std::string> const &params)
 				EMULATION_ERROR("Graph '" + tokens[token_i] + "' does not exist.");
 			}
 			in_file.close();
-			graph = rwe::MetricGraph();
-			if (tokens[token_i].substr(tokens[token_i].size() - 5) == ".rweg")
-				graph.fromRWEG(tokens[token_i]);
-			else
-				graph.fromGEXF(tokens[token_i]);
+			emulator.graph_path = tokens[token_i];
+			emulator.long_double_instance.is_loaded = false;
+			emulator.double_instance.is_loaded = false;
+			emulator.float_instance.is_loaded = false;
 			switch (verbosity_level)
 			{
 			// raw output
@@ -369,9 +696,14 @@ void cmd_run(AppSettings &settings, std::vector<std::string> const &params)
 				parser_state = EPSILON_WANDER_BOOL_VALUES_BEGIN;
 				break;
 			}
+			if (tokens[token_i] == "precision")
+			{
+				parser_state = EPSILON_WANDER_PRECISION_BEGIN;
+				break;
+			}
 			if (tokens[token_i] == "}")
 			{
-				runEpsilonWander(settings, rw_space, epsilon_wander_start_vertex, epsilon_wander_epsilon, epsilon_wander_time_delta, epsilon_wander_use_skip_forward, verbosity_level);
+				runEpsilonWander(settings, emulator, epsilon_wander_start_vertex, epsilon_wander_epsilon, epsilon_wander_time_delta, epsilon_wander_use_skip_forward, epsilon_wander_precision, verbosity_level);
 				parser_state = GRAPH_BODY;
 				break;
 			}
@@ -404,6 +736,15 @@ void cmd_run(AppSettings &settings, std::vector<std::string> const &params)
 			}
 			SYNTAX_ERROR("Expected a colon after the name of the parameter '" + curr_argument_string + "'. Found '" + tokens[token_i] + "' instead.");
 		
+		// expect a ':' character before precision values inside an epsilon-saturation block
+		case EPSILON_WANDER_PRECISION_BEGIN:
+			if (tokens[token_i] == ":")
+			{
+				parser_state = EPSILON_WANDER_PRECISION_VALUES;
+				break;
+			}
+			SYNTAX_ERROR("Expected a colon after the name of the parameter '" + curr_argument_string + "'. Found '" + tokens[token_i] + "' instead.");
+		
 		// expect an integer value, an array of integer values, or generator of integer values
 		case EPSILON_WANDER_INT_VALUES:
 			if (tokens[token_i] == ",")
@@ -413,7 +754,7 @@ void cmd_run(AppSettings &settings, std::vector<std::string> const &params)
 			}
 			if (tokens[token_i] == "}")
 			{
-				runEpsilonWander(settings, rw_space, epsilon_wander_start_vertex, epsilon_wander_epsilon, epsilon_wander_time_delta, epsilon_wander_use_skip_forward, verbosity_level);
+				runEpsilonWander(settings, emulator, epsilon_wander_start_vertex, epsilon_wander_epsilon, epsilon_wander_time_delta, epsilon_wander_use_skip_forward, epsilon_wander_precision, verbosity_level);
 				parser_state = GRAPH_BODY;
 				break;
 			}
@@ -454,7 +795,7 @@ void cmd_run(AppSettings &settings, std::vector<std::string> const &params)
 			}
 			if (tokens[token_i] == "}")
 			{
-				runEpsilonWander(settings, rw_space, epsilon_wander_start_vertex, epsilon_wander_epsilon, epsilon_wander_time_delta, epsilon_wander_use_skip_forward, verbosity_level);
+				runEpsilonWander(settings, emulator, epsilon_wander_start_vertex, epsilon_wander_epsilon, epsilon_wander_time_delta, epsilon_wander_use_skip_forward, epsilon_wander_precision, verbosity_level);
 				parser_state = GRAPH_BODY;
 				break;
 			}
@@ -495,7 +836,7 @@ void cmd_run(AppSettings &settings, std::vector<std::string> const &params)
 			}
 			if (tokens[token_i] == "}")
 			{
-				runEpsilonWander(settings, rw_space, epsilon_wander_start_vertex, epsilon_wander_epsilon, epsilon_wander_time_delta, epsilon_wander_use_skip_forward, verbosity_level);
+				runEpsilonWander(settings, emulator, epsilon_wander_start_vertex, epsilon_wander_epsilon, epsilon_wander_time_delta, epsilon_wander_use_skip_forward, epsilon_wander_precision, verbosity_level);
 				parser_state = GRAPH_BODY;
 				break;
 			}
@@ -510,6 +851,36 @@ void cmd_run(AppSettings &settings, std::vector<std::string> const &params)
 				break;
 			}
 			SYNTAX_ERROR("Cannot interpret value '" + tokens[token_i] + "' for parameter '" + curr_argument_string + "' as boolean.");
+		
+		// expect a precision ("float", "double", "long-double") or an array of them
+		case EPSILON_WANDER_PRECISION_VALUES:
+			if (tokens[token_i] == ",")
+			{
+				parser_state = EPSILON_WANDER_ARG;
+				break;
+			}
+			if (tokens[token_i] == "}")
+			{
+				runEpsilonWander(settings, emulator, epsilon_wander_start_vertex, epsilon_wander_epsilon, epsilon_wander_time_delta, epsilon_wander_use_skip_forward, epsilon_wander_precision, verbosity_level);
+				parser_state = GRAPH_BODY;
+				break;
+			}
+			if (tokens[token_i] == "float")
+			{
+				epsilon_wander_precision.push_back(PRECISION_FLOAT);
+				break;
+			}
+			if (tokens[token_i] == "double")
+			{
+				epsilon_wander_precision.push_back(PRECISION_DOUBLE);
+				break;
+			}
+			if (tokens[token_i] == "long-double")
+			{
+				epsilon_wander_precision.push_back(PRECISION_LONG_DOUBLE);
+				break;
+			}
+			SYNTAX_ERROR("Cannot interpret value '" + tokens[token_i] + "' for parameter '" + curr_argument_string + "' as precision.");
 		}
 	}
 
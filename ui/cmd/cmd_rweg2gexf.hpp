@@ -24,25 +24,29 @@
 
 void cmd_rweg2gexf(AppSettings &settings, std::vector<std::string> const &params)
 {
-	rwe::MetricGraph    graph;
-	std::string         in_file;
+	rwe::MetricGraph<long double>   graph;
+	std::string                     in_file;
+	std::string                     out_file;
 
-	// 1. Process params
+	// 1. Process params; if there is no out file name, save with the same name but different format
 	if (params.size() == 1)
 		throw std::invalid_argument("Expected infile.");
 	in_file = (params[1].substr(params[1].size() - 5) == ".rweg") ? (params[1].substr(0, params[1].size() - 5) ) : (params[1]);
+	out_file = (params.size() == 2) ? (in_file) : (params[2]);
 
-	// 2. If there is no out file name, save with the same name but different format
-	if (params.size() == 2)
+	// 2. If conversion memory is limited, the graph is converted through temporary files next to the out file
+	if (settings.emulator_params.conversion_memory > 0)
 	{
-		graph.fromRWEG(in_file);
-		graph.toGEXF(in_file);
+		rwe::ExternalGraphBuilder<long double> builder(uint64_t(settings.emulator_params.conversion_memory) << 20, out_file);
+
+		builder.fromRWEG(in_file);
+		builder.toGEXF(out_file);
 		return;
 	}
 
-	// 3. If there is an out file name, save with the specified name
+	// 3. Otherwise, the whole graph is loaded into memory
 	graph.fromRWEG(in_file);
-	graph.toGEXF(params[2]);
+	graph.toGEXF(out_file);
 
 	return;
 }
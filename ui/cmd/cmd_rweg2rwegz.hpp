@@ -0,0 +1,81 @@
+/**
+ * \file
+ *       cmd_rweg2rwegz.hpp
+ *
+ * \author
+ *       Andrei Eliseev (JointPoints), 2021
+ */
+#ifndef RWE__UI_CMD_RWEG2RWEGZ_HPP__
+#define RWE__UI_CMD_RWEG2RWEGZ_HPP__
+
+
+
+
+
+#include "../ui_common.hpp"
+#include "../../metric_graph/metric_graph.hpp"
+#include "../../mapped_file/mapped_file.hpp"
+#include "../../rwegz/rwegz.hpp"
+#include <vector>       // needed for "vector"
+#include <string>       // needed for "string"
+#include <iostream>     // needed for output
+#include <chrono>       // needed for "chrono" and "duration_cast"
+#include <algorithm>    // needed for "max"
+#include <thread>       // needed for "thread"
+
+
+
+
+
+void cmd_rweg2rwegz(AppSettings &settings, std::vector<std::string> const &params)
+{
+	rwe::MetricGraph<long double>   graph;
+	std::string                     in_file;
+	std::string                     out_file;
+	std::vector<uint32_t>           vertex_ids;
+	std::vector<uint64_t>           offsets;
+	std::vector<uint32_t>           targets;
+	std::vector<double>             lengths;
+	std::vector<uint64_t>           directions;
+	uint64_t                        in_size     = 0;
+	uint64_t                        out_size    = 0;
+	double                          decode_time = 0.0;
+
+	// 1. Process params
+	if (params.size() == 1)
+		throw std::invalid_argument("Expected infile.");
+	in_file = ((params[1].size() >= 5) && (params[1].substr(params[1].size() - 5) == ".rweg")) ? (params[1].substr(0, params[1].size() - 5) ) : (params[1]);
+
+	// 2. Save with the same name but different format if there is no out file name, or with the specified name otherwise
+	graph.fromRWEG(in_file);
+	out_file = graph.toRWEGZ((params.size() == 2) ? (in_file) : (params[2]));
+
+	// 3. Decode the written file once again to measure the speed of decoding
+	auto time_start = std::chrono::high_resolution_clock::now();
+	{
+		rwe::RWEGZFile const rwegz_file(out_file);
+
+		vertex_ids.resize(rwegz_file.getVertexCount());
+		offsets.resize(rwegz_file.getVertexCount() + uint64_t(1));
+		targets.resize(rwegz_file.getEdgeCount());
+		lengths.resize(rwegz_file.getEdgeCount());
+		directions.resize((rwegz_file.getEdgeCount() + 63) / 64);
+		rwegz_file.decode(vertex_ids.data(), offsets.data(), targets.data(), lengths.data(), directions.data());
+	}
+	auto time_stop = std::chrono::high_resolution_clock::now();
+	decode_time = std::max(std::chrono::duration_cast<std::chrono::duration<double>>(time_stop - time_start).count(), 1e-9);
+	in_size = rwe::MappedFile(in_file + ".rweg").getSize();
+	out_size = rwe::MappedFile(out_file).getSize();
+
+	// 4. Report the ratio and the speed
+	std::cout << "Compressed " << in_size << " bytes into " << out_size << " bytes (ratio " << ((out_size > 0) ? (double(in_size) / out_size) : (0.0)) << ").\n";
+	std::cout << "Decoded " << targets.size() << " edges in " << decode_time << " seconds (" << targets.size() / decode_time / 1e6 << " million edges per second, " << out_size / decode_time / (1 << 20) << " MiB per second) on up to " << std::max(std::thread::hardware_concurrency(), 1u) << " thread(s).\n";
+
+	return;
+}
+
+
+
+
+
+#endif
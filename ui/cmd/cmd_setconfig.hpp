@@ -49,7 +49,20 @@ void cmd_setconfig(AppSettings &settings, std::vector<std::string> const &params
 
 	std::map<std::string, std::pair<uint32_t *const, uint32_t *const> >         int_options
 	{
-		{"ewsv", {&settings.default_epsilon_wander_params.start_vertex, &default_settings.default_epsilon_wander_params.start_vertex}}
+		{"ewsv", {&settings.default_epsilon_wander_params.start_vertex, &default_settings.default_epsilon_wander_params.start_vertex}},
+		{"ewp",  {&settings.default_epsilon_wander_params.precision, &default_settings.default_epsilon_wander_params.precision}},
+		{"evo",  {&settings.emulator_params.vertex_order, &default_settings.emulator_params.vertex_order}},
+		{"egr",  {&settings.emulator_params.graph_reduction, &default_settings.emulator_params.graph_reduction}},
+		{"erp",  {&settings.emulator_params.run_planning, &default_settings.emulator_params.run_planning}},
+		{"ecm",  {&settings.emulator_params.conversion_memory, &default_settings.emulator_params.conversion_memory}}
+	};
+	std::map<std::string, uint32_t const>                                       int_limits
+	{
+		{"ewp",  PRECISION_FLOAT},
+		{"evo",  2},
+		{"egr",  GRAPH_REDUCTION_VALIDATE},
+		{"erp",  RUN_PLANNING_FULL},
+		{"ecm",  1 << 20}
 	};
 	std::map<std::string, std::pair<long double *const, long double *const> >   real_options
 	{
@@ -80,7 +93,7 @@ void cmd_setconfig(AppSettings &settings, std::vector<std::string> const &params
 		if (remove("Technical files/gc"))
 			throw std::invalid_argument("Operation cannot be completed. Make sure all files in 'Technical files' directory are closed and untouched.");
 		
-		settings.default_epsilon_wander_params = init().default_epsilon_wander_params;
+		settings = init();
 
 		return;
 	}
@@ -123,6 +136,8 @@ void cmd_setconfig(AppSettings &settings, std::vector<std::string> const &params
 		switch (curr_option_type)
 		{
 		case OT_INT:
+			if ((int_limits.find(params[1]) != int_limits.end()) && (std::stoul(params[2]) > int_limits.at(params[1])))
+				throw std::out_of_range(params[2]);
 			*int_options[params[1]].first = std::stoi(params[2]);
 			break;
 		case OT_REAL:
@@ -137,6 +152,10 @@ void cmd_setconfig(AppSettings &settings, std::vector<std::string> const &params
 			break;
 		}
 	}
+	catch (std::out_of_range &)
+	{
+		throw std::invalid_argument("Value '" + params[2] + "' is out of range for option '" + params[1] + "'.");
+	}
 	catch (...)
 	{
 		throw std::invalid_argument("Cannot interpret value '" + params[2] + "' as " + ( (curr_option_type == OT_INT) ? ("integer.") : ( (curr_option_type == OT_REAL) ? ("real.") : ("boolean.") ) ));
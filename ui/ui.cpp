@@ -7,10 +7,15 @@
  */
 #include "ui.hpp"
 
+#include "cmd/cmd_edgelist2rweg.hpp"
 #include "cmd/cmd_getconfig.hpp"
 #include "cmd/cmd_gexf2rweg.hpp"
+#include "cmd/cmd_metis2rweg.hpp"
+#include "cmd/cmd_mtx2rweg.hpp"
 #include "cmd/cmd_run.hpp"
 #include "cmd/cmd_rweg2gexf.hpp"
+#include "cmd/cmd_rweg2rwegz.hpp"
+#include "cmd/cmd_rwegz2rweg.hpp"
 #include "cmd/cmd_setconfig.hpp"
 
 #include <fstream>      // needed for "fstream"
@@ -35,9 +40,9 @@ AppSettings init(void)
 {
 	std::fstream        config_file;
 
-	// 1. If default configuration file does not exist, create it
-	config_file.open("Technical files/dc", std::fstream::in | std::fstream::binary);
-	if (!config_file.is_open())
+	// 1. If default configuration file does not exist (or was created by another version), create it
+	config_file.open("Technical files/dc", std::fstream::in | std::fstream::binary | std::fstream::ate);
+	if ((!config_file.is_open()) || (config_file.tellg() != std::streampos(sizeof(AppSettings))))
 	{
 		config_file.close();
 		config_file.open("Technical files/dc", std::fstream::out | std::fstream::binary);
@@ -47,14 +52,19 @@ AppSettings init(void)
 		default_settings.default_epsilon_wander_params.start_vertex         = 0UL;
 		default_settings.default_epsilon_wander_params.time_delta           = 1e-6L;
 		default_settings.default_epsilon_wander_params.use_skip_forward     = true;
+		default_settings.default_epsilon_wander_params.precision            = PRECISION_LONG_DOUBLE;
+		default_settings.emulator_params.vertex_order                       = 0UL;
+		default_settings.emulator_params.graph_reduction                    = GRAPH_REDUCTION_OFF;
+		default_settings.emulator_params.run_planning                       = RUN_PLANNING_THREADS;
+		default_settings.emulator_params.conversion_memory                  = 0UL;
 
 		config_file.write(reinterpret_cast<char const *const>(&default_settings), sizeof(default_settings));
 	}
 	config_file.close();
 
-	// 2. If global configuration file does not exist, create it
-	config_file.open("Technical files/gc", std::fstream::in | std::fstream::binary);
-	if (!config_file.is_open())
+	// 2. If global configuration file does not exist (or was created by another version), create it
+	config_file.open("Technical files/gc", std::fstream::in | std::fstream::binary | std::fstream::ate);
+	if ((!config_file.is_open()) || (config_file.tellg() != std::streampos(sizeof(AppSettings))))
 	{
 		config_file.close();
 		config_file.open("Technical files/gc", std::fstream::out | std::fstream::binary);
@@ -64,6 +74,11 @@ AppSettings init(void)
 		default_settings.default_epsilon_wander_params.start_vertex         = 0UL;
 		default_settings.default_epsilon_wander_params.time_delta           = 1e-6L;
 		default_settings.default_epsilon_wander_params.use_skip_forward     = true;
+		default_settings.default_epsilon_wander_params.precision            = PRECISION_LONG_DOUBLE;
+		default_settings.emulator_params.vertex_order                       = 0UL;
+		default_settings.emulator_params.graph_reduction                    = GRAPH_REDUCTION_OFF;
+		default_settings.emulator_params.run_planning                       = RUN_PLANNING_THREADS;
+		default_settings.emulator_params.conversion_memory                  = 0UL;
 
 		config_file.write(reinterpret_cast<char const *const>(&default_settings), sizeof(default_settings));
 		config_file.close();
@@ -73,6 +88,7 @@ AppSettings init(void)
 
 	// 3. Read information from global configuration
 	AppSettings settings;
+	config_file.seekg(0);
 	config_file.read(reinterpret_cast<char *>(&settings), sizeof(settings));
 
 	return settings;
@@ -110,9 +126,9 @@ void run(void)
 	std::string                 token               = "";
 	std::vector<std::string>    command_tokens;
 
-	std::vector<std::string> const              cmd_names{"getconfig", "gexf2rweg", "run", "rweg2gexf", "setconfig"};
-	void                                      (*cmd_functions[])(AppSettings &, std::vector<std::string> const &) = {cmd_getconfig, cmd_gexf2rweg, cmd_run, cmd_rweg2gexf, cmd_setconfig};
-	std::string const                           cmd_help[] = {"cmdgc", "cmdgtr", "cmdr", "cmdrtg", "cmdsc"};
+	std::vector<std::string> const              cmd_names{"edgelist2rweg", "getconfig", "gexf2rweg", "metis2rweg", "mtx2rweg", "run", "rweg2gexf", "rweg2rwegz", "rwegz2rweg", "setconfig"};
+	void                                      (*cmd_functions[])(AppSettings &, std::vector<std::string> const &) = {cmd_edgelist2rweg, cmd_getconfig, cmd_gexf2rweg, cmd_metis2rweg, cmd_mtx2rweg, cmd_run, cmd_rweg2gexf, cmd_rweg2rwegz, cmd_rwegz2rweg, cmd_setconfig};
+	std::string const                           cmd_help[] = {"cmdetr", "cmdgc", "cmdgtr", "cmdmetr", "cmdmtr", "cmdr", "cmdrtg", "cmdrtrz", "cmdrztr", "cmdsc"};
 	auto                                        cmd_position = cmd_names.end();
 
 	std::fstream technical;
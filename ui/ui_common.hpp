@@ -30,6 +30,42 @@ enum LexStates
 
 
 
+// TRANSITION UNIT ENUM
+enum Precisions
+{
+	PRECISION_LONG_DOUBLE,
+	PRECISION_DOUBLE,
+	PRECISION_FLOAT
+};
+
+
+
+
+
+// TRANSITION UNIT ENUM
+enum GraphReductions
+{
+	GRAPH_REDUCTION_OFF,
+	GRAPH_REDUCTION_ON,
+	GRAPH_REDUCTION_VALIDATE
+};
+
+
+
+
+
+// TRANSITION UNIT ENUM
+enum RunPlannings
+{
+	RUN_PLANNING_OFF,
+	RUN_PLANNING_THREADS,
+	RUN_PLANNING_FULL
+};
+
+
+
+
+
 // TRANSITION UNIT STRUCT
 struct EpsilonWanderParams
 {
@@ -37,6 +73,20 @@ struct EpsilonWanderParams
 	long double     epsilon;
 	long double     time_delta;
 	bool            use_skip_forward;
+	uint32_t        precision;              // one of Precisions
+};
+
+
+
+
+
+// TRANSITION UNIT STRUCT
+struct EmulatorParams
+{
+	uint32_t        vertex_order;           // 0 - by IDs, 1 - breadth-first from the start vertex, 2 - reverse Cuthill-McKee
+	uint32_t        graph_reduction;        // one of GraphReductions
+	uint32_t        run_planning;           // one of RunPlannings
+	uint32_t        conversion_memory;      // memory budget of file conversions in MiB, 0 - convert in memory
 };
 
 
@@ -47,6 +97,7 @@ struct EpsilonWanderParams
 struct AppSettings
 {
 	EpsilonWanderParams default_epsilon_wander_params;
+	EmulatorParams      emulator_params;
 };
 
 